@@ -6,9 +6,11 @@
 // #include "EmitterParticle.h"
 #include "EmitterVolume.h"
 #include "Environment.h"
+#include "JobScheduler.h"
 #include "Particle.h"
 #include "ParticleSystem.h"
 #include "PointParticle.h"
+#include "SamplePool.h"
 #include "SphereParticle.h"
 #include "StreakParticle.h"
 #include "TexturedParticle.h"
@@ -17,17 +19,72 @@
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
 #include <memory>
-#include <random>
+#include <vector>
+
+namespace
+{
+// Initial positions of a range of an emitter's particles, sampled from an emitter volume in a single call
+class PositionSamples
+{
+public:
+    PositionSamples(Confetti::EmitterVolume const & volume,
+                    size_t                          begin,
+                    size_t                          end,
+                    size_t                          total,
+                    Confetti::RngStream const &     rng)
+        : storage_(3 * (end - begin))
+        , positions_{ { storage_.data(), end - begin },
+                      { storage_.data() + (end - begin), end - begin },
+                      { storage_.data() + 2 * (end - begin), end - begin } }
+    {
+        volume.sample(positions_, rng, begin, total);
+    }
+
+    glm::vec3 operator [](size_t i) const { return positions_[i]; }
+
+private:
+    std::vector<float>        storage_;
+    Confetti::Vec3Span<float> positions_;
+};
+
+// Calls generate(begin, end, positions) for each chunk of the n particles of an emitter, in parallel. The positions of
+// each chunk are sampled as a part of the emitter's list from the same stream, so they don't depend on how the chunks
+// are run, and a pooled volume gives the whole emitter one block of its points.
+template <typename Generate>
+void generateParticles(Confetti::JobScheduler &        scheduler,
+                       uint64_t                        seed,
+                       Confetti::EmitterVolume const & volume,
+                       std::string const &             name,
+                       size_t                          n,
+                       Generate                        generate)
+{
+    size_t const              size = Confetti::Builder::CHUNK_SIZE;
+    Confetti::RngStream const rng(seed, Confetti::RngStream::id("positions:" + name));
+    scheduler.run((n + size - 1) / size, [&] (size_t chunk) {
+                      size_t const          begin = chunk * size;
+                      size_t const          end   = std::min(begin + size, n);
+                      PositionSamples const positions(volume, begin, end, n, rng);
+                      generate(begin, end, positions);
+                  });
+}
+
+} // anonymous namespace
 
 namespace Confetti
 {
-Builder::Builder(std::minstd_rand & rng)
-    : rng_(rng)
+//! @param  seed        Key of all the random number streams
+//! @param  threads     Number of threads used to build the components. If 0, the number of hardware threads is used.
+
+Builder::Builder(uint64_t seed /*= 0*/, unsigned threads /*= 0*/)
+    : seed_(seed)
+    , scheduler_(std::make_unique<JobScheduler>(threads))
 {
-    // Nothing to do
 }
 
+Builder::~Builder() = default;
+
 std::shared_ptr<ParticleSystem> Builder::buildParticleSystem(Configuration const &        configuration,
     std::shared_ptr<Vkx::Device> device,
     vk::CommandPool const &      commandPool,
@@ -48,11 +105,26 @@ std::shared_ptr<ParticleSystem> Builder::buildParticleSystem(Configuration const
         buildClipperList(p.second);
     }
 
-    // Build the emitter volumes used by the emitters
+    // Build the emitter volumes used by the emitters. They are independent, and precomputing their samples can take a
+    // while, so they are built concurrently.
 
+    std::vector<Configuration::EmitterVolume const *> volumeConfigurations;
+    volumeConfigurations.reserve(configuration.emitterVolumes_.size());
     for (auto const & v : configuration.emitterVolumes_)
     {
-        buildEmitterVolume(v.second);
+        volumeConfigurations.push_back(findEmitterVolume(v.first) ? nullptr : &v.second);
+    }
+
+    std::vector<std::shared_ptr<EmitterVolume>> volumes(volumeConfigurations.size());
+    scheduler_->run(volumes.size(), [this, &volumeConfigurations, &volumes] (size_t i) {
+                        if (volumeConfigurations[i])
+                            volumes[i] = makeEmitterVolume(*volumeConfigurations[i]);
+                    });
+
+    for (size_t i = 0; i < volumes.size(); ++i)
+    {
+        if (volumes[i])
+            emitterVolumes_.emplace(volumeConfigurations[i]->name_, volumes[i]);
     }
 
     std::shared_ptr<ParticleSystem> system = std::make_shared<ParticleSystem>(device, commandPool, queue);
@@ -75,13 +147,42 @@ std::shared_ptr<ParticleSystem> Builder::buildParticleSystem(Configuration const
             system->add(appearance);
     }
 
-    // Build the emitters
+    // Build the emitters. The small emitters are built concurrently. The particles of a large emitter are generated in
+    // parallel chunks, so the large emitters are built one at a time.
 
+    std::vector<Configuration::Emitter const *> emitterConfigurations;
+    emitterConfigurations.reserve(configuration.emitters_.size());
     for (auto const & e : configuration.emitters_)
     {
-        std::shared_ptr<BasicEmitter> emitter = buildEmitter(e.second, device);
-        if (emitter)
-            system->add(emitter);
+        emitterConfigurations.push_back(findEmitter(e.first) ? nullptr : &e.second);
+    }
+
+    std::vector<std::shared_ptr<BasicEmitter>> emitters(emitterConfigurations.size());
+    std::vector<size_t>                        small;
+    for (size_t i = 0; i < emitterConfigurations.size(); ++i)
+    {
+        if (emitterConfigurations[i])
+        {
+            if (emitterConfigurations[i]->particles_.empty() && (size_t)emitterConfigurations[i]->count_ > CHUNK_SIZE)
+                emitters[i] = makeEmitter(*emitterConfigurations[i], device);
+            else
+                small.push_back(i);
+        }
+    }
+
+    scheduler_->run(small.size(), [this, &emitterConfigurations, &emitters, &small, &device] (size_t j) {
+                        emitters[small[j]] = makeEmitter(*emitterConfigurations[small[j]], device);
+                    });
+
+    // Register the emitters in the order of the configuration
+
+    for (size_t i = 0; i < emitters.size(); ++i)
+    {
+        if (emitters[i])
+        {
+            emitters_.emplace(emitterConfigurations[i]->name_, emitters[i]);
+            system->add(emitters[i]);
+        }
     }
 
     return system;
@@ -95,6 +196,20 @@ std::shared_ptr<BasicEmitter> Builder::buildEmitter(Configuration::Emitter const
     if (findEmitter(configuration.name_))
         return std::shared_ptr<BasicEmitter>();
 
+    std::shared_ptr<BasicEmitter> emitter = makeEmitter(configuration, device);
+
+    // Manage the emitter
+
+    if (emitter)
+        emitters_.emplace(configuration.name_, emitter);
+
+    return emitter;
+}
+
+// Builds an emitter without registering it. Emitters can be made concurrently.
+std::shared_ptr<BasicEmitter> Builder::makeEmitter(Configuration::Emitter const & configuration,
+                                                   std::shared_ptr<Vkx::Device>   device)
+{
     // class Configuration::Emitter
     // {
     // public:
@@ -112,6 +227,8 @@ std::shared_ptr<BasicEmitter> Builder::buildEmitter(Configuration::Emitter const
     //	float			minSpeed_;
     //	float			maxSpeed_;
     //	int				count_;
+    //	bool			looping_;
+    //	float			rate_;
     //	float			lifetime_;
     //	float			spread_;
     //	DWORD			color_;
@@ -238,10 +355,10 @@ std::shared_ptr<BasicEmitter> Builder::buildEmitter(Configuration::Emitter const
 //                                                    configuration.sorted_ );
 //    }
 
-    // Manage the emitter
+    // If the particles don't loop, then they are a pool from which particles are emitted
 
-    if (emitter)
-        emitters_.emplace(configuration.name_, emitter);
+    if (emitter && !configuration.looping_)
+        emitter->setEmissionRate(configuration.rate_);
 
     return emitter;
 }
@@ -329,6 +446,9 @@ std::shared_ptr<Environment> Builder::buildEnvironment(Configuration::Environmen
     //		glm::vec4	windVelocity_;
     //		float       gustiness_;
     //		float		airFriction_;
+    //		float		turbulenceFrequency_;
+    //		float		turbulenceAmplitude_;
+    //		glm::vec3	turbulenceScroll_;
     //		std::string	surface_;
     //		std::string	clip_;
     //	};
@@ -342,6 +462,10 @@ std::shared_ptr<Environment> Builder::buildEnvironment(Configuration::Environmen
                                                      configuration.gustiness_,
                                                      *surfaceList,
                                                      *clipperList);
+    environment->setTurbulence(Turbulence(configuration.turbulenceFrequency_,
+                                          configuration.turbulenceAmplitude_,
+                                          configuration.turbulenceScroll_));
+    environment->setRng(RngStream(seed_, RngStream::id("environment:" + configuration.name_)));
     environments_.emplace(configuration.name_, environment);
     return environment;
 }
@@ -406,6 +530,16 @@ std::shared_ptr<EmitterVolume> Builder::buildEmitterVolume(Configuration::Emitte
     if (findEmitterVolume(configuration.name_))
         return nullptr;
 
+    std::shared_ptr<EmitterVolume> volume = makeEmitterVolume(configuration);
+    if (volume)
+        emitterVolumes_.emplace(configuration.name_, volume);
+
+    return volume;
+}
+
+// Builds an emitter volume without registering it. Volumes can be made concurrently.
+std::shared_ptr<EmitterVolume> Builder::makeEmitterVolume(Configuration::EmitterVolume const & configuration) const
+{
     //	class Configuration::EmitterVolume
     //	{
     //	public:
@@ -417,6 +551,7 @@ std::shared_ptr<EmitterVolume> Builder::buildEmitterVolume(Configuration::Emitte
     //		float		height_;
     //		float		depth_;
     //		float		radius_;
+    //		int			samples_;
     //	};
 
     std::shared_ptr<EmitterVolume> pVolume;
@@ -457,8 +592,10 @@ std::shared_ptr<EmitterVolume> Builder::buildEmitterVolume(Configuration::Emitte
         pVolume = std::make_shared<Confetti::EmitterCone>(configuration.radius_, configuration.height_);
     }
 
-    if (pVolume)
-        emitterVolumes_.emplace(configuration.name_, pVolume);
+    // Emitters that share the volume share its pool of points
+
+    if (pVolume && configuration.samples_ > 0)
+        pVolume = std::make_shared<Confetti::SamplePool>(pVolume, (size_t)configuration.samples_);
 
     return pVolume;
 }
@@ -469,30 +606,31 @@ std::vector<PointParticle> Builder::buildPointParticles(int
                                                         Environment const &            environment,
                                                         Appearance const &             appearance)
 {
-    std::vector<PointParticle> particles;
-    particles.reserve(n);
+    std::vector<PointParticle> particles(n);
 
     // Generate the particles' characteristics from the emitter configuration.
 
-    Vkx::RandomDirection randomDirection(emitterConfiguration.spread_);
-    std::uniform_real_distribution<float> randomSpeed(emitterConfiguration.minSpeed_, emitterConfiguration.maxSpeed_);
-    std::uniform_real_distribution<float> randomAge(0.0f, emitterConfiguration.lifetime_);
-
-    for (int i = 0; i < n; i++)
-    {
-        glm::vec3 direction = randomDirection(rng_);
-        float     speed     = randomSpeed(rng_);
-        float     age       = randomAge(rng_);
-        // Note: RandomDirection returns a direction near the X axis, but the emitter points down the Z axis.
-        // The direction returned by RandomDirection must be rotated -90 degrees around the Y axis.
-        glm::vec3 const velocity = glm::vec3(-direction.z * speed, direction.y * speed, direction.x * speed);
-
-        particles.emplace_back(emitterConfiguration.lifetime_,
-                               age,
-                               randomPosition(rng_),
-                               velocity,
-                               emitterConfiguration.color_);
-    }
+    uint32_t const stream   = RngStream::id("emitter:" + emitterConfiguration.name_);
+    auto           generate = [&] (size_t begin, size_t end, PositionSamples const & positions) {
+        Vkx::RandomDirection randomDirection(emitterConfiguration.spread_);
+        for (size_t i = begin; i < end; ++i)
+        {
+            RngStream rng(seed_, stream, (uint32_t)i);
+            glm::vec3 direction = randomDirection(rng);
+            float     speed     = rng.uniform(emitterConfiguration.minSpeed_, emitterConfiguration.maxSpeed_);
+            float     age       = rng.uniform(0.0f, emitterConfiguration.lifetime_);
+            // Note: RandomDirection returns a direction near the X axis, but the emitter points down the Z axis.
+            // The direction returned by RandomDirection must be rotated -90 degrees around the Y axis.
+            glm::vec3 const velocity = glm::vec3(-direction.z * speed, direction.y * speed, direction.x * speed);
+
+            particles[i] = PointParticle(emitterConfiguration.lifetime_,
+                                         age,
+                                         positions[i - begin],
+                                         velocity,
+                                         emitterConfiguration.color_);
+        }
+    };
+    generateParticles(*scheduler_, seed_, randomPosition, emitterConfiguration.name_, particles.size(), generate);
 
     return particles;
 }
@@ -516,28 +654,29 @@ std::vector<StreakParticle> Builder::buildStreakParticles(int
                                                           Environment const &            environment,
                                                           Appearance const &             appearance)
 {
-    std::vector<StreakParticle> particles;
-    particles.reserve(n);
+    std::vector<StreakParticle> particles(n);
 
     // Generate the particles' characteristics from the emitter configuration.
 
-    Vkx::RandomDirection randomDirection(emitterConfiguration.spread_);
-    std::uniform_real_distribution<float> randomSpeed(emitterConfiguration.minSpeed_, emitterConfiguration.maxSpeed_);
-    std::uniform_real_distribution<float> randomAge(0.0f, emitterConfiguration.lifetime_);
-
-    for (int i = 0; i < n; i++)
-    {
-        glm::vec3 direction = randomDirection(rng_);
-        float     speed     = randomSpeed(rng_);
-        float     age       = randomAge(rng_);
-        glm::vec3 velocity  = glm::vec3(-direction.z * speed, direction.y * speed, direction.x * speed);
-
-        particles.emplace_back(emitterConfiguration.lifetime_,
-                               age,
-                               randomPosition(rng_),
-                               velocity,
-                               emitterConfiguration.color_);
-    }
+    uint32_t const stream   = RngStream::id("emitter:" + emitterConfiguration.name_);
+    auto           generate = [&] (size_t begin, size_t end, PositionSamples const & positions) {
+        Vkx::RandomDirection randomDirection(emitterConfiguration.spread_);
+        for (size_t i = begin; i < end; ++i)
+        {
+            RngStream rng(seed_, stream, (uint32_t)i);
+            glm::vec3 direction = randomDirection(rng);
+            float     speed     = rng.uniform(emitterConfiguration.minSpeed_, emitterConfiguration.maxSpeed_);
+            float     age       = rng.uniform(0.0f, emitterConfiguration.lifetime_);
+            glm::vec3 velocity  = glm::vec3(-direction.z * speed, direction.y * speed, direction.x * speed);
+
+            particles[i] = StreakParticle(emitterConfiguration.lifetime_,
+                                          age,
+                                          positions[i - begin],
+                                          velocity,
+                                          emitterConfiguration.color_);
+        }
+    };
+    generateParticles(*scheduler_, seed_, randomPosition, emitterConfiguration.name_, particles.size(), generate);
 
     return particles;
 }
@@ -561,32 +700,32 @@ std::vector<TexturedParticle> Builder::buildTexturedParticles(int
                                                               Environment const &            environment,
                                                               Appearance const &             appearance)
 {
-    std::vector<TexturedParticle> particles;
-    particles.reserve(n);
+    std::vector<TexturedParticle> particles(n);
 
     // Generate the particles' characteristics from the emitter configuration.
 
-    Vkx::RandomDirection randomDirection(emitterConfiguration.spread_);
-    std::uniform_real_distribution<float> randomSpeed(emitterConfiguration.minSpeed_, emitterConfiguration.maxSpeed_);
-    std::uniform_real_distribution<float> randomAge(0.0f, emitterConfiguration.lifetime_);
-    std::uniform_real_distribution<float> randomRotation(0.0f, glm::two_pi<float>());
-
-    for (int i = 0; i < n; i++)
-    {
-        glm::vec3 direction = randomDirection(rng_);
-        float     speed     = randomSpeed(rng_);
-        float     age       = randomAge(rng_);
-        glm::vec3 velocity  = glm::vec3(-direction.z * speed, direction.y * speed, direction.x * speed);
-        float     rotation  = randomRotation(rng_);
-
-        particles.emplace_back(emitterConfiguration.lifetime_,
-                               age,
-                               randomPosition(rng_),
-                               velocity,
-                               emitterConfiguration.color_,
-                               emitterConfiguration.radius_,
-                               rotation);
-    }
+    uint32_t const stream   = RngStream::id("emitter:" + emitterConfiguration.name_);
+    auto           generate = [&] (size_t begin, size_t end, PositionSamples const & positions) {
+        Vkx::RandomDirection randomDirection(emitterConfiguration.spread_);
+        for (size_t i = begin; i < end; ++i)
+        {
+            RngStream rng(seed_, stream, (uint32_t)i);
+            glm::vec3 direction = randomDirection(rng);
+            float     speed     = rng.uniform(emitterConfiguration.minSpeed_, emitterConfiguration.maxSpeed_);
+            float     age       = rng.uniform(0.0f, emitterConfiguration.lifetime_);
+            glm::vec3 velocity  = glm::vec3(-direction.z * speed, direction.y * speed, direction.x * speed);
+            float     rotation  = rng.uniform(0.0f, glm::two_pi<float>());
+
+            particles[i] = TexturedParticle(emitterConfiguration.lifetime_,
+                                            age,
+                                            positions[i - begin],
+                                            velocity,
+                                            emitterConfiguration.color_,
+                                            emitterConfiguration.radius_,
+                                            rotation);
+        }
+    };
+    generateParticles(*scheduler_, seed_, randomPosition, emitterConfiguration.name_, particles.size(), generate);
 
     return particles;
 }
@@ -610,29 +749,30 @@ std::vector<SphereParticle> Builder::buildSphereParticles(int
                                                           Environment const &            environment,
                                                           Appearance const &             appearance)
 {
-    std::vector<SphereParticle> particles;
-    particles.reserve(n);
+    std::vector<SphereParticle> particles(n);
 
     // Generate the particles' characteristics from the emitter configuration.
 
-    Vkx::RandomDirection randomDirection(emitterConfiguration.spread_);
-    std::uniform_real_distribution<float> randomSpeed(emitterConfiguration.minSpeed_, emitterConfiguration.maxSpeed_);
-    std::uniform_real_distribution<float> randomAge(0.0f, emitterConfiguration.lifetime_);
-
-    for (int i = 0; i < n; i++)
-    {
-        glm::vec3 direction = randomDirection(rng_);
-        float     speed     = randomSpeed(rng_);
-        float     age       = randomAge(rng_);
-        glm::vec3 velocity  = glm::vec3(-direction.z * speed, direction.y * speed, direction.x * speed);
-
-        particles.emplace_back(emitterConfiguration.lifetime_,
-                               age,
-                               randomPosition(rng_),
-                               velocity,
-                               emitterConfiguration.color_,
-                               emitterConfiguration.radius_);
-    }
+    uint32_t const stream   = RngStream::id("emitter:" + emitterConfiguration.name_);
+    auto           generate = [&] (size_t begin, size_t end, PositionSamples const & positions) {
+        Vkx::RandomDirection randomDirection(emitterConfiguration.spread_);
+        for (size_t i = begin; i < end; ++i)
+        {
+            RngStream rng(seed_, stream, (uint32_t)i);
+            glm::vec3 direction = randomDirection(rng);
+            float     speed     = rng.uniform(emitterConfiguration.minSpeed_, emitterConfiguration.maxSpeed_);
+            float     age       = rng.uniform(0.0f, emitterConfiguration.lifetime_);
+            glm::vec3 velocity  = glm::vec3(-direction.z * speed, direction.y * speed, direction.x * speed);
+
+            particles[i] = SphereParticle(emitterConfiguration.lifetime_,
+                                          age,
+                                          positions[i - begin],
+                                          velocity,
+                                          emitterConfiguration.color_,
+                                          emitterConfiguration.radius_);
+        }
+    };
+    generateParticles(*scheduler_, seed_, randomPosition, emitterConfiguration.name_, particles.size(), generate);
 
     return particles;
 }
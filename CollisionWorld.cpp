@@ -0,0 +1,296 @@
+#include "CollisionWorld.h"
+
+#include "ParticleEventRing.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Confetti
+{
+namespace
+{
+// If a chunk's swept box overlaps more quads than this, each particle queries the hierarchy on its own
+size_t constexpr MAX_SHARED_CANDIDATES = 64;
+
+bool overlaps(BoundingBox const & a, BoundingBox const & b)
+{
+    return a.min.x <= b.max.x && a.min.y <= b.max.y && a.min.z <= b.max.z &&
+           b.min.x <= a.max.x && b.min.y <= a.max.y && b.min.z <= a.max.z;
+}
+} // anonymous namespace
+
+//! @param  quads   The quads. Degenerate quads (with no area) are ignored.
+
+CollisionWorld::CollisionWorld(QuadList const & quads)
+{
+    std::vector<Primitive>   primitives;
+    std::vector<BoundingBox> boxes;
+    primitives.reserve(quads.size());
+    boxes.reserve(quads.size());
+
+    for (Quad const & quad : quads)
+    {
+        glm::vec3 n  = glm::cross(quad.u, quad.v);
+        float     n2 = glm::dot(n, n);
+        if (n2 <= 0.0f)
+            continue;
+
+        // The coordinates (s, t) of a point p = corner + s * u + t * v on the plane are found by dotting p - corner
+        // with the dual vectors (v x n) / |n|^2 and (n x u) / |n|^2.
+
+        Primitive p;
+        p.normal    = n / std::sqrt(n2);
+        p.offset    = glm::dot(p.normal, quad.corner);
+        p.corner    = quad.corner;
+        p.du        = glm::cross(quad.v, n) / n2;
+        p.dv        = glm::cross(n, quad.u) / n2;
+        p.dampening = quad.dampening;
+        primitives.push_back(p);
+
+        BoundingBox box;
+        box.add(quad.corner);
+        box.add(quad.corner + quad.u);
+        box.add(quad.corner + quad.v);
+        box.add(quad.corner + quad.u + quad.v);
+        boxes.push_back(box);
+    }
+
+    if (primitives.empty())
+        return;
+
+    std::vector<uint32_t> order(primitives.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = (uint32_t)i;
+    }
+
+    nodes_.reserve(2 * primitives.size() / LEAF_SIZE + 1);
+    build(order, 0, order.size(), boxes);
+
+    // Store the primitives in the order of the leaves so that each leaf's primitives are contiguous
+    quads_.reserve(primitives.size());
+    boxes_.reserve(primitives.size());
+    for (uint32_t i : order)
+    {
+        quads_.push_back(primitives[i]);
+        boxes_.push_back(boxes[i]);
+    }
+}
+
+//! @return     the bounding box of all the quads (empty if there are none)
+
+BoundingBox CollisionWorld::bounds() const
+{
+    return nodes_.empty() ? BoundingBox() : nodes_[0].box;
+}
+
+//! @param  box     The box to test
+//! @param  quads   The indexes of the quads whose bounds overlap the box are appended to this list
+
+void CollisionWorld::query(BoundingBox const & box, std::vector<uint32_t> & quads) const
+{
+    if (nodes_.empty() || box.empty())
+        return;
+
+    uint32_t stack[64];
+    size_t   top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        Node const & node = nodes_[stack[--top]];
+        if (!overlaps(node.box, box))
+            continue;
+
+        if (node.count > 0)
+        {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i)
+            {
+                if (overlaps(boxes_[i], box))
+                    quads.push_back(i);
+            }
+        }
+        else
+        {
+            assert(top + 2 <= sizeof(stack) / sizeof(stack[0]));
+            stack[top++] = node.second;
+            stack[top++] = node.first;
+        }
+    }
+}
+
+//! @param  from        Position before the update
+//! @param  to          Position after the update. Updated if the particle bounces.
+//! @param  velocity    Velocity after the update. Updated if the particle bounces.
+//!
+//! @return     true if the particle bounced
+
+bool CollisionWorld::collide(glm::vec3 const & from, glm::vec3 & to, glm::vec3 & velocity) const
+{
+    BoundingBox path;
+    path.add(from);
+    path.add(to);
+
+    // The list is reused by each thread, so a query doesn't allocate
+    static thread_local std::vector<uint32_t> candidates;
+    candidates.clear();
+    query(path, candidates);
+    return bounce(from, to, velocity, candidates.data(), candidates.size());
+}
+
+//! @param  from        Positions before the update
+//! @param  to          Positions after the update. Updated if the particles bounce.
+//! @param  velocities  Velocities after the update. Updated if the particles bounce.
+//! @param  ages        Ages after the update
+//! @param  dt          Duration of the update
+//! @param  events      If not empty, ParticleEvent::BOUNCE is added to the events of the particles that bounce
+//!
+//! All the particles share a single query of the hierarchy with the box swept by their paths, unless it finds too
+//! many candidates, in which case each particle queries the hierarchy with its own path. Particles that were born or
+//! reborn during the update, and so didn't move from their previous positions, are ignored.
+
+void CollisionWorld::collide(Vec3Span<float const> const & from,
+                             Vec3Span<float> const &       to,
+                             Vec3Span<float> const &       velocities,
+                             Span<float const> const &     ages,
+                             float                         dt,
+                             Span<uint8_t> const &         events /*= Span<uint8_t>()*/) const
+{
+    size_t const n = ages.size();
+    assert(from.x.size() == n && to.x.size() == n && velocities.x.size() == n);
+
+    if (nodes_.empty())
+        return;
+
+    BoundingBox swept;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (ages[i] >= dt)
+        {
+            swept.add(from[i]);
+            swept.add(to[i]);
+        }
+    }
+
+    // The list is reused by each thread. It is separate from the list of the single particle version, which is called
+    // while it is in use.
+    static thread_local std::vector<uint32_t> candidates;
+    candidates.clear();
+    query(swept, candidates);
+    if (candidates.empty())
+        return;
+
+    bool const shared = candidates.size() <= MAX_SHARED_CANDIDATES;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (ages[i] < dt)
+            continue;
+
+        glm::vec3 p0 = from[i];
+        glm::vec3 p1 = to[i];
+        glm::vec3 v  = velocities[i];
+        bool bounced = shared ? bounce(p0, p1, v, candidates.data(), candidates.size()) : collide(p0, p1, v);
+        if (bounced)
+        {
+            to.set(i, p1);
+            velocities.set(i, v);
+            if (!events.empty())
+                events[i] |= ParticleEvent::BOUNCE;
+        }
+    }
+}
+
+// Builds the subtree for the primitives order[begin, end) and returns the index of its root
+uint32_t CollisionWorld::build(std::vector<uint32_t> & order,
+                               size_t begin,
+                               size_t end,
+                               std::vector<BoundingBox> const & boxes)
+{
+    uint32_t const index = (uint32_t)nodes_.size();
+    nodes_.push_back(Node());
+
+    BoundingBox box;
+    BoundingBox centroids;
+    for (size_t i = begin; i < end; ++i)
+    {
+        BoundingBox const & b = boxes[order[i]];
+        box.add(b);
+        centroids.add((b.min + b.max) * 0.5f);
+    }
+    nodes_[index].box = box;
+
+    if (end - begin <= LEAF_SIZE)
+    {
+        nodes_[index].first = (uint32_t)begin;
+        nodes_[index].count = (uint32_t)(end - begin);
+        return index;
+    }
+
+    // Split at the median along the longest axis of the centroids
+
+    glm::vec3 extent = centroids.max - centroids.min;
+    int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+    size_t const middle = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+                     [&boxes, axis] (uint32_t a, uint32_t b) {
+                         return boxes[a].min[axis] + boxes[a].max[axis] < boxes[b].min[axis] + boxes[b].max[axis];
+                     });
+
+    uint32_t first  = build(order, begin, middle, boxes);
+    uint32_t second = build(order, middle, end, boxes);
+    nodes_[index].first  = first;
+    nodes_[index].second = second;
+    nodes_[index].count  = 0;
+    return index;
+}
+
+// Finds the first of the candidate quads that the path from -> to passes through from front to back
+bool CollisionWorld::nearestHit(glm::vec3 const & from,
+                                glm::vec3 const & to,
+                                uint32_t const *  candidates,
+                                size_t            count,
+                                uint32_t &        hit) const
+{
+    float nearest = 2.0f;
+    for (size_t k = 0; k < count; ++k)
+    {
+        Primitive const & q = quads_[candidates[k]];
+        float da = glm::dot(q.normal, from) - q.offset;
+        float db = glm::dot(q.normal, to) - q.offset;
+        if (da < 0.0f || db >= 0.0f)
+            continue;
+
+        float t = da / (da - db);
+        if (t >= nearest)
+            continue;
+
+        glm::vec3 w = from + (to - from) * t - q.corner;
+        float s = glm::dot(w, q.du);
+        float r = glm::dot(w, q.dv);
+        if (s >= 0.0f && s <= 1.0f && r >= 0.0f && r <= 1.0f)
+        {
+            nearest = t;
+            hit     = candidates[k];
+        }
+    }
+    return nearest <= 1.0f;
+}
+
+// Reflects the position and velocity off of the first quad the path passes through, just like a surface
+bool CollisionWorld::bounce(glm::vec3 const & from,
+                            glm::vec3 &       to,
+                            glm::vec3 &       velocity,
+                            uint32_t const *  candidates,
+                            size_t            count) const
+{
+    uint32_t hit;
+    if (!nearestHit(from, to, candidates, count, hit))
+        return false;
+
+    Primitive const & q = quads_[hit];
+    float f = 1.0f + q.dampening;
+    velocity -= q.normal * (f * glm::dot(q.normal, velocity));
+    to       -= q.normal * (f * (glm::dot(q.normal, to) - q.offset));
+    return true;
+}
+} // namespace Confetti
@@ -0,0 +1,200 @@
+#include "DepthSorter.h"
+
+#include <glm/geometric.hpp>
+
+#include <cassert>
+#include <cstring>
+
+namespace
+{
+// The keys are sorted 11 bits at a time, in 3 passes
+int constexpr RADIX_BITS  = 11;
+int constexpr RADIX_SIZE  = 1 << RADIX_BITS;
+int constexpr RADIX_MASK  = RADIX_SIZE - 1;
+int constexpr RADIX_PASSES = (32 + RADIX_BITS - 1) / RADIX_BITS;
+} // anonymous namespace
+
+namespace Confetti
+{
+//! @param  positions   Positions of the particles
+//! @param  viewpoint   The position of the camera
+//! @param  order       The indexes of the particles, farthest first (input and output)
+
+void DepthSorter::sort(Vec3Span<float const> const & positions, glm::vec3 const & viewpoint, std::vector<uint32_t> & order)
+{
+    size_t const n = positions.size();
+    bool const   haveOrder = incremental_ && order.size() == n;
+
+    inversions_ = 0;
+
+    // If nothing has moved enough to matter, then keep the previous order
+
+    if (haveOrder && threshold_ > 0.0f && lastX_.size() == n && !moved(positions, viewpoint))
+    {
+        lastResult_ = Result::SKIPPED;
+        return;
+    }
+
+    keys_.resize(n);
+    Span<float const> x = positions.x;
+    Span<float const> y = positions.y;
+    Span<float const> z = positions.z;
+    auto key = [&x, &y, &z, &viewpoint] (size_t i) {
+                   float dx = x[i] - viewpoint.x;
+                   float dy = y[i] - viewpoint.y;
+                   float dz = z[i] - viewpoint.z;
+                   return descendingKey(dx * dx + dy * dy + dz * dz);
+               };
+
+    // Try to repair the previous order. If it has changed too much, sort from scratch.
+
+    bool repaired = false;
+    if (haveOrder)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            keys_[i] = key(order[i]);
+        }
+        repaired = repair(order);
+    }
+
+    if (!repaired)
+    {
+        order.resize(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            keys_[i] = key(i);
+            order[i] = (uint32_t)i;
+        }
+        sort(keys_, order);
+    }
+
+    lastResult_ = repaired ? Result::REPAIRED : Result::SORTED;
+
+    if (incremental_ && threshold_ > 0.0f)
+        remember(positions, viewpoint);
+}
+
+//! @param  keys    Keys to sort by. The contents are undefined on return.
+//! @param  order   Indexes to sort. On return, they are ordered so that their keys are ascending.
+//!
+//! This is an LSD radix sort. A pass is skipped if all the keys have the same digit.
+
+void DepthSorter::sort(std::vector<uint32_t> & keys, std::vector<uint32_t> & order)
+{
+    assert(keys.size() == order.size());
+    size_t const n = keys.size();
+    if (n < 2)
+        return;
+
+    scratchKeys_.resize(n);
+    scratchOrder_.resize(n);
+
+    for (int pass = 0; pass < RADIX_PASSES; ++pass)
+    {
+        int const shift = pass * RADIX_BITS;
+
+        size_t counts[RADIX_SIZE];
+        memset(counts, 0, sizeof(counts));
+        for (size_t i = 0; i < n; ++i)
+        {
+            ++counts[(keys[i] >> shift) & RADIX_MASK];
+        }
+
+        if (counts[(keys[0] >> shift) & RADIX_MASK] == n)
+            continue;
+
+        size_t offset = 0;
+        for (int d = 0; d < RADIX_SIZE; ++d)
+        {
+            size_t count = counts[d];
+            counts[d] = offset;
+            offset   += count;
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            size_t j = counts[(keys[i] >> shift) & RADIX_MASK]++;
+            scratchKeys_[j]  = keys[i];
+            scratchOrder_[j] = order[i];
+        }
+
+        keys.swap(scratchKeys_);
+        order.swap(scratchOrder_);
+    }
+}
+
+//! @param  value   Value to convert. It must not be NaN.
+//!
+//! Larger values produce smaller keys, so sorting the keys in ascending order sorts the values in descending order.
+
+uint32_t DepthSorter::descendingKey(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    // Map the float to an unsigned integer that sorts in the same order, then invert it
+    uint32_t key = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    return ~key;
+}
+
+// Returns true if the viewpoint or any particle has moved farther than the threshold since the last sort
+bool DepthSorter::moved(Vec3Span<float const> const & positions, glm::vec3 const & viewpoint) const
+{
+    float const threshold2 = threshold_ * threshold_;
+
+    glm::vec3 dv = viewpoint - lastViewpoint_;
+    if (glm::dot(dv, dv) >= threshold2)
+        return true;
+
+    Span<float const> x = positions.x;
+    Span<float const> y = positions.y;
+    Span<float const> z = positions.z;
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        float dx = x[i] - lastX_[i];
+        float dy = y[i] - lastY_[i];
+        float dz = z[i] - lastZ_[i];
+        if (dx * dx + dy * dy + dz * dz >= threshold2)
+            return true;
+    }
+    return false;
+}
+
+// Repairs the order with an insertion sort of keys_ and order, counting the inversions. If the number of inversions
+// grows so large that a full sort would be faster, the repair is abandoned and false is returned.
+bool DepthSorter::repair(std::vector<uint32_t> & order)
+{
+    size_t const n     = order.size();
+    size_t const limit = 8 * n;
+
+    for (size_t i = 1; i < n; ++i)
+    {
+        uint32_t key   = keys_[i];
+        uint32_t index = order[i];
+        size_t   j     = i;
+        while (j > 0 && keys_[j - 1] > key)
+        {
+            keys_[j] = keys_[j - 1];
+            order[j] = order[j - 1];
+            --j;
+        }
+        keys_[j] = key;
+        order[j] = index;
+
+        inversions_ += i - j;
+        if (inversions_ > limit)
+            return false;
+    }
+    return true;
+}
+
+// Saves the viewpoint and the positions for the next check for movement
+void DepthSorter::remember(Vec3Span<float const> const & positions, glm::vec3 const & viewpoint)
+{
+    lastViewpoint_ = viewpoint;
+    lastX_.assign(positions.x.begin(), positions.x.end());
+    lastY_.assign(positions.y.begin(), positions.y.end());
+    lastZ_.assign(positions.z.begin(), positions.z.end());
+}
+} // namespace Confetti
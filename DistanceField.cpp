@@ -0,0 +1,340 @@
+#include "DistanceField.h"
+
+#include "ParticleEventRing.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace Confetti
+{
+namespace
+{
+char const     FILE_TAG[4]  = { 'C', 'S', 'D', 'F' };
+uint32_t const FILE_VERSION = 1;
+
+// Source: Ericson, "Real-Time Collision Detection", 5.1.5
+glm::vec3 closestPointOnTriangle(glm::vec3 const & p, glm::vec3 const & a, glm::vec3 const & b, glm::vec3 const & c)
+{
+    glm::vec3 ab = b - a;
+    glm::vec3 ac = c - a;
+    glm::vec3 ap = p - a;
+    float d1 = glm::dot(ab, ap);
+    float d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f)
+        return a;
+
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp);
+    float d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3)
+        return b;
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        return a + ab * (d1 / (d1 - d3));
+
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp);
+    float d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6)
+        return c;
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        return a + ac * (d2 / (d2 - d6));
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    float denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// Returns true if a ray from p in direction d hits the triangle (Moller-Trumbore)
+bool rayHitsTriangle(glm::vec3 const & p, glm::vec3 const & d, glm::vec3 const & a, glm::vec3 const & b, glm::vec3 const & c)
+{
+    glm::vec3 e1  = b - a;
+    glm::vec3 e2  = c - a;
+    glm::vec3 h   = glm::cross(d, e2);
+    float     det = glm::dot(e1, h);
+    if (std::abs(det) < std::numeric_limits<float>::min())
+        return false;
+
+    float     inv = 1.0f / det;
+    glm::vec3 s   = p - a;
+    float     u   = glm::dot(s, h) * inv;
+    if (u < 0.0f || u > 1.0f)
+        return false;
+
+    glm::vec3 q = glm::cross(s, e1);
+    float     v = glm::dot(d, q) * inv;
+    if (v < 0.0f || u + v > 1.0f)
+        return false;
+
+    return glm::dot(e2, q) * inv > 0.0f;
+}
+} // anonymous namespace
+
+//! @param  size        Number of samples along each axis (at least 2)
+//! @param  origin      Position of the first sample
+//! @param  spacing     Distance between adjacent samples
+//! @param  distances   Signed distance at each sample (negative inside), with x varying fastest, then y, then z
+//!
+//! The gradients are computed from the distances with central differences.
+
+DistanceField::DistanceField(glm::ivec3 const &         size,
+                             glm::vec3 const &          origin,
+                             float                      spacing,
+                             std::vector<float> const & distances)
+    : size_(size)
+    , origin_(origin)
+    , spacing_(spacing)
+{
+    assert(size.x >= 2 && size.y >= 2 && size.z >= 2);
+    assert(spacing > 0.0f);
+    assert(distances.size() == (size_t)size.x * size.y * size.z);
+
+    samples_.resize(distances.size());
+    for (int z = 0; z < size_.z; ++z)
+    {
+        int z0 = std::max(z - 1, 0);
+        int z1 = std::min(z + 1, size_.z - 1);
+        for (int y = 0; y < size_.y; ++y)
+        {
+            int y0 = std::max(y - 1, 0);
+            int y1 = std::min(y + 1, size_.y - 1);
+            for (int x = 0; x < size_.x; ++x)
+            {
+                int x0 = std::max(x - 1, 0);
+                int x1 = std::min(x + 1, size_.x - 1);
+
+                glm::vec3 gradient((distances[index(x1, y, z)] - distances[index(x0, y, z)]) / ((x1 - x0) * spacing),
+                                   (distances[index(x, y1, z)] - distances[index(x, y0, z)]) / ((y1 - y0) * spacing),
+                                   (distances[index(x, y, z1)] - distances[index(x, y, z0)]) / ((z1 - z0) * spacing));
+                samples_[index(x, y, z)] = glm::vec4(gradient, distances[index(x, y, z)]);
+            }
+        }
+    }
+}
+
+//! @param  path    Name of the file
+//!
+//! @return     the distance field
+
+DistanceField DistanceField::load(char const * path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error(std::string("Cannot open file '") + path + "'");
+
+    char     tag[4];
+    uint32_t version;
+    int32_t  size[3];
+    float    origin[3];
+    float    spacing;
+    file.read(tag, sizeof(tag));
+    file.read(reinterpret_cast<char *>(&version), sizeof(version));
+    file.read(reinterpret_cast<char *>(size), sizeof(size));
+    file.read(reinterpret_cast<char *>(origin), sizeof(origin));
+    file.read(reinterpret_cast<char *>(&spacing), sizeof(spacing));
+    if (!file || memcmp(tag, FILE_TAG, sizeof(tag)) != 0 || version != FILE_VERSION)
+        throw std::runtime_error(std::string("'") + path + "' is not a distance field");
+    if (size[0] < 2 || size[1] < 2 || size[2] < 2 || !(spacing > 0.0f))
+        throw std::runtime_error(std::string("'") + path + "' has an invalid grid");
+
+    std::vector<float> distances((size_t)size[0] * size[1] * size[2]);
+    file.read(reinterpret_cast<char *>(distances.data()), distances.size() * sizeof(float));
+    if (!file)
+        throw std::runtime_error(std::string("'") + path + "' is truncated");
+
+    return DistanceField({ size[0], size[1], size[2] }, { origin[0], origin[1], origin[2] }, spacing, distances);
+}
+
+//! @param  vertices    Vertices of the mesh
+//! @param  indices     Indexes of the vertices of each triangle
+//! @param  spacing     Distance between adjacent samples
+//! @param  margin      Distance the grid extends past the mesh's bounds
+//!
+//! @return     the distance field
+//!
+//! The mesh must be closed, or the inside and outside can't be told apart. Each sample is tested against every
+//! triangle, so this is meant to be done offline or when loading a level.
+
+DistanceField DistanceField::fromMesh(std::vector<glm::vec3> const & vertices,
+                                      std::vector<uint32_t> const &  indices,
+                                      float                          spacing,
+                                      float                          margin)
+{
+    assert(indices.size() % 3 == 0);
+    assert(spacing > 0.0f);
+
+    BoundingBox box;
+    for (glm::vec3 const & v : vertices)
+    {
+        box.add(v);
+    }
+    box = box.expanded(glm::vec3(margin));
+
+    glm::vec3  extent = box.max - box.min;
+    glm::ivec3 size(std::max(2, (int)std::ceil(extent.x / spacing) + 1),
+                    std::max(2, (int)std::ceil(extent.y / spacing) + 1),
+                    std::max(2, (int)std::ceil(extent.z / spacing) + 1));
+
+    // The sign is found by counting the crossings of a ray. The ray is slightly off-axis so that it is unlikely to pass
+    // exactly through an edge or a vertex of a mesh built on a grid.
+    glm::vec3 const ray = glm::normalize(glm::vec3(1.0f, 0.0123f, 0.0457f));
+
+    std::vector<float> distances((size_t)size.x * size.y * size.z);
+    size_t k = 0;
+    for (int z = 0; z < size.z; ++z)
+    {
+        for (int y = 0; y < size.y; ++y)
+        {
+            for (int x = 0; x < size.x; ++x)
+            {
+                glm::vec3 p = box.min + glm::vec3((float)x, (float)y, (float)z) * spacing;
+                float     nearest   = std::numeric_limits<float>::max();
+                int       crossings = 0;
+                for (size_t t = 0; t < indices.size(); t += 3)
+                {
+                    glm::vec3 const & a = vertices[indices[t + 0]];
+                    glm::vec3 const & b = vertices[indices[t + 1]];
+                    glm::vec3 const & c = vertices[indices[t + 2]];
+                    glm::vec3 d = p - closestPointOnTriangle(p, a, b, c);
+                    nearest = std::min(nearest, glm::dot(d, d));
+                    if (rayHitsTriangle(p, ray, a, b, c))
+                        ++crossings;
+                }
+                nearest = std::sqrt(nearest);
+                distances[k++] = (crossings & 1) ? -nearest : nearest;
+            }
+        }
+    }
+
+    return DistanceField(size, box.min, spacing, distances);
+}
+
+//! @param  path    Name of the file
+
+void DistanceField::save(char const * path) const
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error(std::string("Cannot open file '") + path + "'");
+
+    int32_t size[3]   = { size_.x, size_.y, size_.z };
+    float   origin[3] = { origin_.x, origin_.y, origin_.z };
+    file.write(FILE_TAG, sizeof(FILE_TAG));
+    file.write(reinterpret_cast<char const *>(&FILE_VERSION), sizeof(FILE_VERSION));
+    file.write(reinterpret_cast<char const *>(size), sizeof(size));
+    file.write(reinterpret_cast<char const *>(origin), sizeof(origin));
+    file.write(reinterpret_cast<char const *>(&spacing_), sizeof(spacing_));
+    for (glm::vec4 const & s : samples_)
+    {
+        file.write(reinterpret_cast<char const *>(&s.w), sizeof(s.w));
+    }
+    if (!file)
+        throw std::runtime_error(std::string("Cannot write file '") + path + "'");
+}
+
+//! @return     the region covered by the samples
+
+BoundingBox DistanceField::bounds() const
+{
+    return { origin_, origin_ + glm::vec3((float)(size_.x - 1), (float)(size_.y - 1), (float)(size_.z - 1)) * spacing_ };
+}
+
+//! @param  p           The point
+//! @param  distance    The signed distance at the point (negative inside the shape)
+//! @param  gradient    The gradient of the distance at the point, which points away from the surface
+//!
+//! @return     true if the point is within the grid
+
+bool DistanceField::sample(glm::vec3 const & p, float & distance, glm::vec3 & gradient) const
+{
+    glm::vec3 g = (p - origin_) / spacing_;
+    if (!(g.x >= 0.0f && g.y >= 0.0f && g.z >= 0.0f &&
+          g.x <= (float)(size_.x - 1) && g.y <= (float)(size_.y - 1) && g.z <= (float)(size_.z - 1)))
+    {
+        return false;
+    }
+
+    int x = std::min((int)g.x, size_.x - 2);
+    int y = std::min((int)g.y, size_.y - 2);
+    int z = std::min((int)g.z, size_.z - 2);
+    float fx = g.x - (float)x;
+    float fy = g.y - (float)y;
+    float fz = g.z - (float)z;
+
+    size_t const i   = index(x, y, z);
+    size_t const dy  = (size_t)size_.x;
+    size_t const dz  = (size_t)size_.x * size_.y;
+    glm::vec4 c00 = samples_[i]           + (samples_[i + 1]           - samples_[i])           * fx;
+    glm::vec4 c10 = samples_[i + dy]      + (samples_[i + dy + 1]      - samples_[i + dy])      * fx;
+    glm::vec4 c01 = samples_[i + dz]      + (samples_[i + dz + 1]      - samples_[i + dz])      * fx;
+    glm::vec4 c11 = samples_[i + dz + dy] + (samples_[i + dz + dy + 1] - samples_[i + dz + dy]) * fx;
+    glm::vec4 c0  = c00 + (c10 - c00) * fy;
+    glm::vec4 c1  = c01 + (c11 - c01) * fy;
+    glm::vec4 c   = c0 + (c1 - c0) * fz;
+
+    distance = c.w;
+    gradient = glm::vec3(c);
+    return true;
+}
+
+//! @param  positions   Positions of the particles. Updated if the particles bounce.
+//! @param  velocities  Velocities of the particles. Updated if the particles bounce.
+//! @param  ages        Ages of the particles. Particles with negative ages are ignored.
+//! @param  offset      Position of the field's origin in the world
+//! @param  dampening   Ratio of post-bounce velocity to pre-bounce velocity
+//! @param  events      If not empty, ParticleEvent::BOUNCE is added to the events of the particles that bounce
+//!
+//! A particle inside the shape is moved out along the gradient by (1 + dampening) times its depth, and the part of
+//! its velocity into the shape is reflected, just as a surface does.
+
+void DistanceField::collide(Vec3Span<float> const &   positions,
+                            Vec3Span<float> const &   velocities,
+                            Span<float const> const & ages,
+                            glm::vec3 const &         offset,
+                            float                     dampening,
+                            Span<uint8_t> const &     events /*= Span<uint8_t>()*/) const
+{
+    size_t const n = ages.size();
+    assert(positions.size() == n && velocities.size() == n);
+
+    float const f = 1.0f + dampening;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (ages[i] < 0.0f)
+            continue;
+
+        glm::vec3 p = positions[i];
+        float     distance;
+        glm::vec3 gradient;
+        if (!sample(p - offset, distance, gradient) || distance >= 0.0f)
+            continue;
+
+        float g2 = glm::dot(gradient, gradient);
+        if (g2 <= 0.0f)
+            continue;
+
+        glm::vec3 normal = gradient / std::sqrt(g2);
+        positions.set(i, p - normal * (f * distance));
+
+        glm::vec3 v     = velocities[i];
+        float     speed = glm::dot(normal, v);
+        if (speed < 0.0f)
+            velocities.set(i, v - normal * (f * speed));
+
+        if (!events.empty())
+            events[i] |= ParticleEvent::BOUNCE;
+    }
+}
+} // namespace Confetti
@@ -1,37 +1,59 @@
 #include "Emitter.h"
 
 #include "Appearance.h"
+#include "CollisionWorld.h"
+#include "DistanceField.h"
+#include "Environment.h"
+#include "Frustum.h"
+#include "ParticleEventRing.h"
 #include "Particle.h"
+#include "ParticleKernel.h"
 #include "resource.h"
 #include "StreakParticle.h"
 #include "TexturedParticle.h"
+#include "UpdateContext.h"
+#include "WindField.h"
 
 #include <Vkx/Camera.h>
 
-#define GLM_ENABLE_EXPERIMENTAL
 #include <glm/glm.hpp>
-#include <glm/gtx/norm.hpp>
 
 #include <algorithm>
+#include <cassert>
+#include <cmath>
 
-// This class sorts particles back-to-front
-class ParticleSorter
+namespace
 {
-public:
-    ParticleSorter(glm::vec3 const & cameraPosition)
-        : cameraPosition_(cameraPosition)
-    {
-    }
+// Earliest point in an update at which a particle can be emitted (0 is the start and 1 is the end). The kernels only
+// reset a particle to its birth state if its age is less than dt after the update, so a particle can't be emitted at
+// exactly the start.
+float constexpr EARLIEST_EMISSION = 1.0f / 1024.0f;
 
-    bool operator ()(Confetti::Particle const & a, Confetti::Particle const & b)
+void addParticle(Confetti::ParticleStore & store, Confetti::Particle const & p)
+{
+    store.add(p.lifetime(), p.age(), p.position(), p.velocity(), p.color());
+}
+
+void addParticle(Confetti::ParticleStore & store, Confetti::TexturedParticle const & p)
+{
+    store.add(p.lifetime(), p.age(), p.position(), p.velocity(), p.color(), p.radius(), p.rotation());
+}
+
+void addParticle(Confetti::ParticleStore & store, Confetti::SphereParticle const & p)
+{
+    store.add(p.lifetime(), p.age(), p.position(), p.velocity(), p.color(), p.GetRadius());
+}
+
+template <typename P>
+void addParticles(Confetti::ParticleStore & store, std::vector<P> const & particles)
+{
+    store.reserve(particles.size());
+    for (auto const & p : particles)
     {
-        glm::vec3 da = a.position() - cameraPosition_;
-        glm::vec3 db = b.position() - cameraPosition_;
-        return glm::length2(da) > glm::length2(db);
+        addParticle(store, p);
     }
-
-    glm::vec3 cameraPosition_;
-};
+}
+} // anonymous namespace
 
 namespace Confetti
 {
@@ -39,13 +61,16 @@ namespace Confetti
 //! @param  environment     Environment applied to all particles.
 //! @param  appearance      Appearance shared by all particles.
 //! @param  sorted          True, if the particles should be sorted back-to-front when updated
+//! @param  streams         Optional particle streams used by this type of emitter (see ParticleStore::Streams)
 
 BasicEmitter::BasicEmitter(std::shared_ptr<Vkx::Device>   device,
                            std::shared_ptr<EmitterVolume> volume,
                            std::shared_ptr<Environment>   environment,
                            std::shared_ptr<Appearance>    appearance,
-                           bool                           sorted)
+                           bool                           sorted,
+                           uint32_t                       streams /*= ParticleStore::NONE*/)
     : device_(device)
+    , particles_(streams)
     , volume_(volume)
     , appearance_(appearance)
     , environment_(environment)
@@ -112,61 +137,690 @@ void BasicEmitter::update(glm::vec3 const & position, glm::vec3 const & velocity
     velocity_ = velocity;
 }
 
+//! @param  dt  Amount of time elapsed since the last update
+
+UpdateContext BasicEmitter::updateContext(float dt) const
+{
+    return UpdateContext(*environment_, *appearance_, position_, velocity_, dt);
+}
+
+//! @param  dt  Amount of time elapsed since the last update
+
+void BasicEmitter::updateParticles(float dt)
+{
+    UpdateContext context = beginUpdate(dt);
+    BoundingBox   bounds  = updateChunk(context, 0, aliveCount_);
+    endUpdate(bounds);
+}
+
+//! @param  dt  Amount of time elapsed since the last update
+//!
+//! The particles born during this update are moved into the alive range. The chunks to be updated must be within
+//! [0, aliveCount()).
+
+UpdateContext BasicEmitter::beginUpdate(float dt)
+{
+    // The particles are evaluated from the emitter's current position and velocity, so they can't be evaluated if
+    // any of them were emitted while the emitter was somewhere else or moving differently.
+
+    bool wasAnalytic = analyticUpdate_;
+    analyticUpdate_ = analytic_ && environment_->isAnalytic() && !events_ && stationary();
+
+    // If switching from analytic evaluation to simulation, the simulation needs the current state of the particles.
+    // They are evaluated from where the emitter was during the last update.
+
+    if (wasAnalytic && !analyticUpdate_ && stale_)
+        evaluate(0, aliveCount_);
+
+    // Age the unborn particles. The ones that are born are moved into the alive range and their ages are left to be
+    // updated along with the rest of the live particles.
+
+    size_t const n = particles_.size();
+    aliveCount_ = std::min(aliveCount_, n);
+
+    if (looping_)
+    {
+        Span<float> ages = particles_.ages();
+        for (size_t i = aliveCount_; i < n; ++i)
+        {
+            float age = ages[i] + dt;
+            if (age >= 0.0f)
+            {
+                particles_.swap(i, aliveCount_);
+                ++aliveCount_;
+            }
+            else
+            {
+                ages[i] = age;
+            }
+        }
+    }
+    else
+    {
+        emit(dt);
+    }
+
+    chunkBounds_.resize((aliveCount_ + CULL_CHUNK_SIZE - 1) / CULL_CHUNK_SIZE);
+
+    if (birth_.count != n)
+        measureBirthState();
+    birth_.elapsed += dt;
+    recordMotion(dt);
+
+    lastDt_       = dt;
+    lastPosition_ = position_;
+    lastVelocity_ = velocity_;
+
+    // The planes are skipped if the particles can't reach any of them during this update
+
+    UpdateContext context = updateContext(dt);
+
+    // Collisions with the collision world are found from the path of each particle, so the positions before the
+    // update are kept in the previous state.
+    if (!analyticUpdate_ && context.collisionWorld())
+        particles_.addStreams(ParticleStore::PREVIOUS);
+
+    skippedPlanes_ = !analyticUpdate_ && inFrontOfPlanes(dt);
+    return skippedPlanes_ ? context.withoutPlanes() : context;
+}
+
+//! @param  context     Context returned by beginUpdate()
+//! @param  begin       Index of the first particle to update
+//! @param  end         Index of the particle following the last particle to update
+//!
+//! @return     bounding box of the particles in the chunk that are still alive (empty if evaluated analytically)
+//!
+//! Chunks that don't overlap can be updated concurrently. The chunk must start at a multiple of CULL_CHUNK_SIZE, and the
+//! bounds of the culling chunks within it are computed right after the update, while the positions are in the cache.
+
+BoundingBox BasicEmitter::updateChunk(UpdateContext const & context, size_t begin, size_t end)
+{
+    prepareChunk(context, begin, end);
+    if (analyticUpdate_)
+    {
+        ParticleKernel::advance(particles_, begin, end, context);
+        return BoundingBox();
+    }
+
+    // The events of the chunk are collected as flags and recorded after all the collisions
+    static thread_local std::vector<uint8_t> events;
+    Span<uint8_t> chunkEvents;
+    if (events_)
+    {
+        events.resize(end - begin);
+        chunkEvents = events;
+    }
+
+    ParticleKernel::update(particles_, begin, end, context, chunkEvents.data());
+    return finishChunk(context, begin, end, chunkEvents.data());
+}
+
+//! @param  context     Context returned by beginUpdate()
+//! @param  begin       Index of the first particle to update
+//! @param  end         Index of the particle following the last particle to update
+//!
+//! This saves the state the kernel overwrites that is still needed after the update.
+
+void BasicEmitter::prepareChunk(UpdateContext const & context, size_t begin, size_t end)
+{
+    assert(end <= aliveCount_);
+    assert(begin % CULL_CHUNK_SIZE == 0);
+
+    CollisionWorld const * world = analyticUpdate_ ? nullptr : context.collisionWorld();
+    if (interpolated_ || world)
+        savePreviousState(begin, end);
+}
+
+//! @param  context     Context returned by beginUpdate()
+//! @param  begin       Index of the first particle to update
+//! @param  end         Index of the particle following the last particle to update
+//! @param  events      Events written by the kernel for the particles in the chunk, or nullptr if the events are not
+//!                     recorded
+//!
+//! @return     bounding box of the particles in the chunk that are still alive
+
+BoundingBox BasicEmitter::finishChunk(UpdateContext const & context, size_t begin, size_t end, uint8_t * events)
+{
+    assert(!analyticUpdate_);
+    assert(events || !events_);
+
+    CollisionWorld const * world = context.collisionWorld();
+    Span<uint8_t>          chunkEvents(events, events ? end - begin : 0);
+
+    if (world)
+    {
+        world->collide(particles_.previousPositions().subspan(begin, end - begin),
+                       particles_.positions().subspan(begin, end - begin),
+                       particles_.velocities().subspan(begin, end - begin),
+                       particles_.ages().subspan(begin, end - begin),
+                       context.dt(),
+                       chunkEvents);
+    }
+
+    for (Environment::Collider const & collider : context.colliders())
+    {
+        collider.field->collide(particles_.positions().subspan(begin, end - begin),
+                                particles_.velocities().subspan(begin, end - begin),
+                                particles_.ages().subspan(begin, end - begin),
+                                collider.position,
+                                collider.dampening,
+                                chunkEvents);
+    }
+
+    if (events_)
+        recordEvents(begin, chunkEvents.data(), chunkEvents.size());
+
+    // Measure the bounds of each chunk of particles that is still alive
+
+    BoundingBox           bounds;
+    Span<float const>     ages      = particles_.ages();
+    Vec3Span<float const> positions = particles_.positions();
+    for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += CULL_CHUNK_SIZE)
+    {
+        size_t const chunkEnd = std::min(chunkBegin + CULL_CHUNK_SIZE, end);
+        BoundingBox  chunk;
+        for (size_t i = chunkBegin; i < chunkEnd; ++i)
+        {
+            if (ages[i] >= 0.0f)
+            {
+                bounds.add(positions[i]);
+                addExtents(chunk, i);
+            }
+        }
+        chunkBounds_[chunkBegin / CULL_CHUNK_SIZE] = chunk;
+    }
+    return bounds;
+}
+
+//! @param  bounds  Union of the bounding boxes returned by updateChunk()
+//!
+//! Particles that were clipped during this update are moved out of the alive range.
+
+void BasicEmitter::endUpdate(BoundingBox const & bounds)
+{
+    bounds_   = analyticUpdate_ ? analyticBounds() : bounds;
+    measured_ = true;
+
+    // The positions of the particles are not known if they are evaluated analytically, so every chunk gets the
+    // analytic bound. Otherwise, the chunks were measured by updateChunk().
+    if (analyticUpdate_)
+        std::fill(chunkBounds_.begin(), chunkBounds_.end(), bounds_);
+
+    // Move the clipped particles (their ages are now negative) to the end of the alive range
+
+    Span<float const> ages = particles_.ages();
+    for (size_t i = 0; i < aliveCount_;)
+    {
+        if (ages[i] < 0.0f)
+        {
+            // The last live particle takes its place, so its chunk's bounds must contain it
+            --aliveCount_;
+            particles_.swap(i, aliveCount_);
+            if (!analyticUpdate_ && i < aliveCount_)
+                addExtents(chunkBounds_[i / CULL_CHUNK_SIZE], i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    chunkBounds_.resize((aliveCount_ + CULL_CHUNK_SIZE - 1) / CULL_CHUNK_SIZE);
+
+    if (analyticUpdate_)
+    {
+        stale_ = true;
+
+        // Sorting and interpolation need the positions
+        if (sorted() || interpolated_)
+            evaluate(0, aliveCount_);
+    }
+
+    // Sort the live particles by distance from the camera if desired. The particles are not moved, they are drawn in
+    // the order given by drawOrder_.
+
+    if (sorted())
+    {
+        Vec3Span<float const> alive = particles_.positions().subspan(0, aliveCount_);
+        sorter_.sort(alive, appearance()->camera->position(), drawOrder_);
+    }
+}
+
+//! @param  begin       Index of the first particle to evaluate
+//! @param  end         Index of the particle following the last particle to evaluate
+//!
+//! This does nothing if the particles were simulated during the last update. Ranges that don't overlap can be
+//! evaluated concurrently, but the emitter is only marked as up to date if all the live particles are evaluated at
+//! once.
+
+void BasicEmitter::evaluate(size_t begin, size_t end)
+{
+    if (!stale_)
+        return;
+
+    UpdateContext const context(*environment_, *appearance_, lastPosition_, lastVelocity_, lastDt_);
+    ParticleKernel::evaluate(particles_, begin, end, context);
+    if (begin == 0 && end >= aliveCount_)
+        stale_ = false;
+}
+
+//! @param  rate    Number of particles emitted per second
+
+void BasicEmitter::setEmissionRate(float rate)
+{
+    assert(rate >= 0.0f);
+    looping_      = false;
+    emissionRate_ = rate;
+}
+
+//! @param  n   Number of particles to emit
+
+void BasicEmitter::burst(size_t n)
+{
+    looping_ = false;
+    burst_  += n;
+}
+
+//! @param  interpolated    If true, the particles are interpolated between updates
+//!
+//! @note   The previous state of the particles is allocated the first time interpolation is enabled.
+
+void BasicEmitter::setInterpolated(bool interpolated)
+{
+    if (interpolated && !interpolated_)
+    {
+        particles_.addStreams(ParticleStore::PREVIOUS);
+        evaluate(0, aliveCount_);
+        savePreviousState(0, aliveCount_);
+    }
+    interpolated_ = interpolated;
+}
+
+//! @param  i   Index of a live particle
+//!
+//! A particle that was born during the last update has no meaningful previous state, so its current position is
+//! returned.
+
+glm::vec3 BasicEmitter::interpolatedPosition(size_t i) const
+{
+    assert(i < aliveCount_);
+
+    glm::vec3 current = particles_.positions()[i];
+    if (!interpolated_ || particles_.ages()[i] < lastDt_)
+        return current;
+
+    return glm::mix(particles_.previousPositions()[i], current, interpolationFactor_);
+}
+
+//! @param  i   Index of a live particle
+//!
+//! A particle that was born during the last update has no meaningful previous state, so its current color is
+//! returned.
+
+glm::vec4 BasicEmitter::interpolatedColor(size_t i) const
+{
+    assert(i < aliveCount_);
+
+    glm::vec4 current = particles_.colors()[i];
+    if (!interpolated_ || particles_.ages()[i] < lastDt_)
+        return current;
+
+    return glm::mix(particles_.previousColors()[i], current, interpolationFactor_);
+}
+
+//! Particles that have been (re)born by the emitter are within a box around the emitter's current position, since the
+//! emitter's velocity is added to theirs. Until every particle has been reborn at least once, the bound also includes
+//! a box around the initial positions, since particles that started out alive were not placed relative to the
+//! emitter.
+
+BoundingBox BasicEmitter::analyticBounds() const
+{
+    if (birth_.count == 0 || birth_.positions.empty())
+        return BoundingBox();
+
+    // A live particle was born within the last lifetime, at a position and with a velocity relative to the emitter's
+    // at the time. Particles that have not been reborn since the emitter was built are relative to the origin.
+
+    float const  t      = birth_.lifetime;
+    MotionBounds motion = recentMotion();
+    if (birth_.elapsed < t)
+    {
+        motion.positions.add(glm::vec3(0.0f));
+        motion.velocities.add(glm::vec3(0.0f));
+    }
+
+    BoundingBox     bounds{ motion.positions.min + birth_.positions.min, motion.positions.max + birth_.positions.max };
+    glm::vec3 const launchMin = motion.velocities.min - birth_.speed;
+    glm::vec3 const launchMax = motion.velocities.max + birth_.speed;
+    glm::vec3 const zero(0.0f);
+
+    if (environment_->airFriction() != 0.0f)
+    {
+        // The velocity of a particle moves from its initial velocity toward the terminal velocity, so every component
+        // of its velocity stays between the extremes of the two.
+        bounds.min += glm::min(zero, glm::min(launchMin, motion.terminal.min) * t);
+        bounds.max += glm::max(zero, glm::max(launchMax, motion.terminal.max) * t);
+    }
+    else
+    {
+        glm::vec3 const fall = 0.5f * environment_->gravity() * t * t;
+        bounds.min += glm::min(zero, launchMin * t) + glm::min(fall, zero);
+        bounds.max += glm::max(zero, launchMax * t) + glm::max(fall, zero);
+    }
+
+    return bounds;
+}
+
+// Measures the extremes of the birth state of the particles
+void BasicEmitter::measureBirthState()
+{
+    Span<float const>     lifetimes  = particles_.lifetimes();
+    Vec3Span<float const> positions  = particles_.initialPositions();
+    Vec3Span<float const> velocities = particles_.initialVelocities();
+
+    birth_           = BirthBounds();
+    birth_.speed     = glm::vec3(0.0f);
+    birth_.lifetime  = 0.0f;
+    birth_.elapsed   = 0.0f;
+    birth_.count     = particles_.size();
+    for (size_t i = 0; i < birth_.count; ++i)
+    {
+        birth_.positions.add(positions[i]);
+        birth_.speed    = glm::max(birth_.speed, glm::abs(velocities[i]));
+        birth_.lifetime = std::max(birth_.lifetime, lifetimes[i]);
+    }
+}
+
+// Records the emitter's motion and the forces of the environment during an update. The windows are a lifetime long,
+// so together the current and previous windows cover the lives of all the live particles.
+void BasicEmitter::recordMotion(float dt)
+{
+    if (motion_[0].elapsed >= birth_.lifetime)
+    {
+        motion_[1] = motion_[0];
+        motion_[0] = MotionBounds();
+    }
+
+    motion_[0].positions.add(position_);
+    motion_[0].velocities.add(velocity_);
+    motion_[0].terminal.add(terminalVelocities(dt));
+    motion_[0].elapsed += dt;
+}
+
+// Returns the range of the terminal velocities of the particles during an update. Gusts change the wind by at most
+// gustiness * dt, and the wind field and turbulence add at most their largest speeds.
+BoundingBox BasicEmitter::terminalVelocities(float dt) const
+{
+    glm::vec3 const terminal = environment_->terminalVelocity();
+    glm::vec3       spread(environment_->gustiness() * dt);
+    if (environment_->windField())
+        spread += environment_->windField()->maxSpeed();
+    spread += environment_->turbulence().maxSpeed();
+    return BoundingBox{ terminal - spread, terminal + spread };
+}
+
+// Returns the extremes of the emitter's motion and the forces of the environment during the last lifetime, including
+// the current state
+BasicEmitter::MotionBounds BasicEmitter::recentMotion() const
+{
+    MotionBounds motion = motion_[0];
+    motion.positions.add(motion_[1].positions);
+    motion.velocities.add(motion_[1].velocities);
+    motion.terminal.add(motion_[1].terminal);
+    motion.positions.add(position_);
+    motion.velocities.add(velocity_);
+    motion.terminal.add(terminalVelocities(0.0f));
+    return motion;
+}
+
+// Returns true if the emitter's position and velocity have not changed during the last lifetime, so all the live
+// particles were emitted from its current state
+bool BasicEmitter::stationary() const
+{
+    MotionBounds const motion = recentMotion();
+    return motion.positions.min == motion.positions.max && motion.velocities.min == motion.velocities.max;
+}
+
+// Returns the largest magnitude of each component of the velocity of any particle
+glm::vec3 BasicEmitter::maxVelocity() const
+{
+    MotionBounds const motion = recentMotion();
+    glm::vec3 const    launch =
+        glm::max(glm::abs(motion.velocities.min), glm::abs(motion.velocities.max)) + birth_.speed;
+    if (environment_->airFriction() != 0.0f)
+    {
+        glm::vec3 const terminal = glm::max(glm::abs(motion.terminal.min), glm::abs(motion.terminal.max));
+        return glm::max(launch, terminal);
+    }
+    else
+        return launch + glm::abs(environment_->gravity()) * birth_.lifetime;
+}
+
+// Returns true if no particle can be behind a clip plane or surface at the end of an update. Either the analytic bound
+// is in front of all the planes, or the bounds after the last update, grown by the farthest a particle can move, are.
+// New particles are born near the emitter, so they are included too.
+bool BasicEmitter::inFrontOfPlanes(float dt) const
+{
+    PlaneSet const & clippers = environment_->clipperPlanes();
+    PlaneSet const & surfaces = environment_->surfacePlanes();
+    if (clippers.empty() && surfaces.empty())
+        return false;
+
+    BoundingBox analytic = analyticBounds();
+    if (clippers.inFront(analytic) && surfaces.inFront(analytic))
+        return true;
+
+    if (!measured_)
+        return false;
+
+    glm::vec3 const margin    = maxVelocity() * dt + 0.5f * glm::abs(environment_->gravity()) * dt * dt;
+    BoundingBox     predicted = bounds_.expanded(margin);
+    predicted.add(birth_.positions.translated(position_).expanded(margin));
+    return clippers.inFront(predicted) && surfaces.inFront(predicted);
+}
+
+//! @param  frustum     The view frustum of the emitter's camera
+//!
+//! The bounds are grown by the size of the particles in the appearance.
+
+void BasicEmitter::cull(Frustum const & frustum)
+{
+    glm::vec3 const margin(appearance_->size);
+
+    BoundingBox bounds;
+    for (auto const & chunk : chunkBounds_)
+    {
+        bounds.add(chunk);
+    }
+    visible_ = frustum.intersects(bounds.expanded(margin));
+
+    chunkVisible_.assign(chunkBounds_.size(), 0);
+    if (visible_)
+    {
+        for (size_t i = 0; i < chunkBounds_.size(); ++i)
+        {
+            chunkVisible_[i] = frustum.intersects(chunkBounds_[i].expanded(margin));
+        }
+    }
+}
+
+// Grows a box to contain all the points drawn for a particle
+void BasicEmitter::addExtents(BoundingBox & box, size_t i) const
+{
+    glm::vec3 const position = particles_.positions()[i];
+    if (particles_.has(ParticleStore::RADIUS))
+    {
+        glm::vec3 const radius(std::abs(particles_.radii()[i]));
+        box.add(position - radius);
+        box.add(position + radius);
+    }
+    else
+    {
+        box.add(position);
+    }
+
+    if (particles_.has(ParticleStore::TAIL))
+        box.add(particles_.tails()[i]);
+
+    // Particles born during the last update are drawn at their current positions
+    if (interpolated_ && particles_.ages()[i] >= lastDt_)
+        box.add(particles_.previousPositions()[i]);
+}
+
+// Frees the particles that reach the end of their lifetimes during an update of dt and emits new ones
+void BasicEmitter::emit(float dt)
+{
+    // The particles that would expire during the update are freed instead of being reset by the kernel. The last live
+    // particle takes the place of each one.
+
+    Span<float>       ages      = particles_.ages();
+    Span<float const> lifetimes = particles_.lifetimes();
+    for (size_t i = 0; i < aliveCount_;)
+    {
+        if (ages[i] + dt >= lifetimes[i])
+        {
+            --aliveCount_;
+            particles_.swap(i, aliveCount_);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    if (dt <= 0.0f)
+        return;
+
+    // The k-th particle emitted at the rate during the update is emitted when the emission carried over reaches k
+
+    float const  emitted = emissionRate_ * dt;
+    float const  total   = emission_ + emitted;
+    size_t const rated   = (size_t)total;
+    size_t const count   = std::min(burst_ + rated, particles_.size() - aliveCount_);
+
+    // A particle emitted at point t of the update is given an age of -t * dt, so that the kernel resets it to its
+    // birth state and advances it through the rest of the update. Bursts are emitted first, at the start.
+
+    for (size_t j = 0; j < count; ++j)
+    {
+        float t = EARLIEST_EMISSION;
+        if (j >= burst_)
+            t = std::max((float)(j - burst_ + 1) - emission_, 0.0f) / emitted;
+        ages[aliveCount_ + j] = -dt * std::min(std::max(t, EARLIEST_EMISSION), 1.0f);
+    }
+
+    aliveCount_ += count;
+    emission_    = total - (float)rated;
+    burst_       = 0;
+}
+
+// Copies the current positions and colors of the particles in [begin, end) to their previous state
+void BasicEmitter::savePreviousState(size_t begin, size_t end)
+{
+    Vec3Span<float const> positions = particles_.positions();
+    Vec4Span<float const> colors    = particles_.colors();
+    Vec3Span<float>       previousPositions = particles_.previousPositions();
+    Vec4Span<float>       previousColors    = particles_.previousColors();
+    for (size_t i = begin; i < end; ++i)
+    {
+        previousPositions.x[i] = positions.x[i];
+        previousPositions.y[i] = positions.y[i];
+        previousPositions.z[i] = positions.z[i];
+        previousColors.x[i]    = colors.x[i];
+        previousColors.y[i]    = colors.y[i];
+        previousColors.z[i]    = colors.z[i];
+        previousColors.w[i]    = colors.w[i];
+    }
+}
+
+// Records the events of the particles in [begin, begin + n). events[i] holds the flags of particle begin + i.
+void BasicEmitter::recordEvents(size_t begin, uint8_t const * events, size_t n)
+{
+    static ParticleEvent::Type const TYPES[] = { ParticleEvent::BIRTH, ParticleEvent::CLIP, ParticleEvent::BOUNCE };
+
+    Vec3Span<float const> positions  = particles_.positions();
+    Vec3Span<float const> velocities = particles_.velocities();
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (events[i] == 0)
+            continue;
+
+        for (ParticleEvent::Type type : TYPES)
+        {
+            if (events[i] & type)
+                events_->push({ type, positions[begin + i], velocities[begin + i] });
+        }
+    }
+}
+
 /********************************************************************************************************************/
-/*                                   P O I N T   P A R T I C L E   E M I T T E R                                    */
+/*                                         E M I T T E R   T E M P L A T E                                          */
 /********************************************************************************************************************/
-//! @param  volume          Emitter volume.
-//! @param  environment     Environment.
-//! @param  appearance      Appearance.
+
+//! @param  device          Device the emitter draws on
 //! @param  n               Number of particles to create.
+//! @param  volume          Emitter volume.
+//! @param  environment     Environment applied to all particles.
+//! @param  appearance      Appearance shared by all particles.
+//! @param  sorted          If true, then the particles will be sorted back to front during the update
 //!
 //! @warning std::bad_alloc is thown if memory is unable to be allocated for the particles.
 
-PointEmitter::PointEmitter(std::shared_ptr<Vkx::Device>   device,
-                           int                            n,
-                           std::shared_ptr<EmitterVolume> volume,
-                           std::shared_ptr<Environment>   environment,
-                           std::shared_ptr<Appearance>    appearance,
-                           bool                           sorted)
-    : BasicEmitter(device, volume, environment, appearance, sorted)
-    , particles_(n)
+template <typename Traits>
+BasicEmitterT<Traits>::BasicEmitterT(std::shared_ptr<Vkx::Device>   device,
+                                     int                            n,
+                                     std::shared_ptr<EmitterVolume> volume,
+                                     std::shared_ptr<Environment>   environment,
+                                     std::shared_ptr<Appearance>    appearance,
+                                     bool                           sorted)
+    : BasicEmitter(device, volume, environment, appearance, sorted, Traits::STREAMS)
 {
+    particles_.resize(n);
     initialize();
 }
 
-//! @param  particles       Particle array (the emitter assumes ownership).
+//! @param  device          Device the emitter draws on
+//! @param  particles       Initial states of the particles.
 //! @param  volume          Emitter volume.
 //! @param  environment     Environment applied to all particles.
 //! @param  appearance      Appearance shared by all particles.
-//! @param  n               Number of particles to create.
-//!
-//! @warning particles must have been allocated with new[].
+//! @param  sorted          If true, then the particles will be sorted back to front during the update
 
-PointEmitter::PointEmitter(std::shared_ptr<Vkx::Device>   device,
-                           std::vector<PointParticle>     particles,
-                           std::shared_ptr<EmitterVolume> volume,
-                           std::shared_ptr<Environment>   environment,
-                           std::shared_ptr<Appearance>    appearance,
-                           bool                           sorted)
-    : BasicEmitter(device, volume, environment, appearance, sorted)
-    , particles_(particles)
+template <typename Traits>
+BasicEmitterT<Traits>::BasicEmitterT(std::shared_ptr<Vkx::Device>      device,
+                                     std::vector<ParticleType> const & particles,
+                                     std::shared_ptr<EmitterVolume>    volume,
+                                     std::shared_ptr<Environment>      environment,
+                                     std::shared_ptr<Appearance>       appearance,
+                                     bool                              sorted)
+    : BasicEmitter(device, volume, environment, appearance, sorted, Traits::STREAMS)
 {
+    addParticles(particles_, particles);
     initialize();
 }
 
-PointEmitter::~PointEmitter()
+template <typename Traits>
+BasicEmitterT<Traits>::~BasicEmitterT()
 {
     uninitialize();
 }
 
-void PointEmitter::initialize()
+//! @param  dt  Amount of time elapsed since the last update
+//!
+//! All the particles are updated by a single call to the particle kernel.
+
+template <typename Traits>
+void BasicEmitterT<Traits>::update(float dt)
 {
-    // Point the particles' emitter value here
+    updateParticles(dt);
+}
 
-    for (auto & p : particles_)
-    {
-        p.bind(this);
-    }
+/********************************************************************************************************************/
+/*                                   P O I N T   P A R T I C L E   E M I T T E R                                    */
+/********************************************************************************************************************/
+
+template <>
+void PointEmitter::initialize()
+{
 #if 0
     // Load the shader
     {
@@ -302,29 +956,12 @@ void PointEmitter::initialize()
 #endif  // if 0
 }
 
+template <>
 void PointEmitter::uninitialize()
 {
 }
 
-//! @param  dt  Amount of time elapsed since the last update
-
-void PointEmitter::update(float dt)
-{
-    for (auto & p : particles_)
-    {
-        p.update(dt);
-    }
-
-    // Sort the particles by distance from the camera if desired
-
-    if (sorted())
-    {
-        std::sort(particles_.begin(),
-                  particles_.end(),
-                  ParticleSorter(appearance()->camera->position()));
-    }
-}
-
+template <>
 void PointEmitter::draw() const
 {
 #if 0
@@ -476,79 +1113,9 @@ void PointEmitter::draw() const
 /*                                  S T R E A K   P A R T I C L E   E M I T T E R                                   */
 /********************************************************************************************************************/
 
-//! @param  n               Number of particles to create.
-//! @param  volume          Emitter volume.
-//! @param  environment     Environment.
-//! @param  appearance      Appearance.
-//! @param  sorted          If true, then the particles will be sorted back to front during the update
-//!
-//! @warning std::bad_alloc is thown if memory is unable to be allocated for the particles.
-
-StreakEmitter::StreakEmitter(std::shared_ptr<Vkx::Device>   device,
-                             int                            n,
-                             std::shared_ptr<EmitterVolume> volume,
-                             std::shared_ptr<Environment>   environment,
-                             std::shared_ptr<Appearance>    appearance,
-                             bool                           sorted)
-    : BasicEmitter(device, volume, environment, appearance, sorted)
-    , particles_(n)
-
-{
-    initialize();
-}
-
-//! @param  device          Device the emitter draws on
-//! @param  particles       Particle array (the emitter assumes ownership).
-//! @param  volume          Emitter volume.
-//! @param  environment     Environment applied to all particles.
-//! @param  appearance      Appearance shared by all particles.
-//! @param  sorted          If true, then the particles will be sorted back to front during the update
-
-StreakEmitter::StreakEmitter(std::shared_ptr<Vkx::Device>   device,
-                             std::vector<StreakParticle>    particles,
-                             std::shared_ptr<EmitterVolume> volume,
-                             std::shared_ptr<Environment>   environment,
-                             std::shared_ptr<Appearance>    appearance,
-                             bool                           sorted)
-    : BasicEmitter(device, volume, environment, appearance, sorted)
-    , particles_(particles)
-{
-    initialize();
-}
-
-StreakEmitter::~StreakEmitter()
-{
-    uninitialize();
-}
-
-//!
-//! @param dt Amount of time elapsed since the last update
-
-void StreakEmitter::update(float dt)
-{
-    for (auto & p : particles_)
-    {
-        p.update(dt);
-    }
-
-    // Sort the particles by distance from the camera if desired
-
-    if (sorted())
-    {
-        std::sort(particles_.begin(),
-                  particles_.end(),
-                  ParticleSorter(appearance()->camera->position()));
-    }
-}
-
+template <>
 void StreakEmitter::initialize()
 {
-    // Point the particles' emitter value here
-
-    for (auto & p : particles_)
-    {
-        p.bind(this);
-    }
 #if 0
     // Load the effects file
 
@@ -580,10 +1147,12 @@ void StreakEmitter::initialize()
 #endif  // if 0
 }
 
+template <>
 void StreakEmitter::uninitialize()
 {
 }
 
+template <>
 void StreakEmitter::draw() const
 {
 #if 0
@@ -712,57 +1281,9 @@ void StreakEmitter::draw() const
 /*                                  T E X T U R E D   P A R T I C L E   E M I T T E R                               */
 /********************************************************************************************************************/
 
-//! @param volume Emitter volume.
-//! @param environment Environment.
-//! @param appearance Appearance.
-//! @param n  Number of particles to create.
-//!
-//! @warning std::bad_alloc is thown if memory is unable to be allocated for the particles.
-
-TexturedEmitter::TexturedEmitter(std::shared_ptr<Vkx::Device>   device,
-                                 int                            n,
-                                 std::shared_ptr<EmitterVolume> volume,
-                                 std::shared_ptr<Environment>   environment,
-                                 std::shared_ptr<Appearance>    appearance,
-                                 bool                           sorted)
-    : BasicEmitter(device, volume, environment, appearance, sorted)
-    , particles_(n)
-{
-    initialize();
-}
-
-//! @param particles  Particle array (the emitter assumes ownership).
-//! @param volume   Emitter volume.
-//! @param environment   Environment applied to all particles.
-//! @param appearance   Appearance shared by all particles.
-//! @param n    Number of particles to create.
-//!
-//! @warning particles must have been allocated with new[].
-
-TexturedEmitter::TexturedEmitter(std::shared_ptr<Vkx::Device>   device,
-                                 std::vector<TexturedParticle>  particles,
-                                 std::shared_ptr<EmitterVolume> volume,
-                                 std::shared_ptr<Environment>   environment,
-                                 std::shared_ptr<Appearance>    appearance,
-                                 bool                           sorted)
-    : BasicEmitter(device, volume, environment, appearance, sorted)
-    , particles_(particles)
-{
-    initialize();
-}
-
-TexturedEmitter::~TexturedEmitter()
-{
-    uninitialize();
-}
-
+template <>
 void TexturedEmitter::initialize()
 {
-    // Point the particles' emitter value here
-    for (auto & p : particles_)
-    {
-        p.bind(this);
-    }
 #if 0
     // Figure out the maximum necessary size of the index buffer. It is the minimum of the following:
     //
@@ -819,30 +1340,12 @@ void TexturedEmitter::initialize()
 #endif  // if 0
 }
 
+template <>
 void TexturedEmitter::uninitialize()
 {
 }
 
-//!
-//! @param dt Amount of time elapsed since the last update
-
-void TexturedEmitter::update(float dt)
-{
-    for (auto & p : particles_)
-    {
-        p.update(dt);
-    }
-
-    // Sort the particles by distance from the camera if desired
-
-    if (sorted())
-    {
-        std::sort(particles_.begin(),
-                  particles_.end(),
-                  ParticleSorter(appearance()->camera->position()));
-    }
-}
-
+template <>
 void TexturedEmitter::draw() const
 {
 #if 0
@@ -1051,85 +1554,29 @@ void TexturedEmitter::draw() const
 #endif  // if 0
 }
 
-//! @param volume Emitter volume.
-//! @param environment Environment.
-//! @param appearance Appearance.
-//! @param n  Number of particles to create.
-//!
-//! @warning std::bad_alloc is thown if memory is unable to be allocated for the particles.
-
-SphereEmitter::SphereEmitter(std::shared_ptr<Vkx::Device>   device,
-                             int                            n,
-                             std::shared_ptr<EmitterVolume> volume,
-                             std::shared_ptr<Environment>   environment,
-                             std::shared_ptr<Appearance>    appearance,
-                             bool                           sorted)
-    : BasicEmitter(device, volume, environment, appearance, sorted)
-    , particles_(n)
-{
-    initialize();
-}
-
-//! @param particles  Particle array (the emitter assumes ownership).
-//! @param volume   Emitter volume.
-//! @param environment   Environment applied to all particles.
-//! @param appearance   Appearance shared by all particles.
-//! @param n    Number of particles to create.
-//!
-//! @warning particles must have been allocated with new[].
-
-SphereEmitter::SphereEmitter(std::shared_ptr<Vkx::Device>   device,
-                             std::vector<SphereParticle>    particles,
-                             std::shared_ptr<EmitterVolume> volume,
-                             std::shared_ptr<Environment>   environment,
-                             std::shared_ptr<Appearance>    appearance,
-                             bool                           sorted)
-    : BasicEmitter(device, volume, environment, appearance, sorted)
-    , particles_(particles)
-{
-    initialize();
-}
-
-SphereEmitter::~SphereEmitter()
-{
-    uninitialize();
-}
-
-//!
-//! @param dt Amount of time elapsed since the last update
-
-void SphereEmitter::update(float dt)
-{
-    for (auto & p : particles_)
-    {
-        p.update(dt);
-    }
-
-    // Sort the particles by distance from the camera if desired
-
-    if (sorted())
-    {
-        std::sort(particles_.begin(),
-                  particles_.end(),
-                  ParticleSorter(appearance()->camera->position()));
-    }
-}
+/********************************************************************************************************************/
+/*                                  S P H E R E   P A R T I C L E   E M I T T E R                                   */
+/********************************************************************************************************************/
 
+template <>
 void SphereEmitter::initialize()
 {
-    // Point the particles' emitter value here
-
-    for (auto & p : particles_)
-    {
-        p.bind(this);
-    }
 }
 
+template <>
 void SphereEmitter::uninitialize()
 {
 }
 
+template <>
 void SphereEmitter::draw() const
 {
 }
+
+// Explicit instantiations of the emitter types
+
+template class BasicEmitterT<PointParticleTraits>;
+template class BasicEmitterT<StreakParticleTraits>;
+template class BasicEmitterT<TexturedParticleTraits>;
+template class BasicEmitterT<SphereParticleTraits>;
 } // namespace Confetti
@@ -1,157 +1,258 @@
 #include "EmitterVolume.h"
 
 #include <glm/glm.hpp>
-#include <glm/glm.hpp>
-#include <glm/gtc/constants.hpp>
 #include <glm/gtc/constants.hpp>
 
-#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+// Returns the cosine and sine of the angle 2 * pi * (t - 1/2), which covers the circle once for t in [0, 1). The angle
+// is reflected into [-pi/2, pi/2] and the functions are evaluated with polynomials, without branches, so that loops
+// using this function can be vectorized. The error is less than 1e-6.
+void cosSin(float t, float & c, float & s)
+{
+    float const pi     = glm::pi<float>();
+    float const halfPi = glm::half_pi<float>();
+
+    float const x       = glm::two_pi<float>() * (t - 0.5f);
+    bool const  flipped = x > halfPi || x < -halfPi;
+    float const y       = x > halfPi ? pi - x : (x < -halfPi ? -pi - x : x);
+    float const y2      = y * y;
+
+    // Taylor series
+    float constexpr S3  = -1.0f / 6.0f;
+    float constexpr S5  = 1.0f / 120.0f;
+    float constexpr S7  = -1.0f / 5040.0f;
+    float constexpr S9  = 1.0f / 362880.0f;
+    float constexpr S11 = -1.0f / 39916800.0f;
+    float constexpr C2  = -1.0f / 2.0f;
+    float constexpr C4  = 1.0f / 24.0f;
+    float constexpr C6  = -1.0f / 720.0f;
+    float constexpr C8  = 1.0f / 40320.0f;
+    float constexpr C10 = -1.0f / 3628800.0f;
+    float constexpr C12 = 1.0f / 479001600.0f;
+    s = y * (1.0f + y2 * (S3 + y2 * (S5 + y2 * (S7 + y2 * (S9 + y2 * S11)))));
+    c = 1.0f + y2 * (C2 + y2 * (C4 + y2 * (C6 + y2 * (C8 + y2 * (C10 + y2 * C12)))));
+    c = flipped ? -c : c;
+}
+
+// Returns the cube root of x >= 0. The initial estimate is computed from the exponent bits and refined by Newton's
+// method. Unlike std::cbrt, it has no branches, so that loops using this function can be vectorized.
+float cubeRoot(float x)
+{
+    uint32_t i;
+    std::memcpy(&i, &x, sizeof(i));
+    i = i / 3 + 709921077u;
+
+    float y;
+    std::memcpy(&y, &i, sizeof(y));
+    for (int k = 0; k < 3; ++k)
+    {
+        y = (2.0f * y + x / (y * y)) * (1.0f / 3.0f);
+    }
+    return x > 0.0f ? y : 0.0f;
+}
+
+// Fills a list of points from a volume. The first DIMENSIONS components are filled with random numbers in bulk and
+// then mapped to the volume. The call to point() is not virtual, so it is inlined into the loop.
+template <int DIMENSIONS, typename Volume>
+void sampleVolume(Volume const & volume, Confetti::Vec3Span<float> const & points, Confetti::RngStream & rng)
+{
+    rng.uniform(points.x);
+    if (DIMENSIONS > 1)
+        rng.uniform(points.y);
+    if (DIMENSIONS > 2)
+        rng.uniform(points.z);
+
+    size_t const n = points.size();
+    float *      x = points.x.data();
+    float *      y = points.y.data();
+    float *      z = points.z.data();
+    for (size_t i = 0; i < n; ++i)
+    {
+        glm::vec3 p = volume.Volume::point(x[i], y[i], z[i]);
+        x[i] = p.x;
+        y[i] = p.y;
+        z[i] = p.z;
+    }
+}
+} // anonymous namespace
 
 namespace Confetti
 {
-//! @param  rng     Random number generator
+//! A point uses at most 3 numbers, so the ranges of the stream used by different parts don't overlap.
+
+void EmitterVolume::sample(Vec3Span<float> const & points, RngStream const & rng, size_t offset, size_t) const
+{
+    RngStream part = rng;
+    part.discard(3 * (uint64_t)offset);
+    sample(points, part);
+}
+
+//! @param	points  Receives the points
+//! @param	rng     Random number generator (not used)
+
+void EmitterPoint::sample(Vec3Span<float> const & points, RngStream &) const
+{
+    std::fill(points.x.begin(), points.x.end(), 0.0f);
+    std::fill(points.y.begin(), points.y.end(), 0.0f);
+    std::fill(points.z.begin(), points.z.end(), 0.0f);
+}
+
 //! @param	size	Length of the line segment.
 
 EmitterLine::EmitterLine(float size)
-    : randomX(-0.5f * size, 0.5f * size)
+    : size_(size)
+{
+}
+
+glm::vec3 EmitterLine::point(float u, float, float) const
 {
+    return glm::vec3(size_ * (u - 0.5f), 0.0f, 0.0f);
 }
 
-glm::vec3 EmitterLine::operator ()(std::minstd_rand & rng) const
+void EmitterLine::sample(Vec3Span<float> const & points, RngStream & rng) const
 {
-    return glm::vec3(randomX(rng), 0.0f, 0.0f);
+    sampleVolume<1>(*this, points, rng);
 }
 
 //! @param	w	    Size of the rectangle along the X axis.
 //! @param	h       Size of the rectangle along the Z axis.
 
 EmitterRectangle::EmitterRectangle(float w, float h)
-    : randomX_(-0.5f * w, 0.5f * w)
-    , randomZ_(-0.5f * h, 0.5f * h)
+    : width_(w)
+    , height_(h)
+{
+}
 
+glm::vec3 EmitterRectangle::point(float u, float v, float) const
 {
+    return glm::vec3(width_ * (u - 0.5f), 0.0f, height_ * (v - 0.5f));
 }
 
-glm::vec3 EmitterRectangle::operator ()(std::minstd_rand & rng) const
+void EmitterRectangle::sample(Vec3Span<float> const & points, RngStream & rng) const
 {
-    return glm::vec3(randomX_(rng), 0.0f, randomZ_(rng));
+    sampleVolume<2>(*this, points, rng);
 }
 
 //! @param	radius	Radius of the circle.
 
 EmitterCircle::EmitterCircle(float radius)
-    : randomAngle_(0.0f, glm::two_pi<float>())
-    , randomR_(0.0f, radius * radius)
+    : radius_(radius)
 {
 }
 
-glm::vec3 EmitterCircle::operator ()(std::minstd_rand & rng) const
+glm::vec3 EmitterCircle::point(float u, float v, float) const
 {
     // Source: http://mathworld.wolfram.com/DiskPointPicking.html
 
-    float a = randomAngle_(rng);
-    float c = cos(a);
-    float s = sqrt(1.0f - c * c);
-    float r = sqrt(randomR_(rng));
+    float c;
+    float s;
+    cosSin(v, c, s);
+    float r = radius_ * std::sqrt(u);
     return glm::vec3(c * r, s * r, 0.0f);
 }
 
-//! @param	rng     Random number generator.
+void EmitterCircle::sample(Vec3Span<float> const & points, RngStream & rng) const
+{
+    sampleVolume<2>(*this, points, rng);
+}
+
 //! @param	radius	radius of the sphere.
 
 EmitterSphere::EmitterSphere(float radius)
-    : randomR_(0.0f, radius * radius * radius)
-    , randomAngle_(0.0f, glm::two_pi<float>())
-    , randomCos_(-1.0f, 1.0f)
-
+    : radius_(radius)
 {
 }
 
-glm::vec3 EmitterSphere::operator ()(std::minstd_rand & rng) const
+glm::vec3 EmitterSphere::point(float u, float v, float w) const
 {
     // Source: http://mathworld.wolfram.com/SpherePointPicking.html
     //
-    // u = R(-1,1)
-    // v = R(-1,1)
-    // t = a * u
-    // f = acos( b / (PI/2) * v )
-    // v = [ cos(f) * cos(t), sin(f), cos(f) * sin(t) ]
-    // v = [ cos(f) * cos(t), sqrt(1.-cos(f)*cos(f)), cos(f) * sin(t) ]
-    // ct = cos(t)
-    // st = sin(t)
-    // cf = cos(f) = b / (PI/2) * v
-    // sf = sin(f) = sqrt( 1. - cf*cf )
-    // v = [ cf * ct, sf, cf * st ]
-
-    float t  = randomAngle_(rng);
-    float ct = cos(t);
-    float st = sqrt(1.0f - ct * ct);
-    float cf = randomCos_(rng);
-    float sf = sqrt(1.0f - cf * cf);
-    float r  = pow(randomR_(rng), 1.0f / 3.0f);
-
-    return glm::vec3(cf * ct * r, sf * r, cf * st * r);
-}
-
-//! @param	rng     Random number generator.
+    // The direction is uniform on the sphere if its z component is uniform in [-1, 1] and its angle around the z axis
+    // is uniform in [0, 2 pi). The distance is the cube root of a uniform value so that the points are uniform in the
+    // volume.
+
+    float cz = 2.0f * u - 1.0f;
+    float sz = std::sqrt(std::max(1.0f - cz * cz, 0.0f));
+    float c;
+    float s;
+    cosSin(v, c, s);
+    float r = radius_ * cubeRoot(w);
+    return glm::vec3(sz * c * r, sz * s * r, cz * r);
+}
+
+void EmitterSphere::sample(Vec3Span<float> const & points, RngStream & rng) const
+{
+    sampleVolume<3>(*this, points, rng);
+}
+
 //! @param	size	Width, height, and depth of the box.
 
 EmitterBox::EmitterBox(glm::vec3 const & size)
-    : randomX_(-0.5f * size.x, 0.5f * size.x)
-    , randomY_(-0.5f * size.y, 0.5f * size.y)
-    , randomZ_(-0.5f * size.z, 0.5f * size.z)
+    : size_(size)
+{
+}
 
+glm::vec3 EmitterBox::point(float u, float v, float w) const
 {
+    return size_ * (glm::vec3(u, v, w) - 0.5f);
 }
 
-glm::vec3 EmitterBox::operator ()(std::minstd_rand & rng) const
+void EmitterBox::sample(Vec3Span<float> const & points, RngStream & rng) const
 {
-    return glm::vec3(randomX_(rng), randomY_(rng), randomZ_(rng));
+    sampleVolume<3>(*this, points, rng);
 }
 
-//! @param	rng     Random number generator.
 //! @param	radius	Radius of the cylinder.
 //! @param	height	Height of the cylinder.
 
 EmitterCylinder::EmitterCylinder(float radius, float height)
-    : randomAngle_(0.0f, glm::two_pi<float>())
-    , randomR_(0.0f, radius * radius)
-    , randomZ_(-0.5f * height, 0.5f * height)
-
+    : radius_(radius)
+    , height_(height)
 {
 }
 
-glm::vec3 EmitterCylinder::operator ()(std::minstd_rand & rng) const
+glm::vec3 EmitterCylinder::point(float u, float v, float w) const
 {
-    float a = randomAngle_(rng);
-    float c = cos(a);
-    float s = sqrt(1.0f - c * c);
-    float z = randomZ_(rng);
-    float r = sqrt(randomR_(rng));
+    float c;
+    float s;
+    cosSin(v, c, s);
+    float r = radius_ * std::sqrt(u);
+    return glm::vec3(c * r, s * r, height_ * (w - 0.5f));
+}
 
-    return glm::vec3(c * r, s * r, z);
+void EmitterCylinder::sample(Vec3Span<float> const & points, RngStream & rng) const
+{
+    sampleVolume<3>(*this, points, rng);
 }
 
-//! @param	rng     Random number generator.
 //! @param	radius	Radius of the cone at the base.
 //! @param	height	Height of the cone.
 
 EmitterCone::EmitterCone(float radius, float height)
-    : randomAngle_(0.0f, glm::two_pi<float>())
-    , randomZ_(0.0f, height * height * height)
-    , randomR_(0.0f, 1.0f / radius / radius)
-
+    : radius_(radius)
+    , height_(height)
 {
 }
 
-glm::vec3 EmitterCone::operator ()(std::minstd_rand & rng) const
+glm::vec3 EmitterCone::point(float u, float v, float w) const
 {
-    float a = randomAngle_(rng);
-    float c = cos(a);
-    float s = sqrt(1.0f - c * c);
-    float z = pow(randomZ_(rng), 1.0f / 3.0f);
-    float r = sqrt(randomR_(rng)) * z;
+    // The cross-section at height z has an area proportional to z * z, so z is the cube root of a uniform value
+    float t = cubeRoot(w);
+    float c;
+    float s;
+    cosSin(v, c, s);
+    float r = radius_ * t * std::sqrt(u);
+    return glm::vec3(c * r, s * r, height_ * t);
+}
 
-    return glm::vec3(c * r, s * r, z);
+void EmitterCone::sample(Vec3Span<float> const & points, RngStream & rng) const
+{
+    sampleVolume<3>(*this, points, rng);
 }
 } // namespace Confetti
@@ -7,7 +7,6 @@
 #include <glm/gtx/norm.hpp>
 
 #include <cassert>
-#include <random>
 
 namespace Confetti
 {
@@ -28,12 +27,40 @@ Environment::Environment(glm::vec3 const &   gravity /*= { 0.0f, 0.0f, 0.0f }*/,
     , windVelocity_(windVelocity)
     , airFriction_(friction)
     , gustiness_(gustiness)
-    , surfaces_(bpl)
-    , clippers_(cpl)
     , gust_({ 0.0f, 0.0f, 0.0f })
     , currentWindVelocity_(windVelocity)
-    , rng_(std::random_device()())
+    , terminalVelocity_({ 0.0f, 0.0f, 0.0f })
+    , terminalDistance_({ 0.0f, 0.0f, 0.0f })
+    , ect1_(0.0f)
+    , time_(0.0f)
+    , rng_()
 {
+    setSurfaces(bpl);
+    setClippers(cpl);
+}
+
+//! @param  bpl     List of surfaces
+
+void Environment::setSurfaces(SurfaceList const & bpl)
+{
+    surfaces_ = bpl;
+    surfacePlanes_.clear();
+    for (auto const & surface : surfaces_)
+    {
+        surfacePlanes_.add(surface.plane, surface.dampening);
+    }
+}
+
+//! @param  cpl     List of clip planes
+
+void Environment::setClippers(ClipperList const & cpl)
+{
+    clippers_ = cpl;
+    clipperPlanes_.clear();
+    for (auto const & clipper : clippers_)
+    {
+        clipperPlanes_.add(clipper);
+    }
 }
 
 //! @param	dt		Amount of time (in seconds) passed since the last update.
@@ -62,5 +89,7 @@ void Environment::update(float dt)
         terminalDistance_ = { 0.0f, 0.0f, 0.0f };
         ect1_ = 0.0f;
     }
+
+    time_ += dt;
 }
 } // namespace Confetti
@@ -0,0 +1,60 @@
+#include "Frustum.h"
+
+#include "BoundingBox.h"
+
+namespace Confetti
+{
+//! @param  viewProjection  The camera's view-projection matrix
+
+Frustum::Frustum(glm::mat4 const & viewProjection)
+{
+    // Source: Gribb & Hartmann, "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix"
+
+    glm::vec4 row[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        row[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    }
+
+    planes_[0] = row[3] + row[0];
+    planes_[1] = row[3] - row[0];
+    planes_[2] = row[3] + row[1];
+    planes_[3] = row[3] - row[1];
+    planes_[4] = row[3] + row[2];
+    planes_[5] = row[3] - row[2];
+}
+
+//! @param  p   The point to test
+
+bool Frustum::contains(glm::vec3 const & p) const
+{
+    for (glm::vec4 const & plane : planes_)
+    {
+        if (glm::dot(glm::vec3(plane), p) + plane.w < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+//! @param  box     The box to test
+//!
+//! The test is conservative. A box that is outside the frustum but not entirely behind any one of its planes is
+//! reported as intersecting.
+
+bool Frustum::intersects(BoundingBox const & box) const
+{
+    if (box.empty())
+        return false;
+
+    for (glm::vec4 const & plane : planes_)
+    {
+        // The corner of the box farthest in front of the plane
+        glm::vec3 corner(plane.x >= 0.0f ? box.max.x : box.min.x,
+                         plane.y >= 0.0f ? box.max.y : box.min.y,
+                         plane.z >= 0.0f ? box.max.z : box.min.z);
+        if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+            return false;
+    }
+    return true;
+}
+} // namespace Confetti
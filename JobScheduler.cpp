@@ -0,0 +1,170 @@
+#include "JobScheduler.h"
+
+#include <algorithm>
+
+namespace
+{
+// The scheduler whose job this thread is running, if any
+thread_local Confetti::JobScheduler const * tRunning = nullptr;
+} // anonymous namespace
+
+namespace Confetti
+{
+//! @param  threads     Number of threads to run the jobs, including the calling thread. If 0, the number of hardware
+//!                     threads is used.
+
+JobScheduler::JobScheduler(unsigned threads /*= 0*/)
+{
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    queues_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i)
+    {
+        queues_.emplace_back(std::make_unique<Queue>());
+    }
+
+    threads_.reserve(threads - 1);
+    for (unsigned i = 1; i < threads; ++i)
+    {
+        threads_.emplace_back(&JobScheduler::work, this, i);
+    }
+}
+
+JobScheduler::~JobScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto & thread : threads_)
+    {
+        thread.join();
+    }
+}
+
+//! @param  count   Number of jobs
+//! @param  job     Function called for each job
+
+void JobScheduler::run(size_t count, Job const & job)
+{
+    if (count == 0)
+        return;
+
+    // With only one thread, just run the jobs in order. The jobs of a job are also run in order, since the threads are
+    // busy with the current batch.
+
+    if (threads_.empty() || tRunning == this)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            job(i);
+        }
+        return;
+    }
+
+    job_       = &job;
+    remaining_ = count;
+
+    // Give each thread an equal share of the jobs
+
+    size_t const n = queues_.size();
+    for (size_t q = 0; q < n; ++q)
+    {
+        std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+        for (size_t i = q * count / n; i < (q + 1) * count / n; ++i)
+        {
+            queues_[q]->jobs.push_back(i);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    // Help out and then wait for the workers to finish
+
+    while (execute(0))
+    {
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] () { return remaining_ == 0; });
+    job_ = nullptr;
+}
+
+// Main function of a worker thread
+void JobScheduler::work(unsigned id)
+{
+    uint64_t seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this, seen] () { return quit_ || generation_ != seen; });
+            if (quit_)
+                return;
+            seen = generation_;
+        }
+
+        while (execute(id))
+        {
+        }
+    }
+}
+
+// Runs one job, taken from the thread's own queue or stolen from another thread's queue. Returns false if there are
+// no jobs left.
+bool JobScheduler::execute(unsigned id)
+{
+    size_t const n = queues_.size();
+    size_t       index;
+    bool         found = false;
+
+    // Take the last job in this thread's queue
+
+    {
+        Queue & own = *queues_[id];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty())
+        {
+            index = own.jobs.back();
+            own.jobs.pop_back();
+            found = true;
+        }
+    }
+
+    // Otherwise, steal the first job in another thread's queue
+
+    for (size_t k = 1; !found && k < n; ++k)
+    {
+        Queue & victim = *queues_[(id + k) % n];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty())
+        {
+            index = victim.jobs.front();
+            victim.jobs.pop_front();
+            found = true;
+        }
+    }
+
+    if (!found)
+        return false;
+
+    JobScheduler const * outer = tRunning;
+    tRunning = this;
+    (*job_)(index);
+    tRunning = outer;
+
+    if (--remaining_ == 0)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_.notify_all();
+    }
+    return true;
+}
+} // namespace Confetti
@@ -174,6 +174,9 @@ static void from_json(json const & j, Configuration::Environment & environment)
     if (j.contains("windVelocity")) j.at("windVelocity").get_to(environment.windVelocity_);
     if (j.contains("gustiness")) j.at("gustiness").get_to(environment.gustiness_);
     if (j.contains("airFriction")) j.at("airFriction").get_to(environment.airFriction_);
+    if (j.contains("turbulenceFrequency")) j.at("turbulenceFrequency").get_to(environment.turbulenceFrequency_);
+    if (j.contains("turbulenceAmplitude")) j.at("turbulenceAmplitude").get_to(environment.turbulenceAmplitude_);
+    if (j.contains("turbulenceScroll")) j.at("turbulenceScroll").get_to(environment.turbulenceScroll_);
     if (j.contains("surface")) j.at("surface").get_to(environment.surface_);
     if (j.contains("clip")) j.at("clip").get_to(environment.clip_);
 }
@@ -186,6 +189,9 @@ static void to_json(json & j, Configuration::Environment const & environment)
         { "windVelocity", environment.windVelocity_ },
         { "gustiness", environment.gustiness_ },
         { "airFriction", environment.airFriction_ },
+        { "turbulenceFrequency", environment.turbulenceFrequency_ },
+        { "turbulenceAmplitude", environment.turbulenceAmplitude_ },
+        { "turbulenceScroll", environment.turbulenceScroll_ },
         { "surface", environment.surface_ },
         { "clip", environment.clip_ }
     };
@@ -204,6 +210,7 @@ static void from_json(json const & j, Configuration::EmitterVolume & volume)
     if (j.contains("height")) j.at("height").get_to(volume.height_);
     if (j.contains("depth")) j.at("depth").get_to(volume.depth_);
     if (j.contains("radius")) j.at("radius").get_to(volume.radius_);
+    if (j.contains("samples")) j.at("samples").get_to(volume.samples_);
 }
 
 static void to_json(json & j, Configuration::EmitterVolume const & volume)
@@ -215,7 +222,8 @@ static void to_json(json & j, Configuration::EmitterVolume const & volume)
         { "width", volume.width_ },
         { "height", volume.height_ },
         { "depth", volume.depth_ },
-        { "radius", volume.radius_ }
+        { "radius", volume.radius_ },
+        { "samples", volume.samples_ }
     };
 }
 
@@ -233,6 +241,8 @@ static void from_json(json const & j, Configuration::Emitter & emitter)
     if (j.contains("minSpeed")) j.at("minSpeed").get_to(emitter.minSpeed_);
     if (j.contains("maxSpeed")) j.at("maxSpeed").get_to(emitter.maxSpeed_);
     if (j.contains("count")) j.at("count").get_to(emitter.count_);
+    if (j.contains("looping")) j.at("looping").get_to(emitter.looping_);
+    if (j.contains("rate")) j.at("rate").get_to(emitter.rate_);
     if (j.contains("lifetime")) j.at("lifetime").get_to(emitter.lifetime_);
     if (j.contains("spread")) j.at("spread").get_to(emitter.spread_);
     if (j.contains("color")) j.at("color").get_to(emitter.color_);
@@ -255,6 +265,8 @@ static void to_json(json & j, Configuration::Emitter const & emitter)
         { "minSpeed", emitter.minSpeed_ },
         { "maxSpeed", emitter.maxSpeed_ },
         { "count", emitter.count_ },
+        { "looping", emitter.looping_ },
+        { "rate", emitter.rate_ },
         { "lifetime", emitter.lifetime_ },
         { "spread", emitter.spread_ },
         { "color", emitter.color_ },
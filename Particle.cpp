@@ -1,10 +1,5 @@
 #include "Particle.h"
 
-#include "Appearance.h"
-#include "Emitter.h"
-#include "Environment.h"
-
-#include <glm/geometric.hpp>
 #include <glm/glm.hpp>
 
 namespace Confetti
@@ -13,20 +8,17 @@ namespace Confetti
 //! @param	age				Initial age.
 //! @param	position		Position at birth.
 //! @param	velocity		Velocity at birth.
+//! @param	color			Color at birth
 
 Particle::Particle(float             lifetime,
                    float             age,
                    glm::vec3 const & position,
                    glm::vec3 const & velocity,
                    glm::vec4 const & color)
-    : emitter_(nullptr)
-    , lifetime_(lifetime)
+    : lifetime_(lifetime)
     , age_(age)
-    , initialPosition_(position)
-    , initialVelocity_(velocity)
     , position_(position)
     , velocity_(velocity)
-    , initialColor_(color)
     , color_(color)
 {
 }
@@ -43,137 +35,13 @@ void Particle::initialize(float             lifetime,
                           glm::vec3 const & velocity,
                           glm::vec4 const & color)
 {
-    lifetime_        = lifetime;
-    age_             = age;
-    initialPosition_ = position;
-    initialVelocity_ = velocity;
-    initialColor_    = color;
-
+    lifetime_ = lifetime;
+    age_      = age;
     position_ = position;
     velocity_ = velocity;
     color_    = color;
 }
 
-//! @param	dt	The amount of time that has passed since the last update.
-//!
-//! @note	Methods overriding this method must call this first in order to determine the particle's age and if it
-//!			has been reborn or not.
-
-bool Particle::update(float dt)
-{
-    bool reborn;
-
-    age_ += dt;
-
-    // If the particle has not been born yet then do nothing
-
-    if (age_ < 0.0f)
-        return false;
-
-    // See if the particle is (re)born this frame
-
-    if (age_ < dt)
-    {
-        reborn = true;
-    }
-    else if (age_ >= lifetime_)
-    {
-        age_  -= lifetime_;
-        reborn = true;
-    }
-    else
-    {
-        reborn = false;
-    }
-
-    glm::vec3 velocity = velocity_;
-    glm::vec3 position = position_;
-    glm::vec4 color    = color_;
-
-    // If (re)born, then reset to initial values and adjust dt
-
-    if (reborn)
-    {
-        glm::vec3 emitterVelocity = emitter_->currentVelocity();
-        glm::vec3 emitterPosition = emitter_->currentPosition();
-        glm::vec3 initialVelocity = initialVelocity_;
-        glm::vec3 initialPosition = initialPosition_;
-
-        velocity = emitterVelocity + initialVelocity;
-        position = emitterPosition + initialPosition;
-        color    = initialColor_;
-        dt       = age_;
-    }
-
-    Environment const * pE = emitter_->environment().get();
-    Appearance const *  pA = emitter_->appearance().get();
-
-    // Update velocity and position
-    glm::vec3 dv;
-    glm::vec3 ds;
-    float     c = pE->airFriction();
-    glm::vec3 g = pE->gravity();
-
-    if (c != 0.0f)
-    {
-        glm::vec3 terminalVelocity = pE->terminalVelocity();
-        glm::vec3 terminalDistance = pE->terminalDistance();
-        float     ect1 = pE->ect1();
-
-        dv = (terminalVelocity - velocity) * ect1;
-        ds = terminalDistance - dv / c;
-    }
-    else
-    {
-        dv = g * dt;
-        ds = (velocity + dv * 0.5f) * dt;
-    }
-
-    velocity += dv;
-    position += ds;
-
-    // Check for collision with clip planes
-    Environment::ClipperList const & clippers = pE->clippers();
-    if (!clippers.empty())
-    {
-        for (auto const & clip : clippers)
-        {
-            if (glm::dot(clip, glm::vec4(position.x, position.y, position.z, 0.0f)) < 0.0f)
-            {
-                age_ -= lifetime_;
-                return reborn;
-            }
-        }
-    }
-
-    // Check for collision with surfaces
-    Environment::SurfaceList const & surfaces = pE->surfaces();
-    if (!surfaces.empty())
-    {
-        for (auto const & surface : surfaces)
-        {
-            glm::vec4 const & plane = surface.plane;
-            if (glm::dot(plane, glm::vec4(position.x, position.y, position.z, 0.0f)) < 0.0f)
-            {
-                glm::vec3 normal(plane);
-                float     f = 1.0f + surface.dampening;
-                velocity -= normal * (f * glm::dot(normal, velocity));
-                position -= normal * (f * glm::dot(plane, glm::vec4(position, 1.0f)));
-            }
-        }
-    }
-
-    // Update color
-    color += pA->colorRate * dt;
-    color  =  glm::clamp(color,  glm::zero<glm::vec4>(),  glm::one<glm::vec4>());
-
-    velocity_ = velocity;
-    position_ = position;
-    color_    = color;
-
-    return reborn;
-}
-
 // glm::vec3 Particle::Color() const
 // {
 //	float	r	= glm::limit( 0., initialColor_.R_ + colorDelta_.R_ * age_, 1. );
@@ -0,0 +1,102 @@
+#include "ParticleEventRing.h"
+
+#include <cassert>
+
+namespace Confetti
+{
+//! @param  capacity    Maximum number of events waiting to be drained
+
+ParticleEventRing::ParticleEventRing(size_t capacity)
+    : mask_(0)
+    , head_(0)
+    , tail_(0)
+    , dropped_(0)
+{
+    assert(capacity > 0);
+    size_t size = 1;
+    while (size < capacity)
+    {
+        size *= 2;
+    }
+
+    slots_.reset(new Slot[size]);
+    mask_ = size - 1;
+
+    // A slot at position p may be pushed when its sequence is p, and popped when its sequence is p + 1
+    for (size_t i = 0; i < size; ++i)
+    {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+//! @param  event   The event to record
+//!
+//! @return     true if the event was recorded, false if the ring is full
+
+bool ParticleEventRing::push(ParticleEvent const & event)
+{
+    size_t position = head_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Slot &    slot     = slots_[position & mask_];
+        size_t    sequence = slot.sequence.load(std::memory_order_acquire);
+        ptrdiff_t diff     = (ptrdiff_t)sequence - (ptrdiff_t)position;
+        if (diff == 0)
+        {
+            // The slot is free. Claim it unless another thread got it first.
+            if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                slot.event = event;
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The slot still holds an event from the previous lap, so the ring is full
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            // Another thread claimed the slot
+            position = head_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+//! @param  event   Receives the event
+//!
+//! @return     true if an event was removed, false if there are no events
+
+bool ParticleEventRing::pop(ParticleEvent & event)
+{
+    Slot & slot     = slots_[tail_ & mask_];
+    size_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != tail_ + 1)
+        return false;
+
+    event = slot.event;
+    slot.sequence.store(tail_ + mask_ + 1, std::memory_order_release);
+    ++tail_;
+    return true;
+}
+
+//! @param  events  The events are appended to this list
+//!
+//! @return     number of events removed
+//!
+//! Events recorded while draining may or may not be removed.
+
+size_t ParticleEventRing::drain(std::vector<ParticleEvent> & events)
+{
+    size_t        count = 0;
+    ParticleEvent event;
+    while (pop(event))
+    {
+        events.push_back(event);
+        ++count;
+    }
+    return count;
+}
+} // namespace Confetti
@@ -0,0 +1,611 @@
+#include "ParticleKernel.h"
+
+#include "ParticleEventRing.h"
+#include "ParticleKernelImpl.h"
+#include "ParticleStore.h"
+#include "PlaneSet.h"
+#include "Turbulence.h"
+#include "UpdateContext.h"
+#include "WindField.h"
+
+#include <glm/geometric.hpp>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#if defined(CONFETTI_SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace Confetti::ParticleKernelImpl;
+
+static_assert((int)EVENT_BIRTH == (int)Confetti::ParticleEvent::BIRTH &&
+                  (int)EVENT_CLIP == (int)Confetti::ParticleEvent::CLIP &&
+                  (int)EVENT_BOUNCE == (int)Confetti::ParticleEvent::BOUNCE,
+              "The kernels' event flags must match the event types");
+
+namespace
+{
+Confetti::ParticleKernel::InstructionSet detectInstructionSet()
+{
+    using InstructionSet = Confetti::ParticleKernel::InstructionSet;
+
+#if defined(CONFETTI_SIMD_X86)
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int const maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    bool const sse2    = (info[3] & (1 << 26)) != 0;
+    bool const osxsave = (info[2] & (1 << 27)) != 0;
+    bool const avx     = (info[2] & (1 << 28)) != 0;
+
+    // The OS must save the vector registers in order to use AVX or AVX-512
+    unsigned long long const xcr0 = osxsave ? _xgetbv(0) : 0;
+    bool const osAvx    = (xcr0 & 0x06) == 0x06;
+    bool const osAvx512 = (xcr0 & 0xe6) == 0xe6;
+
+    bool avx2    = false;
+    bool avx512f = false;
+    if (maxLeaf >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        avx2    = (info[1] & (1 << 5)) != 0;
+        avx512f = (info[1] & (1 << 16)) != 0;
+    }
+
+    if (avx512f && osAvx512)
+        return InstructionSet::AVX512;
+    if (avx2 && avx && osAvx)
+        return InstructionSet::AVX2;
+    if (sse2)
+        return InstructionSet::SSE2;
+#else // defined(_MSC_VER)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return InstructionSet::AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return InstructionSet::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return InstructionSet::SSE2;
+#endif // defined(_MSC_VER)
+#endif // defined(CONFETTI_SIMD_X86)
+
+    return InstructionSet::SCALAR;
+}
+
+Confetti::ParticleKernel::InstructionSet const supported_ = detectInstructionSet();
+Confetti::ParticleKernel::InstructionSet       selected_  = supported_;
+
+// Returns the coefficient arrays of a plane set
+Planes planes(Confetti::PlaneSet const & set)
+{
+    static_assert(Planes::PACKET_SIZE == Confetti::PlaneSet::PACKET_SIZE, "The plane packets must be the same size");
+    return { set.a(), set.b(), set.c(), set.d(), set.dampenings(), set.size() };
+}
+
+// Returns the smallest value of a * x + b * y + c * z over a set of planes, which is negative if the point is behind any
+// of the planes. The planes are tested a packet at a time without branches so that the loop can be vectorized. The
+// null planes padding the last packet give 0, which does not affect the result.
+float nearest(Planes const & planes, glm::vec3 const & p)
+{
+    float  result = std::numeric_limits<float>::max();
+    size_t padded = (planes.count + Planes::PACKET_SIZE - 1) / Planes::PACKET_SIZE * Planes::PACKET_SIZE;
+    for (size_t j = 0; j < padded; j += Planes::PACKET_SIZE)
+    {
+        float distance[Planes::PACKET_SIZE];
+        for (size_t l = 0; l < Planes::PACKET_SIZE; ++l)
+        {
+            distance[l] = planes.a[j + l] * p.x + planes.b[j + l] * p.y + planes.c[j + l] * p.z;
+        }
+        for (size_t l = 0; l < Planes::PACKET_SIZE; ++l)
+        {
+            result = std::min(result, distance[l]);
+        }
+    }
+    return result;
+}
+
+// The reference implementation. The vectorized kernels are translations of this function.
+void updateScalar(Streams const & s, Constants const & k, size_t begin, size_t end)
+{
+    glm::vec3 const emitterPosition(k.emitterPosition[0], k.emitterPosition[1], k.emitterPosition[2]);
+    glm::vec3 const emitterVelocity(k.emitterVelocity[0], k.emitterVelocity[1], k.emitterVelocity[2]);
+    glm::vec3 const gravity(k.gravity[0], k.gravity[1], k.gravity[2]);
+    glm::vec3 const terminalVelocity(k.terminalVelocity[0], k.terminalVelocity[1], k.terminalVelocity[2]);
+    glm::vec3 const terminalDistance(k.terminalDistance[0], k.terminalDistance[1], k.terminalDistance[2]);
+    glm::vec4 const colorRate(k.colorRate[0], k.colorRate[1], k.colorRate[2], k.colorRate[3]);
+    float const     c = k.airFriction;
+    bool const      windy = s.wind[0] != nullptr;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        bool  reborn;
+        float lifetime = s.lifetime[i];
+        float age      = s.age[i] + k.dt;
+        float pdt      = k.dt;
+
+        // If the particle has not been born yet then do nothing
+
+        if (age < 0.0f)
+        {
+            s.age[i] = age;
+            if (s.events)
+                s.events[i] = 0;
+            continue;
+        }
+
+        // See if the particle is (re)born this frame
+
+        if (age < pdt)
+        {
+            reborn = true;
+        }
+        else if (age >= lifetime)
+        {
+            age   -= lifetime;
+            reborn = true;
+        }
+        else
+        {
+            reborn = false;
+        }
+
+        glm::vec3 velocity;
+        glm::vec3 position;
+        glm::vec4 color;
+
+        // If (re)born, then reset to initial values and adjust dt
+
+        if (reborn)
+        {
+            velocity = emitterVelocity +
+                       glm::vec3(s.initialVelocity[0][i], s.initialVelocity[1][i], s.initialVelocity[2][i]);
+            position = emitterPosition +
+                       glm::vec3(s.initialPosition[0][i], s.initialPosition[1][i], s.initialPosition[2][i]);
+            color = glm::vec4(s.initialColor[0][i], s.initialColor[1][i], s.initialColor[2][i], s.initialColor[3][i]);
+            pdt   = age;
+        }
+        else
+        {
+            velocity = glm::vec3(s.velocity[0][i], s.velocity[1][i], s.velocity[2][i]);
+            position = glm::vec3(s.position[0][i], s.position[1][i], s.position[2][i]);
+            color    = glm::vec4(s.color[0][i], s.color[1][i], s.color[2][i], s.color[3][i]);
+        }
+
+        // Update velocity and position
+        glm::vec3 dv;
+        glm::vec3 ds;
+
+        if (c != 0.0f)
+        {
+            glm::vec3 vt = terminalVelocity;
+            glm::vec3 st = terminalDistance;
+            if (windy)
+            {
+                glm::vec3 wind(s.wind[0][i], s.wind[1][i], s.wind[2][i]);
+                vt += wind;
+                st += wind * k.dt;
+            }
+            dv = (vt - velocity) * k.ect1;
+            ds = st - dv / c;
+        }
+        else
+        {
+            dv = gravity * pdt;
+            ds = (velocity + dv * 0.5f) * pdt;
+        }
+
+        velocity += dv;
+        position += ds;
+
+        // Check for collision with clip planes
+
+        bool clipped = k.clippers.count > 0 && nearest(k.clippers, position) < 0.0f;
+        if (clipped)
+            age -= lifetime;
+
+        bool bounced = false;
+
+        if (!clipped)
+        {
+            // Check for collision with surfaces. The surfaces are only checked one at a time if the particle is behind
+            // at least one of them.
+            if (k.surfaces.count > 0 && nearest(k.surfaces, position) < 0.0f)
+            {
+                for (size_t j = 0; j < k.surfaces.count; ++j)
+                {
+                    glm::vec3 normal(k.surfaces.a[j], k.surfaces.b[j], k.surfaces.c[j]);
+                    if (glm::dot(normal, position) < 0.0f)
+                    {
+                        bounced = true;
+                        float f = 1.0f + k.surfaces.dampening[j];
+                        velocity -= normal * (f * glm::dot(normal, velocity));
+                        position -= normal * (f * (glm::dot(normal, position) + k.surfaces.d[j]));
+                    }
+                }
+            }
+
+            // Update color
+            color += colorRate * pdt;
+            color  = glm::clamp(color, glm::zero<glm::vec4>(), glm::one<glm::vec4>());
+
+            for (int j = 0; j < 4; ++j)
+            {
+                s.color[j][i] = color[j];
+            }
+        }
+
+        // A clipped particle is not drawn again until it is reborn, but its position and velocity are kept to show
+        // where it was clipped.
+        for (int j = 0; j < 3; ++j)
+        {
+            s.velocity[j][i] = velocity[j];
+            s.position[j][i] = position[j];
+        }
+        s.age[i] = age;
+
+        if (s.events)
+        {
+            s.events[i] = (unsigned char)((reborn ? EVENT_BIRTH : 0) | (clipped ? EVENT_CLIP : 0) |
+                                          (bounced ? EVENT_BOUNCE : 0));
+        }
+
+        // Update size and rotation
+
+        if (s.radius)
+        {
+            float radius = reborn ? s.initialRadius[i] : s.radius[i];
+            s.radius[i] = radius + pdt * k.radiusRate;
+        }
+
+        if (s.rotation)
+        {
+            float rotation = reborn ? s.initialRotation[i] : s.rotation[i];
+            s.rotation[i] = rotation + pdt * k.angularVelocity;
+        }
+
+        // Update the location of the tail
+
+        if (s.tail[0])
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                s.tail[j][i] = s.position[j][i] - s.velocity[j][i] * pdt;
+            }
+        }
+    }
+}
+} // anonymous namespace
+
+namespace Confetti
+{
+//! @param	particles	The particles to update.
+//! @param	begin		Index of the first particle to update.
+//! @param	end			Index of the particle following the last particle to update.
+//! @param	context		Values shared by all the particles during this update.
+//! @param	events		If not null, receives the events of each particle in the range (optional)
+//!
+//! The optional radius, rotation, and tail streams are updated if the store has them. As many particles as possible
+//! are updated by the selected vectorized kernel and the rest are updated by the scalar kernel.
+
+void ParticleKernel::update(ParticleStore &       particles,
+                            size_t                begin,
+                            size_t                end,
+                            UpdateContext const & context,
+                            uint8_t *             events /*= nullptr*/)
+{
+    Range const range = { begin, end, &context };
+    update(particles, &range, 1, events);
+}
+
+//! @param	particles	The particles to update.
+//! @param	ranges		The ranges of particles to update, and the context of each one.
+//! @param	count		Number of ranges.
+//! @param	events		If not null, receives the events of each particle from the start of the first range (optional)
+//!
+//! The streams, the wind buffers, and the constants that don't depend on the emitter are set up once for all the
+//! ranges. Each range starts a new pass of the vectorized kernel, so the particles of one emitter are never in the
+//! same block as the particles of another.
+
+void ParticleKernel::update(ParticleStore & particles,
+                            Range const *   ranges,
+                            size_t          count,
+                            uint8_t *       events /*= nullptr*/)
+{
+    if (count == 0)
+        return;
+
+    size_t const begin = ranges[0].begin;
+    size_t const end   = ranges[count - 1].end;
+    assert(begin <= end && end <= particles.size());
+    if (begin == end)
+        return;
+
+    // The streams start at the first particle to update, so that the wind, which is only sampled for these particles,
+    // is indexed the same way as the rest.
+
+    size_t const n = end - begin;
+
+    Streams s;
+    s.lifetime = particles.lifetimes().data() + begin;
+    s.age      = particles.ages().data() + begin;
+    s.initialPosition[0] = particles.initialPositions().x.data() + begin;
+    s.initialPosition[1] = particles.initialPositions().y.data() + begin;
+    s.initialPosition[2] = particles.initialPositions().z.data() + begin;
+    s.initialVelocity[0] = particles.initialVelocities().x.data() + begin;
+    s.initialVelocity[1] = particles.initialVelocities().y.data() + begin;
+    s.initialVelocity[2] = particles.initialVelocities().z.data() + begin;
+    s.initialColor[0]    = particles.initialColors().x.data() + begin;
+    s.initialColor[1]    = particles.initialColors().y.data() + begin;
+    s.initialColor[2]    = particles.initialColors().z.data() + begin;
+    s.initialColor[3]    = particles.initialColors().w.data() + begin;
+    s.position[0]        = particles.positions().x.data() + begin;
+    s.position[1]        = particles.positions().y.data() + begin;
+    s.position[2]        = particles.positions().z.data() + begin;
+    s.velocity[0]        = particles.velocities().x.data() + begin;
+    s.velocity[1]        = particles.velocities().y.data() + begin;
+    s.velocity[2]        = particles.velocities().z.data() + begin;
+    s.color[0]           = particles.colors().x.data() + begin;
+    s.color[1]           = particles.colors().y.data() + begin;
+    s.color[2]           = particles.colors().z.data() + begin;
+    s.color[3]           = particles.colors().w.data() + begin;
+
+    bool const hasRadius   = particles.has(ParticleStore::RADIUS);
+    bool const hasRotation = particles.has(ParticleStore::ROTATION);
+    bool const hasTail     = particles.has(ParticleStore::TAIL);
+    s.initialRadius   = hasRadius ? particles.initialRadii().data() + begin : nullptr;
+    s.radius          = hasRadius ? particles.radii().data() + begin : nullptr;
+    s.initialRotation = hasRotation ? particles.initialRotations().data() + begin : nullptr;
+    s.rotation        = hasRotation ? particles.rotations().data() + begin : nullptr;
+    s.tail[0]         = hasTail ? particles.tails().x.data() + begin : nullptr;
+    s.tail[1]         = hasTail ? particles.tails().y.data() + begin : nullptr;
+    s.tail[2]         = hasTail ? particles.tails().z.data() + begin : nullptr;
+    s.events          = events;
+
+    // The wind field and turbulence only affect particles if there is air friction. They are sampled at the positions
+    // before the update. The contexts share an environment, so the wind is the same for all the ranges.
+
+    UpdateContext const & shared = *ranges[0].context;
+
+    static thread_local std::vector<float> wind[3];
+    s.wind[0] = s.wind[1] = s.wind[2] = nullptr;
+    WindField const *  windField  = shared.windField();
+    Turbulence const * turbulence = shared.turbulence();
+    if ((windField || turbulence) && shared.airFriction() != 0.0f)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            wind[c].resize(n);
+            s.wind[c] = wind[c].data();
+        }
+
+        for (size_t r = 0; r < count; ++r)
+        {
+            size_t const first = ranges[r].begin - begin;
+            size_t const size  = ranges[r].end - ranges[r].begin;
+
+            Vec3Span<float const> positions = particles.positions().subspan(ranges[r].begin, size);
+            Vec3Span<float>       velocities = Vec3Span<float>{ wind[0], wind[1], wind[2] }.subspan(first, size);
+            if (windField)
+            {
+                windField->sample(positions, velocities);
+            }
+            else
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    std::fill(wind[c].begin() + first, wind[c].begin() + first + size, 0.0f);
+                }
+            }
+            if (turbulence)
+                turbulence->addVelocities(positions, shared.time(), velocities);
+        }
+    }
+
+    glm::vec3 const gravity          = shared.gravity();
+    glm::vec3 const terminalVelocity = shared.terminalVelocity();
+    glm::vec3 const terminalDistance = shared.terminalDistance();
+    glm::vec4 const colorRate        = shared.colorRate();
+
+    Constants k;
+    k.dt = shared.dt();
+    for (int c = 0; c < 3; ++c)
+    {
+        k.gravity[c]          = gravity[c];
+        k.terminalVelocity[c] = terminalVelocity[c];
+        k.terminalDistance[c] = terminalDistance[c];
+    }
+    k.airFriction = shared.airFriction();
+    k.ect1        = shared.ect1();
+    for (int c = 0; c < 4; ++c)
+    {
+        k.colorRate[c] = colorRate[c];
+    }
+    k.radiusRate      = shared.radiusRate();
+    k.angularVelocity = shared.angularVelocity();
+
+    // Only the emitter and the planes differ between the ranges. An emitter skips the planes if its particles can't
+    // reach them.
+
+    for (size_t r = 0; r < count; ++r)
+    {
+        UpdateContext const & context = *ranges[r].context;
+        assert(r == 0 || ranges[r - 1].end <= ranges[r].begin);
+        assert(context.dt() == k.dt);
+
+        glm::vec3 const emitterPosition = context.emitterPosition();
+        glm::vec3 const emitterVelocity = context.emitterVelocity();
+        for (int c = 0; c < 3; ++c)
+        {
+            k.emitterPosition[c] = emitterPosition[c];
+            k.emitterVelocity[c] = emitterVelocity[c];
+        }
+        k.clippers = planes(context.clippers());
+        k.surfaces = planes(context.surfaces());
+
+        size_t const rangeBegin = ranges[r].begin - begin;
+        size_t const rangeEnd   = ranges[r].end - begin;
+        size_t       first      = rangeBegin;
+        switch (selected_)
+        {
+            case InstructionSet::AVX512: first = updateAvx512(s, k, rangeBegin, rangeEnd); break;
+            case InstructionSet::AVX2:   first = updateAvx2(s, k, rangeBegin, rangeEnd); break;
+            case InstructionSet::SSE2:   first = updateSse2(s, k, rangeBegin, rangeEnd); break;
+            default:                     break;
+        }
+
+        updateScalar(s, k, first, rangeEnd);
+    }
+}
+
+//! @param	particles	The particles to update.
+//! @param	begin		Index of the first particle to update.
+//! @param	end			Index of the particle following the last particle to update.
+//! @param	context		Values shared by all the particles during this update.
+//!
+//! A particle that reaches the end of its life is reborn. If it has lived several lifetimes since the last update, the
+//! extra lifetimes are dropped.
+
+void ParticleKernel::advance(ParticleStore & particles, size_t begin, size_t end, UpdateContext const & context)
+{
+    assert(begin <= end && end <= particles.size());
+
+    float const *   lifetimes = particles.lifetimes().data();
+    float *         ages      = particles.ages().data();
+    float const     dt        = context.dt();
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        float age = ages[i] + dt;
+        if (age >= lifetimes[i])
+            age = std::fmod(age, lifetimes[i]);
+        ages[i] = age;
+    }
+}
+
+//! @param	particles	The particles to evaluate.
+//! @param	begin		Index of the first particle to evaluate.
+//! @param	end			Index of the particle following the last particle to evaluate.
+//! @param	context		Values shared by all the particles during this update.
+//!
+//! The particles are assumed to have been emitted from the emitter position in the context, with the emitter velocity
+//! in the context added to their initial velocity. The optional radius, rotation, and tail streams are evaluated if
+//! the store has them. Particles that have not been born yet are not changed.
+//!
+//! The formulas are exact for constant gravity, wind, and air friction. With air friction c and terminal velocity vT:
+//!
+//!		v(t) = vT - (vT - v0) * exp(-c * t)
+//!		s(t) = s0 + vT * t - (vT - v0) * (1 - exp(-c * t)) / c
+//!
+//! and without air friction:
+//!
+//!		v(t) = v0 + g * t
+//!		s(t) = s0 + (v0 + g * t / 2) * t
+
+void ParticleKernel::evaluate(ParticleStore & particles, size_t begin, size_t end, UpdateContext const & context)
+{
+    assert(begin <= end && end <= particles.size());
+
+    Span<float const>     lifetimes         = particles.lifetimes();
+    Vec3Span<float const> initialPositions  = particles.initialPositions();
+    Vec3Span<float const> initialVelocities = particles.initialVelocities();
+    Vec4Span<float const> initialColors     = particles.initialColors();
+    Span<float const>     ages              = particles.ages();
+    Vec3Span<float>       positions         = particles.positions();
+    Vec3Span<float>       velocities        = particles.velocities();
+    Vec4Span<float>       colors            = particles.colors();
+    Span<float const>     initialRadii      = particles.initialRadii();
+    Span<float const>     initialRotations  = particles.initialRotations();
+    Span<float>           radii             = particles.radii();
+    Span<float>           rotations         = particles.rotations();
+    Vec3Span<float>       tails             = particles.tails();
+
+    bool const hasRadius   = particles.has(ParticleStore::RADIUS);
+    bool const hasRotation = particles.has(ParticleStore::ROTATION);
+    bool const hasTail     = particles.has(ParticleStore::TAIL);
+
+    glm::vec3 const emitterPosition  = context.emitterPosition();
+    glm::vec3 const emitterVelocity  = context.emitterVelocity();
+    glm::vec3 const gravity          = context.gravity();
+    glm::vec3 const terminalVelocity = context.terminalVelocity();
+    glm::vec4 const colorRate        = context.colorRate();
+    float const     c                = context.airFriction();
+    float const     dt               = context.dt();
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        float t = ages[i];
+        if (t < 0.0f)
+            continue;
+        assert(t < lifetimes[i]);
+
+        glm::vec3 s0 = emitterPosition + initialPositions[i];
+        glm::vec3 v0 = emitterVelocity + initialVelocities[i];
+        glm::vec3 position;
+        glm::vec3 velocity;
+
+        if (c != 0.0f)
+        {
+            float ect = std::exp(-c * t);
+            velocity = terminalVelocity - (terminalVelocity - v0) * ect;
+            position = s0 + terminalVelocity * t - (terminalVelocity - v0) * ((1.0f - ect) / c);
+        }
+        else
+        {
+            velocity = v0 + gravity * t;
+            position = s0 + (v0 + gravity * (0.5f * t)) * t;
+        }
+
+        positions.set(i, position);
+        velocities.set(i, velocity);
+        colors.set(i, glm::clamp(initialColors[i] + colorRate * t, glm::zero<glm::vec4>(), glm::one<glm::vec4>()));
+
+        if (hasRadius)
+            radii[i] = initialRadii[i] + t * context.radiusRate();
+
+        if (hasRotation)
+            rotations[i] = initialRotations[i] + t * context.angularVelocity();
+
+        if (hasTail)
+            tails.set(i, position - velocity * std::min(dt, t));
+    }
+}
+
+ParticleKernel::InstructionSet ParticleKernel::supportedInstructionSet()
+{
+    return supported_;
+}
+
+ParticleKernel::InstructionSet ParticleKernel::instructionSet()
+{
+    return selected_;
+}
+
+//! @param	instructionSet	The desired instruction set.
+//!
+//! If the CPU does not support the desired instruction set, the best supported instruction set is selected instead.
+
+ParticleKernel::InstructionSet ParticleKernel::setInstructionSet(InstructionSet instructionSet)
+{
+    selected_ = (instructionSet <= supported_) ? instructionSet : supported_;
+    return selected_;
+}
+
+char const * ParticleKernel::name(InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+        case InstructionSet::SCALAR: return "scalar";
+        case InstructionSet::SSE2:   return "SSE2";
+        case InstructionSet::AVX2:   return "AVX2";
+        case InstructionSet::AVX512: return "AVX-512";
+        default:                     return "unknown";
+    }
+}
+} // namespace Confetti
@@ -0,0 +1,23 @@
+#include "ParticleKernelImpl.h"
+#include "ParticleKernelSimd.h"
+
+// This file is compiled with AVX-512 enabled. It must not include any header that defines an inline function used
+// elsewhere in the library.
+
+namespace Confetti
+{
+namespace ParticleKernelImpl
+{
+size_t updateAvx512(Streams const & streams, Constants const & constants, size_t begin, size_t end)
+{
+#if defined(CONFETTI_SIMD_X86) && (defined(__AVX512F__))
+    return updateBlocks<Avx512>(streams, constants, begin, end);
+#else
+    (void)streams;
+    (void)constants;
+    (void)end;
+    return begin;
+#endif
+}
+} // namespace ParticleKernelImpl
+} // namespace Confetti
@@ -0,0 +1,95 @@
+#if !defined(CONFETTI_PARTICLEKERNELIMPL_H)
+#define CONFETTI_PARTICLEKERNELIMPL_H
+
+#pragma once
+
+#include <cstddef>
+
+// Data shared by the scalar and vectorized particle kernels.
+//
+// The vectorized kernels are compiled with different instruction set options, so everything they share with the rest
+// of the library must be plain data. Nothing in this file may define a function.
+
+namespace Confetti
+{
+namespace ParticleKernelImpl
+{
+// Pointers to the streams of a ParticleStore. Optional streams that are not present are null.
+//
+// The wind is not part of the store. If the environment has a wind field, it is the velocity of the field at each
+// particle's position before the update.
+//
+// The events are not part of the store either. If they are recorded, the kernels write the EVENT_* flags of each
+// particle, and 0 for particles that have not been born.
+struct Streams
+{
+    float const * lifetime;
+    float const * initialPosition[3];
+    float const * initialVelocity[3];
+    float const * initialColor[4];
+    float const * initialRadius;
+    float const * initialRotation;
+
+    float * age;
+    float * position[3];
+    float * velocity[3];
+    float * color[4];
+    float * radius;
+    float * rotation;
+    float * tail[3];
+
+    float const * wind[3];
+
+    unsigned char * events;
+};
+
+// Flags written to the event stream. They match the values of ParticleEvent::Type.
+enum EventFlags : unsigned char
+{
+    EVENT_BIRTH  = 1,
+    EVENT_CLIP   = 2,
+    EVENT_BOUNCE = 4
+};
+
+// Coefficients of a set of planes, one array per coefficient. The arrays are padded with null planes (0, 0, 0, 0) to a
+// multiple of PACKET_SIZE.
+struct Planes
+{
+    static size_t constexpr PACKET_SIZE = 4;
+
+    float const * a;
+    float const * b;
+    float const * c;
+    float const * d;
+    float const * dampening;
+    size_t count;           // Number of planes, not including the padding
+};
+
+// Values that are constant for all particles during an update
+struct Constants
+{
+    float dt;
+    float emitterPosition[3];
+    float emitterVelocity[3];
+    float airFriction;
+    float gravity[3];
+    float terminalVelocity[3];
+    float terminalDistance[3];
+    float ect1;
+    float colorRate[4];
+    float radiusRate;
+    float angularVelocity;
+
+    Planes clippers;
+    Planes surfaces;
+};
+
+// Vectorized kernels. Each updates as many whole blocks of particles in [begin, end) as it can and returns the index of
+// the first particle that was not updated.
+size_t updateSse2(Streams const & streams, Constants const & constants, size_t begin, size_t end);
+size_t updateAvx2(Streams const & streams, Constants const & constants, size_t begin, size_t end);
+size_t updateAvx512(Streams const & streams, Constants const & constants, size_t begin, size_t end);
+} // namespace ParticleKernelImpl
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_PARTICLEKERNELIMPL_H)
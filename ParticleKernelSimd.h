@@ -0,0 +1,253 @@
+#if !defined(CONFETTI_PARTICLEKERNELSIMD_H)
+#define CONFETTI_PARTICLEKERNELSIMD_H
+
+#pragma once
+
+#include "ParticleKernelImpl.h"
+#include "Simd.h"
+
+// The vectorized particle kernel, written once for all the wrappers in Simd.h. It is a line-by-line translation of the
+// scalar kernel in ParticleKernel.cpp. Branches are replaced by masks: every lane computes the full update and the
+// masks select which results are kept.
+
+#if defined(CONFETTI_SIMD_X86)
+
+namespace
+{
+// Returns a * x + b * y + c * z for plane j of a set and a block of positions
+template <typename V>
+typename V::Float distance(Confetti::ParticleKernelImpl::Planes const & planes,
+                           size_t                                       j,
+                           typename V::Float const                      position[3])
+{
+    return V::add(V::add(V::mul(V::set(planes.a[j]), position[0]), V::mul(V::set(planes.b[j]), position[1])),
+                  V::mul(V::set(planes.c[j]), position[2]));
+}
+
+template <typename V>
+size_t updateBlocks(Confetti::ParticleKernelImpl::Streams const &   s,
+                    Confetti::ParticleKernelImpl::Constants const & k,
+                    size_t                                          begin,
+                    size_t                                          end)
+{
+    using Float = typename V::Float;
+    using Mask  = typename V::Mask;
+    using namespace Confetti::ParticleKernelImpl;
+
+    Float const zero = V::set(0.0f);
+    Float const one  = V::set(1.0f);
+    Float const half = V::set(0.5f);
+    Float const dt   = V::set(k.dt);
+
+    size_t i = begin;
+    for (; i + V::WIDTH <= end; i += V::WIDTH)
+    {
+        Float lifetime = V::load(s.lifetime + i);
+        Float age      = V::add(V::load(s.age + i), dt);
+
+        // If none of the particles have been born yet then do nothing
+
+        Mask born = V::ge(age, zero);
+        if (!V::any(born))
+        {
+            V::store(s.age + i, age);
+            if (s.events)
+            {
+                for (int l = 0; l < V::WIDTH; ++l)
+                {
+                    s.events[i + l] = 0;
+                }
+            }
+            continue;
+        }
+
+        // See which particles are (re)born this frame
+
+        Mask young  = V::lt(age, dt);
+        Mask expired = V::maskAnd(V::maskAndNot(V::ge(age, lifetime), young), born);
+        age = V::select(expired, V::sub(age, lifetime), age);
+        Mask reborn = V::maskAnd(V::maskOr(young, expired), born);
+
+        // If (re)born, then reset to initial values and adjust dt
+
+        Float pdt = V::select(reborn, age, dt);
+
+        Float velocity[3];
+        Float position[3];
+        Float color[4];
+        for (int c = 0; c < 3; ++c)
+        {
+            Float v0 = V::add(V::set(k.emitterVelocity[c]), V::load(s.initialVelocity[c] + i));
+            Float p0 = V::add(V::set(k.emitterPosition[c]), V::load(s.initialPosition[c] + i));
+            velocity[c] = V::select(reborn, v0, V::load(s.velocity[c] + i));
+            position[c] = V::select(reborn, p0, V::load(s.position[c] + i));
+        }
+        for (int c = 0; c < 4; ++c)
+        {
+            color[c] = V::select(reborn, V::load(s.initialColor[c] + i), V::load(s.color[c] + i));
+        }
+
+        // Update velocity and position
+
+        if (k.airFriction != 0.0f)
+        {
+            Float ect1 = V::set(k.ect1);
+            Float c    = V::set(k.airFriction);
+            for (int j = 0; j < 3; ++j)
+            {
+                Float vt = V::set(k.terminalVelocity[j]);
+                Float st = V::set(k.terminalDistance[j]);
+                if (s.wind[0])
+                {
+                    Float wind = V::load(s.wind[j] + i);
+                    vt = V::add(vt, wind);
+                    st = V::add(st, V::mul(wind, dt));
+                }
+                Float dv = V::mul(V::sub(vt, velocity[j]), ect1);
+                Float ds = V::sub(st, V::div(dv, c));
+                velocity[j] = V::add(velocity[j], dv);
+                position[j] = V::add(position[j], ds);
+            }
+        }
+        else
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                Float dv = V::mul(V::set(k.gravity[j]), pdt);
+                Float ds = V::mul(V::add(velocity[j], V::mul(dv, half)), pdt);
+                velocity[j] = V::add(velocity[j], dv);
+                position[j] = V::add(position[j], ds);
+            }
+        }
+
+        // Check for collision with clip planes. A particle is clipped if it is behind the nearest plane.
+
+        Mask clipped = V::none();
+        if (k.clippers.count > 0)
+        {
+            Float nearest = distance<V>(k.clippers, 0, position);
+            for (size_t j = 1; j < k.clippers.count; ++j)
+            {
+                nearest = V::min(nearest, distance<V>(k.clippers, j, position));
+            }
+            clipped = V::maskAnd(V::lt(nearest, zero), born);
+        }
+        age = V::select(clipped, V::sub(age, lifetime), age);
+
+        // Particles that have been born and were not clipped
+        Mask write = V::maskAndNot(born, clipped);
+
+        // Check for collision with surfaces. If no particle in the block is behind any of the surfaces, then none of
+        // them bounce and the surfaces don't need to be checked one at a time. Particles that were clipped don't
+        // bounce.
+
+        bool bounce  = false;
+        Mask bounced = V::none();
+        if (k.surfaces.count > 0)
+        {
+            Float nearest = distance<V>(k.surfaces, 0, position);
+            for (size_t j = 1; j < k.surfaces.count; ++j)
+            {
+                nearest = V::min(nearest, distance<V>(k.surfaces, j, position));
+            }
+            bounce = V::any(V::lt(nearest, zero));
+        }
+
+        for (size_t j = 0; bounce && j < k.surfaces.count; ++j)
+        {
+            Float d   = distance<V>(k.surfaces, j, position);
+            Mask  hit = V::maskAnd(V::lt(d, zero), write);
+            if (!V::any(hit))
+                continue;
+            bounced = V::maskOr(bounced, hit);
+
+            Float nx = V::set(k.surfaces.a[j]);
+            Float ny = V::set(k.surfaces.b[j]);
+            Float nz = V::set(k.surfaces.c[j]);
+            Float f  = V::set(1.0f + k.surfaces.dampening[j]);
+            Float nv = V::add(V::add(V::mul(nx, velocity[0]), V::mul(ny, velocity[1])), V::mul(nz, velocity[2]));
+            Float dp = V::add(d, V::set(k.surfaces.d[j]));
+            Float fv = V::mul(f, nv);
+            Float fp = V::mul(f, dp);
+            velocity[0] = V::select(hit, V::sub(velocity[0], V::mul(nx, fv)), velocity[0]);
+            velocity[1] = V::select(hit, V::sub(velocity[1], V::mul(ny, fv)), velocity[1]);
+            velocity[2] = V::select(hit, V::sub(velocity[2], V::mul(nz, fv)), velocity[2]);
+            position[0] = V::select(hit, V::sub(position[0], V::mul(nx, fp)), position[0]);
+            position[1] = V::select(hit, V::sub(position[1], V::mul(ny, fp)), position[1]);
+            position[2] = V::select(hit, V::sub(position[2], V::mul(nz, fp)), position[2]);
+        }
+
+        // Update color
+
+        for (int c = 0; c < 4; ++c)
+        {
+            color[c] = V::add(color[c], V::mul(V::set(k.colorRate[c]), pdt));
+            color[c] = V::min(V::max(color[c], zero), one);
+        }
+
+        // Save the results of particles that have been born. The colors of clipped particles are not updated, but their
+        // positions and velocities are kept to show where they were clipped.
+
+        for (int c = 0; c < 3; ++c)
+        {
+            velocity[c] = V::select(born, velocity[c], V::load(s.velocity[c] + i));
+            position[c] = V::select(born, position[c], V::load(s.position[c] + i));
+            V::store(s.velocity[c] + i, velocity[c]);
+            V::store(s.position[c] + i, position[c]);
+        }
+        for (int c = 0; c < 4; ++c)
+        {
+            V::store(s.color[c] + i, V::select(write, color[c], V::load(s.color[c] + i)));
+        }
+        V::store(s.age + i, age);
+
+        // Record the events
+
+        if (s.events)
+        {
+            int const births  = V::bits(reborn);
+            int const clips   = V::bits(clipped);
+            int const bounces = V::bits(bounced);
+            for (int l = 0; l < V::WIDTH; ++l)
+            {
+                s.events[i + l] = (unsigned char)((((births >> l) & 1) * EVENT_BIRTH) |
+                                                  (((clips >> l) & 1) * EVENT_CLIP) |
+                                                  (((bounces >> l) & 1) * EVENT_BOUNCE));
+            }
+        }
+
+        // Update size and rotation
+
+        if (s.radius)
+        {
+            Float radius = V::select(reborn, V::load(s.initialRadius + i), V::load(s.radius + i));
+            radius = V::add(radius, V::mul(pdt, V::set(k.radiusRate)));
+            V::store(s.radius + i, V::select(born, radius, V::load(s.radius + i)));
+        }
+
+        if (s.rotation)
+        {
+            Float rotation = V::select(reborn, V::load(s.initialRotation + i), V::load(s.rotation + i));
+            rotation = V::add(rotation, V::mul(pdt, V::set(k.angularVelocity)));
+            V::store(s.rotation + i, V::select(born, rotation, V::load(s.rotation + i)));
+        }
+
+        // Update the location of the tail
+
+        if (s.tail[0])
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                Float tail = V::sub(position[c], V::mul(velocity[c], pdt));
+                V::store(s.tail[c] + i, V::select(born, tail, V::load(s.tail[c] + i)));
+            }
+        }
+    }
+
+    return i;
+}
+} // anonymous namespace
+
+#endif // defined(CONFETTI_SIMD_X86)
+
+#endif // !defined(CONFETTI_PARTICLEKERNELSIMD_H)
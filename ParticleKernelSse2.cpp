@@ -0,0 +1,23 @@
+#include "ParticleKernelImpl.h"
+#include "ParticleKernelSimd.h"
+
+// This file is compiled with SSE2 enabled. It must not include any header that defines an inline function used
+// elsewhere in the library.
+
+namespace Confetti
+{
+namespace ParticleKernelImpl
+{
+size_t updateSse2(Streams const & streams, Constants const & constants, size_t begin, size_t end)
+{
+#if defined(CONFETTI_SIMD_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    return updateBlocks<Sse2>(streams, constants, begin, end);
+#else
+    (void)streams;
+    (void)constants;
+    (void)end;
+    return begin;
+#endif
+}
+} // namespace ParticleKernelImpl
+} // namespace Confetti
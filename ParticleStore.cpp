@@ -0,0 +1,280 @@
+#include "ParticleStore.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace Confetti
+{
+//! @param  streams     Optional streams to allocate (see ParticleStore::Streams)
+
+ParticleStore::ParticleStore(uint32_t streams /*= NONE*/)
+    : streams_(streams)
+{
+}
+
+// The streams are those of the given store, which is either this store or its group. Only the streams present in this
+// store are visited.
+template <typename F>
+void ParticleStore::forEachStream(ParticleStore & store, F f) const
+{
+    f(store.lifetime_);
+    f(store.age_);
+    for (Stream * s : { &store.initialPosition_.x, &store.initialPosition_.y, &store.initialPosition_.z,
+                        &store.initialVelocity_.x, &store.initialVelocity_.y, &store.initialVelocity_.z,
+                        &store.initialColor_.x, &store.initialColor_.y, &store.initialColor_.z, &store.initialColor_.w,
+                        &store.position_.x, &store.position_.y, &store.position_.z,
+                        &store.velocity_.x, &store.velocity_.y, &store.velocity_.z,
+                        &store.color_.x, &store.color_.y, &store.color_.z, &store.color_.w })
+    {
+        f(*s);
+    }
+
+    if (has(RADIUS))
+    {
+        f(store.initialRadius_);
+        f(store.radius_);
+    }
+
+    if (has(ROTATION))
+    {
+        f(store.initialRotation_);
+        f(store.rotation_);
+    }
+
+    if (has(TAIL))
+    {
+        f(store.tail_.x);
+        f(store.tail_.y);
+        f(store.tail_.z);
+    }
+
+    if (has(PREVIOUS))
+    {
+        for (Stream * s : { &store.previousPosition_.x, &store.previousPosition_.y, &store.previousPosition_.z,
+                            &store.previousColor_.x, &store.previousColor_.y, &store.previousColor_.z,
+                            &store.previousColor_.w })
+        {
+            f(*s);
+        }
+    }
+}
+
+//! @param  streams     Optional streams to allocate (see ParticleStore::Streams)
+
+void ParticleStore::addStreams(uint32_t streams)
+{
+    uint32_t const added = streams & ~streams_;
+    if (added == 0)
+        return;
+
+    // Nothing writes to the range of a stream of the group that the store doesn't have, so the range is still zero
+    // even if the group already has the stream.
+
+    if (group_)
+    {
+        group_->addStreams(added);
+        streams_ |= added;
+        return;
+    }
+
+    size_t const n        = size();
+    size_t const capacity = age_.capacity();
+
+    // Only the new streams need to be allocated. The others are already the right size.
+
+    streams_ |= streams;
+    forEachStream(*this, [n, capacity] (Stream & s) {
+                      if (s.size() != n)
+                      {
+                          s.reserve(capacity);
+                          s.resize(n, 0.0f);
+                      }
+                  });
+}
+
+//! @param  n   Number of particles to reserve space for
+//!
+//! An attached store is detached if its range of the group is too small.
+
+void ParticleStore::reserve(size_t n)
+{
+    if (group_)
+    {
+        if (n <= capacity_)
+            return;
+        detach();
+    }
+    forEachStream(*this, [n] (Stream & s) { s.reserve(n); });
+}
+
+void ParticleStore::clear()
+{
+    if (group_)
+    {
+        size_ = 0;
+        return;
+    }
+    forEachStream(*this, [] (Stream & s) { s.clear(); });
+}
+
+//! @param  n   New number of particles
+//!
+//! An attached store is detached if its range of the group is too small.
+
+void ParticleStore::resize(size_t n)
+{
+    if (group_ && n > capacity_)
+        detach();
+
+    if (group_)
+    {
+        if (n > size_)
+        {
+            size_t const begin = offset_ + size_;
+            size_t const end   = offset_ + n;
+            forEachStream(*group_, [begin, end] (Stream & s) { std::fill(s.begin() + begin, s.begin() + end, 0.0f); });
+        }
+        size_ = n;
+        return;
+    }
+    forEachStream(*this, [n] (Stream & s) { s.resize(n, 0.0f); });
+}
+
+//! @param	lifetime		How long the particle lives.
+//! @param	age				Initial age.
+//! @param	position		Position at birth.
+//! @param	velocity		Velocity at birth.
+//! @param	color			Color at birth.
+//! @param	radius			Radius at birth (ignored if the store has no radius stream).
+//! @param	rotation		Rotation at birth (ignored if the store has no rotation stream).
+//!
+//! @return     index of the new particle
+
+size_t ParticleStore::add(float             lifetime,
+                          float             age,
+                          glm::vec3 const & position,
+                          glm::vec3 const & velocity,
+                          glm::vec4 const & color,
+                          float             radius /*= 0.0f*/,
+                          float             rotation /*= 0.0f*/)
+{
+    size_t index = size();
+    resize(index + 1);
+
+    ParticleStore & store = storage();
+    span(store.lifetime_)[index] = lifetime;
+    span(store.age_)[index]      = age;
+    view(store.initialPosition_).set(index, position);
+    view(store.initialVelocity_).set(index, velocity);
+    view(store.initialColor_).set(index, color);
+    view(store.position_).set(index, position);
+    view(store.velocity_).set(index, velocity);
+    view(store.color_).set(index, color);
+
+    if (has(RADIUS))
+    {
+        span(store.initialRadius_)[index] = radius;
+        span(store.radius_)[index]        = radius;
+    }
+
+    if (has(ROTATION))
+    {
+        span(store.initialRotation_)[index] = rotation;
+        span(store.rotation_)[index]        = rotation;
+    }
+
+    if (has(TAIL))
+        view(store.tail_).set(index, position);
+
+    return index;
+}
+
+//! @param  a   Index of a particle
+//! @param  b   Index of another particle
+
+void ParticleStore::swap(size_t a, size_t b)
+{
+    assert(a < size() && b < size());
+    if (a == b)
+        return;
+
+    size_t const i = offset_ + a;
+    size_t const j = offset_ + b;
+    forEachStream(storage(), [i, j] (Stream & s) { std::swap(s[i], s[j]); });
+}
+
+//! @param  order   New order of the particles. order[i] is the current index of the particle that is moved to index i.
+//!
+//! @note   The order must be a permutation of [0, size()).
+
+void ParticleStore::reorder(std::vector<uint32_t> const & order)
+{
+    assert(order.size() == size());
+
+    Stream       scratch(size());
+    size_t const offset = offset_;
+    forEachStream(storage(), [&order, &scratch, offset] (Stream & s) {
+                      for (size_t i = 0; i < order.size(); ++i)
+                      {
+                          scratch[i] = s[offset + order[i]];
+                      }
+                      std::copy(scratch.begin(), scratch.end(), s.begin() + offset);
+                  });
+}
+
+//! @param  group       Store holding the particles of several stores
+//! @param  offset      Index in the group of the first particle of this store
+//! @param  capacity    Number of particles in the range. It must be at least the number of particles in the store.
+//!
+//! The group gets any streams of this store that it does not have already.
+
+void ParticleStore::attach(ParticleStore & group, size_t offset, size_t capacity)
+{
+    assert(&group != this && !group.group_);
+    assert(capacity >= size() && offset + capacity <= group.size());
+
+    if (group_)
+        detach();
+
+    group.addStreams(streams_);
+
+    size_t const n = size();
+    std::vector<Stream *> own;
+    forEachStream(*this, [&own] (Stream & s) { own.push_back(&s); });
+    size_t k = 0;
+    forEachStream(group, [&own, &k, offset, n] (Stream & s) {
+                      Stream & source = *own[k++];
+                      std::copy(source.begin(), source.begin() + n, s.begin() + offset);
+                      Stream().swap(source);
+                  });
+
+    group_    = &group;
+    offset_   = offset;
+    size_     = n;
+    capacity_ = capacity;
+}
+
+//! The streams are allocated again, and they are only as large as the particles.
+
+void ParticleStore::detach()
+{
+    if (!group_)
+        return;
+
+    size_t const n     = size_;
+    size_t const first = offset_;
+    std::vector<Stream *> shared;
+    forEachStream(*group_, [&shared] (Stream & s) { shared.push_back(&s); });
+    size_t k = 0;
+    forEachStream(*this, [&shared, &k, first, n] (Stream & s) {
+                      Stream const & source = *shared[k++];
+                      s.assign(source.begin() + first, source.begin() + first + n);
+                  });
+
+    group_    = nullptr;
+    offset_   = 0;
+    size_     = 0;
+    capacity_ = 0;
+}
+} // namespace Confetti
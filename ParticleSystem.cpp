@@ -5,11 +5,22 @@
 #include "Emitter.h"
 #include "EmitterVolume.h"
 #include "Environment.h"
+#include "Frustum.h"
+#include "JobScheduler.h"
+#include "ParticleKernel.h"
+#include "ParticleStore.h"
+#include "UpdateContext.h"
 
+#include <Vkx/Camera.h>
 #include <Vkx/Device.h>
 #include <vulkan/vulkan.hpp>
 
 #include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
 
 template <class List, typename T>
 bool removeFromList(List & list, T * value)
@@ -26,23 +37,74 @@ bool removeFromList(List & list, T * value)
     return found;
 }
 
+namespace
+{
+// The ranges of a group start at a multiple of the width of the widest vectorized kernel
+size_t constexpr ALIGNMENT = 16;
+
+// Marks an emitter in a group that is not updated, because it is disabled
+size_t constexpr NOT_UPDATED = ~size_t(0);
+
+// Returns the size of the range of a group given to an emitter with n particles
+size_t rangeCapacity(size_t n)
+{
+    return std::max((n + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT, ALIGNMENT);
+}
+
+// Emitters that can share a group: the same type, environment, and appearance
+using GroupKey = std::tuple<Confetti::Environment const *, Confetti::Appearance const *, std::type_index>;
+
+GroupKey groupKey(Confetti::BasicEmitter const & emitter)
+{
+    return GroupKey(emitter.environment().get(), emitter.appearance().get(), std::type_index(typeid(emitter)));
+}
+} // anonymous namespace
+
 namespace Confetti
 {
-//! @param  device  Device to draw the particle system on
+static_assert(ParticleSystem::CHUNK_SIZE % BasicEmitter::CULL_CHUNK_SIZE == 0,
+              "The update chunks must start at the beginning of culling chunks");
+static_assert(ParticleSystem::BATCH_SIZE <= ParticleSystem::CHUNK_SIZE,
+              "An emitter in a group must fit in a single chunk");
+
+// Small emitters of the same type that share an environment and an appearance. Their particles are kept in a single
+// store, each emitter's in its own range, and they are updated by one kernel call.
+struct ParticleSystem::Group
+{
+    explicit Group(GroupKey const & key) : key(key) {}
+
+    GroupKey                    key;
+    ParticleStore               store;
+    std::vector<BasicEmitter *> emitters;   // In the order of their ranges
+};
+
+//! @param  device      Device to draw the particle system on
+//! @param  commandPool Command pool for creating buffers
+//! @param  queue       Queue for creating buffers
+//! @param  threads     Number of threads used to update the emitters. If 0, the number of hardware threads is used.
 
 ParticleSystem::ParticleSystem(std::shared_ptr<Vkx::Device> device,
                                vk::CommandPool const &      commandPool,
-                               vk::Queue const &            queue)
+                               vk::Queue const &            queue,
+                               unsigned                     threads /*= 0*/)
     : device_(device)
     , commandPool_(commandPool)
     , queue_(queue)
+    , scheduler_(std::make_unique<JobScheduler>(threads))
 {
 }
 
+ParticleSystem::~ParticleSystem()
+{
+    ungroup();
+}
+
 //! @param	emitter	The emitter to register.
 
 void ParticleSystem::add(std::shared_ptr<BasicEmitter> emitter)
 {
+    if (fixedTimestep_ > 0.0f)
+        emitter->setInterpolated(true);
     emitters_.push_back(emitter);
 }
 
@@ -66,6 +128,18 @@ void ParticleSystem::add(std::shared_ptr<Environment> environment)
 
 bool ParticleSystem::remove(BasicEmitter * emitter)
 {
+    // The emitter takes its particles out of its group. The rest of the group is left as it is.
+    for (auto const & group : groups_)
+    {
+        auto member = std::find(group->emitters.begin(), group->emitters.end(), emitter);
+        if (member != group->emitters.end())
+        {
+            if (emitter->particles().group() == &group->store)
+                emitter->particles().detach();
+            group->emitters.erase(member);
+            break;
+        }
+    }
     return removeFromList(emitters_, emitter);
 }
 
@@ -90,6 +164,55 @@ bool ParticleSystem::remove(Environment * environment)
 //! @param	dt		Amount of time (seconds) that has passed since the last update.
 
 void ParticleSystem::update(float dt)
+{
+    if (fixedTimestep_ <= 0.0f)
+    {
+        simulate(dt);
+        return;
+    }
+
+    // Simulate as many whole steps as have elapsed and carry the rest over to the next update
+
+    accumulator_ += dt;
+    int steps = 0;
+    while (accumulator_ >= fixedTimestep_ && steps < MAX_STEPS)
+    {
+        simulate(fixedTimestep_);
+        accumulator_ -= fixedTimestep_;
+        ++steps;
+    }
+    if (steps == MAX_STEPS)
+        accumulator_ = std::min(accumulator_, fixedTimestep_);
+
+    // Draw the particles at the point between the last two steps corresponding to the leftover time
+
+    float t = accumulator_ / fixedTimestep_;
+    for (auto const & emitter : emitters_)
+    {
+        emitter->setInterpolationFactor(t);
+    }
+}
+
+//! @param  step    Length of a simulation step (seconds), or 0 to simulate once per update
+//!
+//! The emitters are interpolated between steps if the time step is fixed.
+
+void ParticleSystem::setFixedTimestep(float step)
+{
+    fixedTimestep_ = std::max(step, 0.0f);
+    accumulator_   = 0.0f;
+
+    bool interpolated = fixedTimestep_ > 0.0f;
+    for (auto const & emitter : emitters_)
+    {
+        emitter->setInterpolated(interpolated);
+        emitter->setInterpolationFactor(1.0f);
+    }
+}
+
+//! @param	dt		Amount of time (seconds) to simulate.
+
+void ParticleSystem::simulate(float dt)
 {
     // Update all the appearances
 
@@ -105,23 +228,325 @@ void ParticleSystem::update(float dt)
         environment->update(dt);
     }
 
-    // Update all the emitters
+    // Update all the emitters. Large emitters are divided into chunks, which are updated in parallel, and then the
+    // emitters are finished in parallel. Small emitters share groups, and each group is updated and finished by a
+    // single job.
 
+    struct Chunk
+    {
+        BasicEmitter *        emitter;
+        UpdateContext const * context;
+        size_t                begin;
+        size_t                end;
+        BoundingBox           bounds;
+    };
+
+    std::vector<BasicEmitter *> active;
+    std::vector<UpdateContext>  contexts;
+    std::vector<size_t>         large;          // Indexes of the emitters that are divided into chunks
+    std::vector<size_t>         ungrouped;      // Indexes of the small emitters that are not in a group yet
+    std::vector<Chunk>          chunks;
+    std::vector<size_t>         firstChunk;     // Index of each large emitter's first chunk, then the number of chunks
+
+    active.reserve(emitters_.size());
+    contexts.reserve(emitters_.size());
     for (auto const & emitter : emitters_)
     {
         if (emitter->enabled())
-            emitter->update(dt);
+        {
+            active.push_back(emitter.get());
+            contexts.push_back(emitter->beginUpdate(dt));
+        }
+    }
+
+    // Emitters of the same type that share an environment and appearance run the same code on the same data, so their
+    // particles are kept next to each other in groups. An emitter stays in its group while it is small, even while it
+    // is disabled, so only the particles of the emitters that join or leave a group are moved.
+
+    prune();
+
+    std::unordered_map<ParticleStore const *, size_t> groupIndex;
+    std::vector<std::vector<size_t>>                  members(groups_.size());  // Context of each emitter in a group
+    for (size_t g = 0; g < groups_.size(); ++g)
+    {
+        groupIndex[&groups_[g]->store] = g;
+        members[g].assign(groups_[g]->emitters.size(), NOT_UPDATED);
+    }
+
+    for (size_t i = 0; i < active.size(); ++i)
+    {
+        ParticleStore const & particles = active[i]->particles();
+        if (particles.size() > BATCH_SIZE)
+        {
+            large.push_back(i);
+            continue;
+        }
+
+        auto group = groupIndex.find(particles.group());
+        if (group == groupIndex.end())
+        {
+            ungrouped.push_back(i);
+            continue;
+        }
+
+        // The emitters of a group are in the order of their ranges
+        std::vector<BasicEmitter *> const & emitters = groups_[group->second]->emitters;
+        auto member = std::lower_bound(emitters.begin(),
+                                       emitters.end(),
+                                       particles.offset(),
+                                       [] (BasicEmitter const * emitter, size_t offset) {
+                                           return emitter->particles().offset() < offset;
+                                       });
+        members[group->second][member - emitters.begin()] = i;
+    }
+
+    join(active, ungrouped, members);
+
+    firstChunk.reserve(large.size() + 1);
+    for (size_t i : large)
+    {
+        firstChunk.push_back(chunks.size());
+        size_t const n = active[i]->aliveCount();
+        for (size_t begin = 0; begin < n; begin += CHUNK_SIZE)
+        {
+            chunks.push_back({ active[i], &contexts[i], begin, std::min(begin + CHUNK_SIZE, n), BoundingBox() });
+        }
+    }
+    firstChunk.push_back(chunks.size());
+
+    // Each chunk computes its own bounding box, and the boxes are combined when the emitter is finished. The emitters
+    // in a group each fit in one chunk, so they are finished as soon as they are updated.
+
+    scheduler_->run(chunks.size() + groups_.size(), [&] (size_t i) {
+                        if (i < chunks.size())
+                        {
+                            Chunk & chunk = chunks[i];
+                            chunk.bounds = chunk.emitter->updateChunk(*chunk.context, chunk.begin, chunk.end);
+                            return;
+                        }
+
+                        size_t const g = i - chunks.size();
+                        updateGroup(*groups_[g], contexts.data(), members[g].data());
+                    });
+
+    scheduler_->run(large.size(), [&active, &large, &chunks, &firstChunk] (size_t i) {
+                        BoundingBox bounds;
+                        for (size_t j = firstChunk[i]; j < firstChunk[i + 1]; ++j)
+                        {
+                            bounds.add(chunks[j].bounds);
+                        }
+                        active[large[i]]->endUpdate(bounds);
+                    });
+}
+
+// Takes the emitters out of the groups they no longer belong in: the emitters whose particles outgrew their ranges, and
+// those that are too large for a group or have changed environment or appearance. The remaining emitters of a group
+// that is mostly unused are packed into a smaller store, and empty groups are deleted.
+void ParticleSystem::prune()
+{
+    for (auto const & group : groups_)
+    {
+        ParticleStore * store   = &group->store;
+        GroupKey const  key     = group->key;
+        auto            leaving = [store, &key] (BasicEmitter * emitter) {
+                                      ParticleStore & particles = emitter->particles();
+                                      if (particles.group() != store)
+                                          return true;
+                                      if (particles.size() <= BATCH_SIZE && groupKey(*emitter) == key)
+                                          return false;
+                                      particles.detach();
+                                      return true;
+                                  };
+        group->emitters.erase(std::remove_if(group->emitters.begin(), group->emitters.end(), leaving),
+                              group->emitters.end());
+
+        size_t used = 0;
+        for (BasicEmitter * emitter : group->emitters)
+        {
+            used += emitter->particles().capacity();
+        }
+        if (used * 2 >= store->size())
+            continue;
+
+        size_t size = 0;
+        for (BasicEmitter * emitter : group->emitters)
+        {
+            emitter->particles().detach();
+            size += rangeCapacity(emitter->particles().size());
+        }
+        store->clear();
+        store->resize(size);
+
+        size_t offset = 0;
+        for (BasicEmitter * emitter : group->emitters)
+        {
+            size_t const capacity = rangeCapacity(emitter->particles().size());
+            emitter->particles().attach(*store, offset, capacity);
+            offset += capacity;
+        }
+    }
+
+    groups_.erase(std::remove_if(groups_.begin(),
+                                 groups_.end(),
+                                 [] (std::unique_ptr<Group> const & group) { return group->emitters.empty(); }),
+                  groups_.end());
+}
+
+// Adds small emitters that are not in a group yet to the end of a group with the same key that has room for them, or to
+// new groups. A group holds at most CHUNK_SIZE particles, so that the groups can be spread across the threads. The
+// context index of each emitter added to a group is appended to the group's members.
+void ParticleSystem::join(std::vector<BasicEmitter *> const & active,
+                          std::vector<size_t> &               ungrouped,
+                          std::vector<std::vector<size_t>> &  members)
+{
+    std::stable_sort(ungrouped.begin(),
+                     ungrouped.end(),
+                     [&active] (size_t a, size_t b) { return groupKey(*active[a]) < groupKey(*active[b]); });
+
+    size_t g = groups_.size();      // The group the last emitter was added to
+    for (size_t i : ungrouped)
+    {
+        BasicEmitter * emitter  = active[i];
+        GroupKey const key      = groupKey(*emitter);
+        size_t const   capacity = rangeCapacity(emitter->particles().size());
+
+        auto fits = [&key, capacity] (Group const & group) {
+                        return group.key == key && group.store.size() + capacity <= CHUNK_SIZE;
+                    };
+        if (g == groups_.size() || !fits(*groups_[g]))
+        {
+            g = 0;
+            while (g < groups_.size() && !fits(*groups_[g]))
+            {
+                ++g;
+            }
+            if (g == groups_.size())
+            {
+                groups_.push_back(std::make_unique<Group>(key));
+                members.emplace_back();
+            }
+        }
+
+        Group &      group  = *groups_[g];
+        size_t const offset = group.store.size();
+        group.store.resize(offset + capacity);
+        emitter->particles().attach(group.store, offset, capacity);
+        group.emitters.push_back(emitter);
+        members[g].push_back(i);
+    }
+}
+
+// Moves the particles of the emitters in the groups back into their own stores
+void ParticleSystem::ungroup()
+{
+    for (auto const & group : groups_)
+    {
+        for (BasicEmitter * emitter : group->emitters)
+        {
+            if (emitter->particles().group() == &group->store)
+                emitter->particles().detach();
+        }
+    }
+    groups_.clear();
+}
+
+// Updates the emitters in a group. The particles of the emitters that are simulated are updated by one kernel call,
+// with a range and a context for each emitter. The emitters are then finished one at a time. Each emitter's context is
+// given by its index in the contexts, or NOT_UPDATED if it is disabled.
+void ParticleSystem::updateGroup(Group & group, UpdateContext const * contexts, size_t const * indexes)
+{
+    static thread_local std::vector<ParticleKernel::Range> ranges;
+    static thread_local std::vector<BasicEmitter *>        simulated;
+    static thread_local std::vector<uint8_t>               events;
+
+    ranges.clear();
+    simulated.clear();
+    bool recorded = false;
+    for (size_t k = 0; k < group.emitters.size(); ++k)
+    {
+        if (indexes[k] == NOT_UPDATED)
+            continue;
+
+        BasicEmitter *        emitter = group.emitters[k];
+        UpdateContext const & context = contexts[indexes[k]];
+        size_t const          n       = emitter->aliveCount();
+        if (emitter->analyticUpdate())
+        {
+            emitter->endUpdate(emitter->updateChunk(context, 0, n));
+            continue;
+        }
+
+        emitter->prepareChunk(context, 0, n);
+        size_t const offset = emitter->particles().offset();
+        ranges.push_back({ offset, offset + n, &context });
+        simulated.push_back(emitter);
+        recorded = recorded || emitter->events();
+    }
+
+    if (ranges.empty())
+        return;
+
+    size_t const first = ranges.front().begin;
+    uint8_t *    flags = nullptr;
+    if (recorded)
+    {
+        events.resize(std::max<size_t>(ranges.back().end - first, 1));
+        flags = events.data();
+    }
+
+    ParticleKernel::update(group.store, ranges.data(), ranges.size(), flags);
+
+    for (size_t k = 0; k < simulated.size(); ++k)
+    {
+        ParticleKernel::Range const & range = ranges[k];
+        uint8_t *                     chunk = flags ? flags + (range.begin - first) : nullptr;
+        simulated[k]->endUpdate(simulated[k]->finishChunk(*range.context, 0, range.end - range.begin, chunk));
     }
 }
 
+//! Emitters that are not in the view frustum of their appearance's camera are not drawn, and each emitter that is drawn
+//! knows which of its chunks of particles are visible.
+
 void ParticleSystem::draw() const
 {
-    // For each emitter, draw all its particles
+    // Most emitters share a camera, so the frustum of each camera is only computed once
+
+    std::vector<std::pair<Vkx::Camera const *, Frustum>> frustums;
+
+    for (auto const & emitter : emitters_)
+    {
+        if (!emitter->enabled())
+            continue;
+
+        Vkx::Camera const * camera = emitter->appearance()->camera;
+        if (camera)
+        {
+            auto entry = std::find_if(frustums.begin(), frustums.end(), [camera] (auto const & f) {
+                                          return f.first == camera;
+                                      });
+            if (entry == frustums.end())
+            {
+                frustums.emplace_back(camera, Frustum(camera->viewProjection()));
+                entry = frustums.end() - 1;
+            }
 
+            emitter->cull(entry->second);
+            if (!emitter->visible())
+                continue;
+        }
+
+        emitter->draw();
+    }
+}
+
+size_t ParticleSystem::aliveCount() const
+{
+    size_t count = 0;
     for (auto const & emitter : emitters_)
     {
         if (emitter->enabled())
-            emitter->draw();
+            count += emitter->aliveCount();
     }
+    return count;
 }
 } // namespace Confetti
@@ -0,0 +1,79 @@
+#include "PlaneSet.h"
+
+#include <cassert>
+
+namespace Confetti
+{
+void PlaneSet::clear()
+{
+    size_ = 0;
+    a_.clear();
+    b_.clear();
+    c_.clear();
+    d_.clear();
+    dampening_.clear();
+}
+
+//! @param  plane       The plane (a, b, c, d)
+//! @param  dampening   Dampening of a surface (ignored for clip planes)
+
+void PlaneSet::add(glm::vec4 const & plane, float dampening /*= 0.0f*/)
+{
+    // Start a new packet of null planes if the last one is full
+
+    if (size_ == a_.size())
+    {
+        size_t padded = size_ + PACKET_SIZE;
+        a_.resize(padded, 0.0f);
+        b_.resize(padded, 0.0f);
+        c_.resize(padded, 0.0f);
+        d_.resize(padded, 0.0f);
+        dampening_.resize(padded, 0.0f);
+    }
+
+    a_[size_]         = plane.x;
+    b_[size_]         = plane.y;
+    c_[size_]         = plane.z;
+    d_[size_]         = plane.w;
+    dampening_[size_] = dampening;
+    ++size_;
+}
+
+//! @param  box     The box to test
+//!
+//! As in the particle kernels, a point is behind a plane if a * x + b * y + c * z < 0. An empty box is in front of
+//! every plane.
+
+bool PlaneSet::inFront(BoundingBox const & box) const
+{
+    if (box.empty())
+        return true;
+
+    for (size_t i = 0; i < size_; ++i)
+    {
+        // The corner of the box farthest behind the plane
+        glm::vec3 corner(a_[i] >= 0.0f ? box.min.x : box.max.x,
+                         b_[i] >= 0.0f ? box.min.y : box.max.y,
+                         c_[i] >= 0.0f ? box.min.z : box.max.z);
+        if (a_[i] * corner.x + b_[i] * corner.y + c_[i] * corner.z < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+//! @param  i   Index of the plane
+
+glm::vec4 PlaneSet::plane(size_t i) const
+{
+    assert(i < size_);
+    return glm::vec4(a_[i], b_[i], c_[i], d_[i]);
+}
+
+//! @param  i   Index of the plane
+
+float PlaneSet::dampening(size_t i) const
+{
+    assert(i < size_);
+    return dampening_[i];
+}
+} // namespace Confetti
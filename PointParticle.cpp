@@ -1,8 +1,5 @@
 #include "PointParticle.h"
 
-#include "Appearance.h"
-#include "Emitter.h"
-
 #include <glm/glm.hpp>
 
 namespace Confetti
@@ -39,15 +36,4 @@ void PointParticle::Initialize(float             lifetime,
 {
     Particle::initialize(lifetime, age, position, velocity, color);
 }
-
-bool PointParticle::update(float dt)
-{
-    return Particle::update(dt);
-}
-
-void PointParticle::draw(std::shared_ptr<Vkx::Device> device) const
-{
-    // Nothing to do. The particles are drawn by the emitter. This function should not be called.
-    assert(false);
-}
 } // namespace Confetti
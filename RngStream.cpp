@@ -0,0 +1,151 @@
+#include "RngStream.h"
+
+namespace
+{
+// Philox4x32-10 constants
+int constexpr      ROUNDS = 10;
+uint32_t constexpr M0     = 0xD2511F53;
+uint32_t constexpr M1     = 0xCD9E8D57;
+uint32_t constexpr W0     = 0x9E3779B9;
+uint32_t constexpr W1     = 0xBB67AE85;
+} // anonymous namespace
+
+namespace Confetti
+{
+//! @param  n   Number of numbers to skip
+
+void RngStream::discard(uint64_t n)
+{
+    // Use up the rest of the buffer first
+    while (n > 0 && index_ < 4)
+    {
+        ++index_;
+        --n;
+    }
+
+    // Skip whole blocks by advancing the counter
+    uint64_t counter = ((uint64_t)counter_[1] << 32 | counter_[0]) + n / 4;
+    counter_[0] = (uint32_t)counter;
+    counter_[1] = (uint32_t)(counter >> 32);
+
+    for (n %= 4; n > 0; --n)
+    {
+        operator ()();
+    }
+}
+
+//! @param  values  Receives the numbers
+//!
+//! Whole blocks are generated directly into the list, without going through the buffer. The rounds of LANES blocks are
+//! computed together, one lane at a time, so that the compiler can vectorize them.
+
+void RngStream::uniform(Span<float> const & values)
+{
+    size_t const n = values.size();
+    size_t       i = 0;
+
+    // Use up the rest of the buffer first
+    for (; i < n && index_ < 4; ++i)
+    {
+        values[i] = uniform();
+    }
+
+    uint64_t     counter = (uint64_t)counter_[1] << 32 | counter_[0];
+    float *      out     = values.data() + i;
+    size_t const blocks  = (n - i) / 4;
+    size_t       b       = 0;
+    for (; b + LANES <= blocks; b += LANES)
+    {
+        uint32_t c0[LANES], c1[LANES], c2[LANES], c3[LANES];
+        for (size_t l = 0; l < LANES; ++l)
+        {
+            uint64_t const c = counter + b + l;
+            c0[l] = (uint32_t)c;
+            c1[l] = (uint32_t)(c >> 32);
+            c2[l] = counter_[2];
+            c3[l] = counter_[3];
+        }
+
+        Key key = key_;
+        for (int round = 0; round < ROUNDS; ++round)
+        {
+            for (size_t l = 0; l < LANES; ++l)
+            {
+                uint64_t const p0 = (uint64_t)M0 * c0[l];
+                uint64_t const p1 = (uint64_t)M1 * c2[l];
+                uint32_t const x0 = (uint32_t)(p1 >> 32) ^ c1[l] ^ key[0];
+                uint32_t const x2 = (uint32_t)(p0 >> 32) ^ c3[l] ^ key[1];
+                c0[l] = x0;
+                c1[l] = (uint32_t)p1;
+                c2[l] = x2;
+                c3[l] = (uint32_t)p0;
+            }
+            key[0] += W0;
+            key[1] += W1;
+        }
+
+        for (size_t l = 0; l < LANES; ++l)
+        {
+            float * block = out + 4 * (b + l);
+            block[0] = toUniform(c0[l]);
+            block[1] = toUniform(c1[l]);
+            block[2] = toUniform(c2[l]);
+            block[3] = toUniform(c3[l]);
+        }
+    }
+    for (; b < blocks; ++b)
+    {
+        uint64_t const c     = counter + b;
+        Block const    block = philox({ { (uint32_t)c, (uint32_t)(c >> 32), counter_[2], counter_[3] } }, key_);
+        for (int j = 0; j < 4; ++j)
+        {
+            out[4 * b + j] = toUniform(block[j]);
+        }
+    }
+    counter    += blocks;
+    counter_[0] = (uint32_t)counter;
+    counter_[1] = (uint32_t)(counter >> 32);
+    i          += 4 * blocks;
+
+    for (; i < n; ++i)
+    {
+        values[i] = uniform();
+    }
+}
+
+//! @param  counter     The counter
+//! @param  key         The key
+//!
+//! @return     4 random numbers
+
+RngStream::Block RngStream::philox(Block counter, Key key)
+{
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        uint64_t p0 = (uint64_t)M0 * counter[0];
+        uint64_t p1 = (uint64_t)M1 * counter[2];
+        counter = { { (uint32_t)(p1 >> 32) ^ counter[1] ^ key[0],
+                      (uint32_t)p1,
+                      (uint32_t)(p0 >> 32) ^ counter[3] ^ key[1],
+                      (uint32_t)p0 } };
+        key[0] += W0;
+        key[1] += W1;
+    }
+    return counter;
+}
+
+//! @param  name    The name
+//!
+//! @return     a 32-bit FNV-1a hash of the name
+
+uint32_t RngStream::id(std::string const & name)
+{
+    uint32_t hash = 2166136261u;
+    for (char c : name)
+    {
+        hash ^= (uint8_t)c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+} // namespace Confetti
@@ -0,0 +1,164 @@
+#include "SamplePool.h"
+
+#include <Confetti/Random.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+int constexpr BITS = 32;
+
+// Direction numbers of a dimension of a Sobol sequence
+struct Directions
+{
+    uint32_t v[BITS];
+
+    // The first dimension is the van der Corput sequence, which has no polynomial
+    Directions()
+    {
+        for (int k = 0; k < BITS; ++k)
+        {
+            v[k] = 1u << (BITS - 1 - k);
+        }
+    }
+
+    // Computes the direction numbers of a primitive polynomial of degree s with coefficients a, and initial numbers m
+    Directions(int s, uint32_t a, std::initializer_list<uint32_t> m)
+    {
+        assert((int)m.size() == s);
+        int k = 0;
+        for (uint32_t mk : m)
+        {
+            v[k] = mk << (BITS - 1 - k);
+            ++k;
+        }
+        for (; k < BITS; ++k)
+        {
+            uint32_t x = v[k - s] ^ (v[k - s] >> s);
+            for (int j = 1; j < s; ++j)
+            {
+                if ((a >> (s - 1 - j)) & 1)
+                    x ^= v[k - j];
+            }
+            v[k] = x;
+        }
+    }
+
+    // Returns the coordinate of point i
+    uint32_t operator ()(uint32_t i) const
+    {
+        uint32_t x = 0;
+        for (int k = 0; i != 0; ++k, i >>= 1)
+        {
+            if (i & 1)
+                x ^= v[k];
+        }
+        return x;
+    }
+};
+
+// The first three dimensions of the Joe-Kuo direction numbers
+Directions const DIRECTIONS[3] = { Directions(), Directions(1, 0, { 1 }), Directions(2, 1, { 1, 3 }) };
+
+// Returns the start of a random block of a pool for n points. The block starts at a multiple of the smallest power of 2
+// that is at least n, or of the size of the pool if it is smaller.
+size_t blockStart(Confetti::RngStream & rng, size_t n, size_t size)
+{
+    size_t block = 1;
+    while (block < n && block < size)
+    {
+        block *= 2;
+    }
+    return ((size_t)rng() * block) & (size - 1);
+}
+} // anonymous namespace
+
+namespace Confetti
+{
+//! @param  volume  The volume containing the points
+//! @param  size    Number of points in the pool
+
+SamplePool::SamplePool(std::shared_ptr<EmitterVolume const> volume, size_t size)
+    : volume_(volume)
+{
+    assert(volume_);
+    size_t n = 1;
+    while (n < size)
+    {
+        n *= 2;
+    }
+
+    u_.resize(n);
+    v_.resize(n);
+    w_.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        u_[i] = DIRECTIONS[0]((uint32_t)i);
+        v_[i] = DIRECTIONS[1]((uint32_t)i);
+        w_[i] = DIRECTIONS[2]((uint32_t)i);
+    }
+}
+
+glm::vec3 SamplePool::operator [](size_t i) const
+{
+    return volume_->point(toUniform(u_[i]), toUniform(v_[i]), toUniform(w_[i]));
+}
+
+//! @param  i   Index of the point
+//!
+//! The points are in the natural order rather than the Gray code order, so that every block of 2^m points starting at
+//! a multiple of 2^m is a digitally shifted copy of the first 2^m points.
+
+glm::vec3 SamplePool::sobol(uint32_t i)
+{
+    return glm::vec3(toUniform(DIRECTIONS[0](i)), toUniform(DIRECTIONS[1](i)), toUniform(DIRECTIONS[2](i)));
+}
+
+glm::vec3 SamplePool::point(float u, float, float) const
+{
+    size_t const n = size();
+    return (*this)[std::min((size_t)(u * (float)n), n - 1)];
+}
+
+//! @param  points  Receives the points
+//! @param  rng     Selects the block of points and the scramble
+
+void SamplePool::sample(Vec3Span<float> const & points, RngStream & rng) const
+{
+    size_t const start = blockStart(rng, points.size(), size());
+    copy(points, start, rng);
+}
+
+//! @param  points  Receives the points of the part
+//! @param  rng     Selects the block of points and the scramble of the list
+//! @param  offset  Index in the list of the first point of the part
+//! @param  total   Number of points in the list
+
+void SamplePool::sample(Vec3Span<float> const & points, RngStream const & rng, size_t offset, size_t total) const
+{
+    RngStream    list  = rng;
+    size_t const start = blockStart(list, total, size());
+    copy(points, start + offset, list);
+}
+
+// Maps consecutive points starting at a point to the volume, wrapping around the end of the pool. The coordinates are
+// scrambled with random bits drawn from the stream.
+void SamplePool::copy(Vec3Span<float> const & points, size_t start, RngStream & rng) const
+{
+    uint32_t const su = rng();
+    uint32_t const sv = rng();
+    uint32_t const sw = rng();
+
+    size_t const n    = points.size();
+    size_t const mask = size() - 1;
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t const    j = (start + i) & mask;
+        glm::vec3 const p = volume_->point(toUniform(u_[j] ^ su), toUniform(v_[j] ^ sv), toUniform(w_[j] ^ sw));
+        points.x[i] = p.x;
+        points.y[i] = p.y;
+        points.z[i] = p.z;
+    }
+}
+} // namespace Confetti
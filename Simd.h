@@ -0,0 +1,130 @@
+#if !defined(CONFETTI_SIMD_H)
+#define CONFETTI_SIMD_H
+
+#pragma once
+
+// Thin wrappers around the x86 vector instruction sets used by the particle kernels. Each wrapper is only defined if
+// the translation unit including this file is compiled for the instruction set it uses, and they are all in an
+// anonymous namespace so that code compiled for different instruction sets is never merged by the linker.
+
+#if defined(CONFETTI_SIMD_X86)
+
+#include <immintrin.h>
+
+namespace
+{
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+// 4 lanes using SSE2
+struct Sse2
+{
+    static int constexpr WIDTH = 4;
+
+    using Float = __m128;
+    using Mask  = __m128;
+
+    static Float load(float const * p)     { return _mm_loadu_ps(p); }
+    static void  store(float * p, Float v) { _mm_storeu_ps(p, v); }
+    static Float set(float f)              { return _mm_set1_ps(f); }
+
+    static Float add(Float a, Float b) { return _mm_add_ps(a, b); }
+    static Float sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+    static Float mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+    static Float div(Float a, Float b) { return _mm_div_ps(a, b); }
+    static Float min(Float a, Float b) { return _mm_min_ps(a, b); }
+    static Float max(Float a, Float b) { return _mm_max_ps(a, b); }
+
+    static Mask lt(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+    static Mask ge(Float a, Float b) { return _mm_cmpge_ps(a, b); }
+
+    static Mask none()                   { return _mm_setzero_ps(); }
+    static Mask maskAnd(Mask a, Mask b)    { return _mm_and_ps(a, b); }
+    static Mask maskOr(Mask a, Mask b)     { return _mm_or_ps(a, b); }
+    static Mask maskAndNot(Mask a, Mask b) { return _mm_andnot_ps(b, a); }  // a & ~b
+    static bool any(Mask m)                { return _mm_movemask_ps(m) != 0; }
+    static int  bits(Mask m)               { return _mm_movemask_ps(m); }  // One bit per lane
+
+    // Returns a where m is set, otherwise b
+    static Float select(Mask m, Float a, Float b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+};
+
+#endif // defined(__SSE2__) || ...
+
+#if defined(__AVX2__)
+
+// 8 lanes using AVX2
+struct Avx2
+{
+    static int constexpr WIDTH = 8;
+
+    using Float = __m256;
+    using Mask  = __m256;
+
+    static Float load(float const * p)     { return _mm256_loadu_ps(p); }
+    static void  store(float * p, Float v) { _mm256_storeu_ps(p, v); }
+    static Float set(float f)              { return _mm256_set1_ps(f); }
+
+    static Float add(Float a, Float b) { return _mm256_add_ps(a, b); }
+    static Float sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+    static Float mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+    static Float div(Float a, Float b) { return _mm256_div_ps(a, b); }
+    static Float min(Float a, Float b) { return _mm256_min_ps(a, b); }
+    static Float max(Float a, Float b) { return _mm256_max_ps(a, b); }
+
+    static Mask lt(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static Mask ge(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+
+    static Mask none()                   { return _mm256_setzero_ps(); }
+    static Mask maskAnd(Mask a, Mask b)    { return _mm256_and_ps(a, b); }
+    static Mask maskOr(Mask a, Mask b)     { return _mm256_or_ps(a, b); }
+    static Mask maskAndNot(Mask a, Mask b) { return _mm256_andnot_ps(b, a); }  // a & ~b
+    static bool any(Mask m)                { return _mm256_movemask_ps(m) != 0; }
+    static int  bits(Mask m)               { return _mm256_movemask_ps(m); }  // One bit per lane
+
+    // Returns a where m is set, otherwise b
+    static Float select(Mask m, Float a, Float b) { return _mm256_blendv_ps(b, a, m); }
+};
+
+#endif // defined(__AVX2__)
+
+#if defined(__AVX512F__)
+
+// 16 lanes using AVX-512
+struct Avx512
+{
+    static int constexpr WIDTH = 16;
+
+    using Float = __m512;
+    using Mask  = __mmask16;
+
+    static Float load(float const * p)     { return _mm512_loadu_ps(p); }
+    static void  store(float * p, Float v) { _mm512_storeu_ps(p, v); }
+    static Float set(float f)              { return _mm512_set1_ps(f); }
+
+    static Float add(Float a, Float b) { return _mm512_add_ps(a, b); }
+    static Float sub(Float a, Float b) { return _mm512_sub_ps(a, b); }
+    static Float mul(Float a, Float b) { return _mm512_mul_ps(a, b); }
+    static Float div(Float a, Float b) { return _mm512_div_ps(a, b); }
+    static Float min(Float a, Float b) { return _mm512_min_ps(a, b); }
+    static Float max(Float a, Float b) { return _mm512_max_ps(a, b); }
+
+    static Mask lt(Float a, Float b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static Mask ge(Float a, Float b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+
+    static Mask none()                   { return 0; }
+    static Mask maskAnd(Mask a, Mask b)    { return a & b; }
+    static Mask maskOr(Mask a, Mask b)     { return a | b; }
+    static Mask maskAndNot(Mask a, Mask b) { return a & ~b; }
+    static bool any(Mask m)                { return m != 0; }
+    static int  bits(Mask m)               { return m; }  // One bit per lane
+
+    // Returns a where m is set, otherwise b
+    static Float select(Mask m, Float a, Float b) { return _mm512_mask_blend_ps(m, b, a); }
+};
+
+#endif // defined(__AVX512F__)
+} // anonymous namespace
+
+#endif // defined(CONFETTI_SIMD_X86)
+
+#endif // !defined(CONFETTI_SIMD_H)
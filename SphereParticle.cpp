@@ -1,9 +1,5 @@
 #include "SphereParticle.h"
 
-#include "Appearance.h"
-#include "Emitter.h"
-#include "Environment.h"
-
 #include <glm/glm.hpp>
 
 namespace Confetti
@@ -22,7 +18,7 @@ SphereParticle::SphereParticle(float             lifetime,
                                glm::vec4 const & color,
                                float             radius)
     : Particle(lifetime, age, position, velocity, color)
-    , initialRadius_(radius)
+    , radius_(radius)
 {
 }
 
@@ -42,34 +38,6 @@ void SphereParticle::Initialize(float             lifetime,
 {
     Particle::initialize(lifetime, age, position, velocity, color);
 
-    initialRadius_ = radius;
-}
-
-//!
-//! @param	dt	The amount of time that has passed since the last update
-
-bool SphereParticle::update(float dt)
-{
-    // Update base class
-
-    bool const reborn = Particle::update(dt);
-
-    if (reborn)
-    {
-        radius_ = initialRadius_;
-        dt      = age_;
-    }
-
-    // Update size and rotation
-
-    radius_ += dt * emitter_->appearance()->radiusRate;
-
-    return reborn;
-}
-
-void SphereParticle::draw(std::shared_ptr<Vkx::Device> device) const
-{
-    // Nothing to do because the particle is drawn by the emitter. This function should not be called.
-    assert(false);
+    radius_ = radius;
 }
 } // namespace Confetti
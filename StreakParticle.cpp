@@ -1,8 +1,5 @@
 #include "StreakParticle.h"
 
-#include "Appearance.h"
-#include "Emitter.h"
-
 namespace Confetti
 {
 // Vertex shader data declaration info
@@ -14,7 +11,6 @@ namespace Confetti
 //     D3DDECL_END()
 // };
 
-//! @param	pEmitter		The emitter that controls this particle
 //! @param	lifetime		How long the particle lives.
 //! @param	age				Initial age.
 //! @param	position		Position at birth.
@@ -44,24 +40,4 @@ void StreakParticle::Initialize(float             lifetime,
 {
     Particle::initialize(lifetime, age, position, velocity, color);
 }
-
-bool StreakParticle::update(float dt)
-{
-    bool reborn;
-
-    reborn = Particle::update(dt);
-
-    if (reborn)
-        dt = age_;
-
-    // Update the location of the tail
-    tail_ = position_ - velocity_ * dt;
-    return reborn;
-}
-
-void StreakParticle::draw(std::shared_ptr<Vkx::Device> device) const
-{
-    // Nothing to do here because all drawing is done by the emitter. This function should not be called
-    assert(false);
-}
 } // namespace Confetti
@@ -1,9 +1,5 @@
 #include "TexturedParticle.h"
 
-#include "Appearance.h"
-#include "Emitter.h"
-#include "Environment.h"
-
 #include <glm/glm.hpp>
 
 namespace Confetti
@@ -36,9 +32,7 @@ TexturedParticle::TexturedParticle(float             lifetime,
                                    float             radius,
                                    float             rotation /* = 0.0f*/)
     : Particle(lifetime, age, position, velocity, color)
-    , initialRadius_(radius)
     , radius_(radius)
-    , initialRotation_(rotation)
     , rotation_(rotation)
 {
 }
@@ -61,42 +55,7 @@ void TexturedParticle::Initialize(float             lifetime,
 {
     Particle::initialize(lifetime, age, position, velocity, color);
 
-    initialRadius_   = radius;
-    initialRotation_ = rotation;
-
     radius_   = radius;
     rotation_ = rotation;
 }
-
-//!
-//! @param	dt	The amount of time that has passed since the last update
-
-bool TexturedParticle::update(float dt)
-{
-    // Update base class
-
-    bool const reborn = Particle::update(dt);
-
-    if (reborn)
-    {
-        radius_   = initialRadius_;
-        rotation_ = initialRotation_;
-        dt        = age_;
-    }
-
-    std::shared_ptr<Appearance> pA = emitter_->appearance();
-
-    // Update size and rotation
-
-    radius_   += dt * pA->radiusRate;
-    rotation_ += dt * pA->angularVelocity;
-
-    return reborn;
-}
-
-void TexturedParticle::draw(std::shared_ptr<Vkx::Device> device) const
-{
-    // Nothing to do because the particle is drawn by the emitter. This function should not be called.
-    assert(false);
-}
 } // namespace Confetti
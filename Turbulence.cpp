@@ -0,0 +1,140 @@
+#include "Turbulence.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+namespace Confetti
+{
+namespace
+{
+// Seeds for the noise of each component of the potential
+uint32_t constexpr SEED_X = 0x9E3779B9u;
+uint32_t constexpr SEED_Y = 0x7F4A7C15u;
+uint32_t constexpr SEED_Z = 0x94D049BBu;
+
+// Hashes the coordinates of a lattice point. Arithmetic is used instead of a permutation table so that the noise can
+// be vectorized.
+inline uint32_t hash(int32_t x, int32_t y, int32_t z, uint32_t seed)
+{
+    uint32_t h = ((uint32_t)x * 73856093u) ^ ((uint32_t)y * 19349663u) ^ ((uint32_t)z * 83492791u) ^ seed;
+    h ^= h >> 13;
+    h *= 0x5BD1E995u;
+    h ^= h >> 15;
+    return h;
+}
+
+// Returns one of the gradients (+/-1, +/-1, +/-1), selected by the low bits of a hash
+inline glm::vec3 gradient(uint32_t h)
+{
+    return glm::vec3((float)(int)((h & 1) << 1) - 1.0f,
+                     (float)(int)(h & 2) - 1.0f,
+                     (float)(int)((h & 4) >> 1) - 1.0f);
+}
+
+// Returns the gradient of a 3D gradient noise with quintic interpolation.
+//
+// The noise is n = k0 + k1 u + k2 v + k3 w + k4 u v + k5 v w + k6 w u + k7 u v w, where (u, v, w) is the fade of
+// the position in the cell and the k's are combinations of the dot products at the corners. Its gradient is the
+// same combination of the corner gradients plus the derivative of the fade times the partial derivatives of the
+// polynomial.
+//
+// Source: Inigo Quilez, "Gradient Noise Derivatives"
+inline glm::vec3 noiseGradient(glm::vec3 const & q, uint32_t seed)
+{
+    glm::vec3 const cell = glm::floor(q);
+    glm::vec3 const f    = q - cell;
+    int32_t const   x    = (int32_t)cell.x;
+    int32_t const   y    = (int32_t)cell.y;
+    int32_t const   z    = (int32_t)cell.z;
+
+    glm::vec3 const u  = f * f * f * (f * (f * 6.0f - 15.0f) + 10.0f);
+    glm::vec3 const du = f * f * (f * (f - 2.0f) + 1.0f) * 30.0f;
+
+    glm::vec3 const ga = gradient(hash(x,     y,     z,     seed));
+    glm::vec3 const gb = gradient(hash(x + 1, y,     z,     seed));
+    glm::vec3 const gc = gradient(hash(x,     y + 1, z,     seed));
+    glm::vec3 const gd = gradient(hash(x + 1, y + 1, z,     seed));
+    glm::vec3 const ge = gradient(hash(x,     y,     z + 1, seed));
+    glm::vec3 const gf = gradient(hash(x + 1, y,     z + 1, seed));
+    glm::vec3 const gg = gradient(hash(x,     y + 1, z + 1, seed));
+    glm::vec3 const gh = gradient(hash(x + 1, y + 1, z + 1, seed));
+
+    float const va = glm::dot(ga, f);
+    float const vb = glm::dot(gb, f - glm::vec3(1.0f, 0.0f, 0.0f));
+    float const vc = glm::dot(gc, f - glm::vec3(0.0f, 1.0f, 0.0f));
+    float const vd = glm::dot(gd, f - glm::vec3(1.0f, 1.0f, 0.0f));
+    float const ve = glm::dot(ge, f - glm::vec3(0.0f, 0.0f, 1.0f));
+    float const vf = glm::dot(gf, f - glm::vec3(1.0f, 0.0f, 1.0f));
+    float const vg = glm::dot(gg, f - glm::vec3(0.0f, 1.0f, 1.0f));
+    float const vh = glm::dot(gh, f - glm::vec3(1.0f, 1.0f, 1.0f));
+
+    float const k1 = vb - va;
+    float const k2 = vc - va;
+    float const k3 = ve - va;
+    float const k4 = va - vb - vc + vd;
+    float const k5 = va - vc - ve + vg;
+    float const k6 = va - vb - ve + vf;
+    float const k7 = -va + vb + vc - vd + ve - vf - vg + vh;
+
+    glm::vec3 const g = ga + (gb - ga) * u.x + (gc - ga) * u.y + (ge - ga) * u.z +
+                        (ga - gb - gc + gd) * (u.x * u.y) + (ga - gc - ge + gg) * (u.y * u.z) +
+                        (ga - gb - ge + gf) * (u.z * u.x) + (-ga + gb + gc - gd + ge - gf - gg + gh) * (u.x * u.y * u.z);
+
+    return g + du * glm::vec3(k1 + k4 * u.y + k6 * u.z + k7 * u.y * u.z,
+                              k2 + k5 * u.z + k4 * u.x + k7 * u.z * u.x,
+                              k3 + k6 * u.x + k5 * u.y + k7 * u.x * u.y);
+}
+} // anonymous namespace
+
+//! @param  frequency   Number of noise features per unit of distance
+//! @param  amplitude   Scale of the velocity
+//! @param  scroll      Velocity of the noise pattern
+
+Turbulence::Turbulence(float frequency /*= 1.0f*/, float amplitude /*= 0.0f*/, glm::vec3 const & scroll /*= 0*/)
+    : frequency_(frequency)
+    , amplitude_(amplitude)
+    , scroll_(scroll)
+{
+}
+
+//! @param  p       The point
+//! @param  time    The time
+//!
+//! @return     the velocity
+
+glm::vec3 Turbulence::velocity(glm::vec3 const & p, float time) const
+{
+    glm::vec3 v(0.0f);
+    addVelocities(Vec3Span<float const>{ { &p.x, 1 }, { &p.y, 1 }, { &p.z, 1 } },
+                  time,
+                  Vec3Span<float>{ { &v.x, 1 }, { &v.y, 1 }, { &v.z, 1 } });
+    return v;
+}
+
+//! @param  positions   The points
+//! @param  time        The time
+//! @param  velocities  The velocities at the points are added to these velocities
+//!
+//! The velocity is the curl of the potential (nx, ny, nz), where each component is an independent gradient noise
+//! sampled at (p - scroll * time) * frequency. The noise has no tables or branches, so the loop can be vectorized.
+
+void Turbulence::addVelocities(Vec3Span<float const> const & positions,
+                               float                         time,
+                               Vec3Span<float> const &       velocities) const
+{
+    assert(velocities.size() == positions.size());
+
+    glm::vec3 const offset = scroll_ * time;
+    size_t const    n      = positions.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        glm::vec3 const q  = (positions[i] - offset) * frequency_;
+        glm::vec3 const dx = noiseGradient(q, SEED_X);
+        glm::vec3 const dy = noiseGradient(q, SEED_Y);
+        glm::vec3 const dz = noiseGradient(q, SEED_Z);
+        glm::vec3 const curl(dz.y - dy.z, dx.z - dz.x, dy.x - dx.y);
+        velocities.set(i, velocities[i] + curl * amplitude_);
+    }
+}
+} // namespace Confetti
@@ -0,0 +1,50 @@
+#include "UpdateContext.h"
+
+#include "Appearance.h"
+#include "Environment.h"
+#include "PlaneSet.h"
+
+namespace Confetti
+{
+//! @param  environment     The emitter's environment.
+//! @param  appearance      The emitter's appearance.
+//! @param  position        The emitter's position.
+//! @param  velocity        The emitter's velocity.
+//! @param  dt              Amount of time elapsed since the last update
+
+UpdateContext::UpdateContext(Environment const & environment,
+                             Appearance const &  appearance,
+                             glm::vec3 const &   position,
+                             glm::vec3 const &   velocity,
+                             float               dt)
+    : dt_(dt)
+    , emitterPosition_(position)
+    , emitterVelocity_(velocity)
+    , gravity_(environment.gravity())
+    , airFriction_(environment.airFriction())
+    , terminalVelocity_(environment.terminalVelocity())
+    , terminalDistance_(environment.terminalDistance())
+    , ect1_(environment.ect1())
+    , windField_(environment.windField().get())
+    , turbulence_(environment.turbulence().enabled() ? &environment.turbulence() : nullptr)
+    , time_(environment.time())
+    , colorRate_(appearance.colorRate)
+    , radiusRate_(appearance.radiusRate)
+    , angularVelocity_(appearance.angularVelocity)
+    , clippers_(&environment.clipperPlanes())
+    , surfaces_(&environment.surfacePlanes())
+    , collisionWorld_(environment.collisionWorld().get())
+    , colliders_(&environment.colliders())
+{
+}
+
+UpdateContext UpdateContext::withoutPlanes() const
+{
+    static PlaneSet const NO_PLANES;
+
+    UpdateContext context(*this);
+    context.clippers_ = &NO_PLANES;
+    context.surfaces_ = &NO_PLANES;
+    return context;
+}
+} // namespace Confetti
@@ -0,0 +1,137 @@
+#include "WindField.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Confetti
+{
+//! @param  size        Number of samples along each axis (at least 2)
+//! @param  origin      Position of the first sample
+//! @param  spacing     Distance between adjacent samples
+
+WindField::WindField(glm::ivec3 const & size, glm::vec3 const & origin, float spacing)
+    : size_(size)
+    , origin_(origin)
+    , spacing_(spacing)
+    , velocities_((size_t)size.x * size.y * size.z, glm::vec3(0.0f))
+    , maxSpeed_(0.0f)
+{
+    assert(size.x >= 2 && size.y >= 2 && size.z >= 2);
+    assert(spacing > 0.0f);
+}
+
+//! @param  size        Number of samples along each axis (at least 2)
+//! @param  origin      Position of the first sample
+//! @param  spacing     Distance between adjacent samples
+//! @param  velocities  Velocity at each sample, with x varying fastest, then y, then z
+
+WindField::WindField(glm::ivec3 const &             size,
+                     glm::vec3 const &              origin,
+                     float                          spacing,
+                     std::vector<glm::vec3> const & velocities)
+    : WindField(size, origin, spacing)
+{
+    setVelocities(velocities);
+}
+
+//! @return     the region covered by the samples
+
+BoundingBox WindField::bounds() const
+{
+    return { origin_, origin_ + glm::vec3((float)(size_.x - 1), (float)(size_.y - 1), (float)(size_.z - 1)) * spacing_ };
+}
+
+//! @param  velocities  Velocity at each sample, with x varying fastest, then y, then z
+
+void WindField::setVelocities(std::vector<glm::vec3> const & velocities)
+{
+    assert(velocities.size() == velocities_.size());
+    velocities_ = velocities;
+    updateMaxSpeed();
+}
+
+//! @param  x           Index of the sample along the x axis
+//! @param  y           Index of the sample along the y axis
+//! @param  z           Index of the sample along the z axis
+//! @param  velocity    New velocity
+
+void WindField::setVelocity(int x, int y, int z, glm::vec3 const & velocity)
+{
+    velocities_[index(x, y, z)] = velocity;
+    maxSpeed_ = glm::max(maxSpeed_, glm::abs(velocity));
+}
+
+//! @param  p   The point
+//!
+//! @return     the velocity at the point
+
+glm::vec3 WindField::sample(glm::vec3 const & p) const
+{
+    glm::vec3 velocity;
+    sample(Vec3Span<float const>{ { &p.x, 1 }, { &p.y, 1 }, { &p.z, 1 } },
+           Vec3Span<float>{ { &velocity.x, 1 }, { &velocity.y, 1 }, { &velocity.z, 1 } });
+    return velocity;
+}
+
+//! @param  positions   The points
+//! @param  velocities  The velocities at the points
+//!
+//! Nearby particles are usually in the same cell, so the velocities at the corners of the last cell are kept and only
+//! loaded again when a particle is in a different cell.
+
+void WindField::sample(Vec3Span<float const> const & positions, Vec3Span<float> const & velocities) const
+{
+    assert(velocities.size() == positions.size());
+
+    glm::vec3 const scale(1.0f / spacing_);
+    glm::vec3 const limit((float)(size_.x - 1), (float)(size_.y - 1), (float)(size_.z - 1));
+    size_t const    dy = (size_t)size_.x;
+    size_t const    dz = (size_t)size_.x * size_.y;
+
+    size_t    cell = (size_t)-1;
+    glm::vec3 corner[8];
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        glm::vec3 g = glm::clamp((positions[i] - origin_) * scale, glm::vec3(0.0f), limit);
+        int x = std::min((int)g.x, size_.x - 2);
+        int y = std::min((int)g.y, size_.y - 2);
+        int z = std::min((int)g.z, size_.z - 2);
+
+        size_t const c = index(x, y, z);
+        if (c != cell)
+        {
+            cell      = c;
+            corner[0] = velocities_[c];
+            corner[1] = velocities_[c + 1];
+            corner[2] = velocities_[c + dy];
+            corner[3] = velocities_[c + dy + 1];
+            corner[4] = velocities_[c + dz];
+            corner[5] = velocities_[c + dz + 1];
+            corner[6] = velocities_[c + dz + dy];
+            corner[7] = velocities_[c + dz + dy + 1];
+        }
+
+        float fx = g.x - (float)x;
+        float fy = g.y - (float)y;
+        float fz = g.z - (float)z;
+
+        glm::vec3 c00 = corner[0] + (corner[1] - corner[0]) * fx;
+        glm::vec3 c10 = corner[2] + (corner[3] - corner[2]) * fx;
+        glm::vec3 c01 = corner[4] + (corner[5] - corner[4]) * fx;
+        glm::vec3 c11 = corner[6] + (corner[7] - corner[6]) * fx;
+        glm::vec3 c0  = c00 + (c10 - c00) * fy;
+        glm::vec3 c1  = c01 + (c11 - c01) * fy;
+        velocities.set(i, c0 + (c1 - c0) * fz);
+    }
+}
+
+void WindField::updateMaxSpeed()
+{
+    maxSpeed_ = glm::vec3(0.0f);
+    for (glm::vec3 const & v : velocities_)
+    {
+        maxSpeed_ = glm::max(maxSpeed_, glm::abs(v));
+    }
+}
+} // namespace Confetti
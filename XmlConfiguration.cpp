@@ -464,6 +464,9 @@ bool XmlConfiguration::processEnvironment(IXMLDOMElement * element, EnvironmentM
         //            <xsd:element name="WindVelocity" type="vector3" minOccurs="0" />
         //            <xsd:element name="Gustiness" type="xsd:float" minOccurs="0" />
         //            <xsd:element name="AirFriction" type="xsd:float" minOccurs="0" />
+        //            <xsd:element name="TurbulenceFrequency" type="xsd:float" minOccurs="0" />
+        //            <xsd:element name="TurbulenceAmplitude" type="xsd:float" minOccurs="0" />
+        //            <xsd:element name="TurbulenceScroll" type="vector3" minOccurs="0" />
         //            <xsd:element name="Bounce" type="xsd:string" minOccurs="0" />
         //            <xsd:element name="Clip" type="xsd:string" minOccurs="0" />
         //        </xsd:all>
@@ -477,6 +480,9 @@ bool XmlConfiguration::processEnvironment(IXMLDOMElement * element, EnvironmentM
         environment.windVelocity_ = GetVectorSubElement(element, "WindVelocity");
         environment.gustiness_    = Msxmlx::GetFloatSubElement(element, "Gustiness");
         environment.airFriction_  = Msxmlx::GetFloatSubElement(element, "AirFriction");
+        environment.turbulenceFrequency_ = Msxmlx::GetFloatSubElement(element, "TurbulenceFrequency", 1.0f);
+        environment.turbulenceAmplitude_ = Msxmlx::GetFloatSubElement(element, "TurbulenceAmplitude");
+        environment.turbulenceScroll_    = GetVectorSubElement(element, "TurbulenceScroll");
         environment.surface_      = Msxmlx::GetStringSubElement(element, "Bounce");
         environment.clip_         = Msxmlx::GetStringSubElement(element, "Clip");
 
@@ -564,6 +570,7 @@ bool XmlConfiguration::processVolume(IXMLDOMElement * element, EmitterVolumeMap
         //            <xsd:element name="Height" type="xsd:float" minOccurs="0" />
         //            <xsd:element name="Depth" type="xsd:float" minOccurs="0" />
         //            <xsd:element name="Radius" type="xsd:float" minOccurs="0" />
+        //            <xsd:element name="Samples" type="xsd:int" minOccurs="0" />
         //        </xsd:all>
         //        <xsd:attribute name="name" type="xsd:string" use="required" />
         //        <xsd:attribute name="type" type="volumetype" use="required" />
@@ -578,6 +585,7 @@ bool XmlConfiguration::processVolume(IXMLDOMElement * element, EmitterVolumeMap
         volume.height_ = Msxmlx::GetFloatSubElement(element, "Height", 1.);
         volume.depth_  = Msxmlx::GetFloatSubElement(element, "Depth", 1.);
         volume.radius_ = Msxmlx::GetFloatSubElement(element, "Radius", 1.);
+        volume.samples_ = Msxmlx::GetIntSubElement(element, "Samples");
 
 #if defined(_DEBUG)
         {
@@ -587,7 +595,8 @@ bool XmlConfiguration::processVolume(IXMLDOMElement * element, EmitterVolumeMap
                 << volume.width_ << ", "
                 << volume.height_ << ", "
                 << volume.depth_ << ", "
-                << volume.radius_ << " ) )"
+                << volume.radius_ << ", "
+                << volume.samples_ << " ) )"
                 << std::endl;
             OutputDebugString(msg.str().c_str());
         }
@@ -619,6 +628,8 @@ bool XmlConfiguration::processEmitter(IXMLDOMElement * element, EmitterMap & emi
         //            <xsd:element name="MinSpeed" type="xsd:float" />
         //            <xsd:element name="MaxSpeed" type="xsd:float" />
         //            <xsd:element name="Count" type="xsd:integer" />
+        //            <xsd:element name="Looping" type="xsd:boolean" minOccurs="0" />
+        //            <xsd:element name="Rate" type="xsd:float" minOccurs="0" />
         //            <xsd:element name="Lifetime" type="xsd:float" />
         //            <xsd:element name="Spread" type="xsd:float" />
         //            <xsd:element name="Color" type="rgba" minOccurs="0" />
@@ -640,6 +651,8 @@ bool XmlConfiguration::processEmitter(IXMLDOMElement * element, EmitterMap & emi
         emitter.orientation_ = GetQuatSubElement(element, "Orientation");
         emitter.velocity_    = GetVectorSubElement(element, "Velocity");
         emitter.count_       = Msxmlx::GetIntSubElement(element, "Count");
+        emitter.looping_     = Msxmlx::GetBoolSubElement(element, "Looping", true);
+        emitter.rate_        = Msxmlx::GetFloatSubElement(element, "Rate");
         emitter.lifetime_    = Msxmlx::GetFloatSubElement(element, "Lifetime", 1.0f);
         emitter.spread_      = Msxmlx::GetFloatSubElement(element, "Spread");
         emitter.minSpeed_    = Msxmlx::GetFloatSubElement(element, "MinSpeed");
@@ -660,6 +673,8 @@ bool XmlConfiguration::processEmitter(IXMLDOMElement * element, EmitterMap & emi
                 << "[" << emitter.position_ << "], "
                 << "[" << emitter.orientation_ << "], "
                 << emitter.count_ << ", "
+                << emitter.looping_ << ", "
+                << emitter.rate_ << ", "
                 << emitter.lifetime_ << ", "
                 << emitter.spread_ << ", "
                 << emitter.minSpeed_ << ", "
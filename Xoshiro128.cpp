@@ -0,0 +1,153 @@
+#include "Xoshiro128.h"
+
+namespace
+{
+// Returns the next number of a SplitMix64 generator, which is used to expand a seed into a state.
+//
+// Source: Steele, Lea, and Flood, "Fast Splittable Pseudorandom Number Generators", OOPSLA 2014
+uint64_t splitMix64(uint64_t & x)
+{
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Returns a state for a seed, stream, and substream. The three are mixed so that nearby values give unrelated states.
+Confetti::Xoshiro128::State seedState(uint64_t seed, uint32_t stream, uint32_t substream)
+{
+    uint64_t x  = seed;
+    uint64_t a  = splitMix64(x) ^ ((uint64_t)stream << 32 | substream);
+    uint64_t y  = a;
+    uint64_t s0 = splitMix64(y);
+    uint64_t s1 = splitMix64(y);
+
+    // The state must not be all zeros
+    if (s0 == 0 && s1 == 0)
+        s0 = 1;
+    return { { (uint32_t)s0, (uint32_t)(s0 >> 32), (uint32_t)s1, (uint32_t)(s1 >> 32) } };
+}
+} // anonymous namespace
+
+namespace Confetti
+{
+//! @param  seed        Seed of the whole system
+//! @param  stream      Identifies the stream (usually an object)
+//! @param  substream   Identifies the substream (usually a particle)
+
+Xoshiro128::Xoshiro128(uint64_t seed /*= 0*/, uint32_t stream /*= 0*/, uint32_t substream /*= 0*/)
+    : s_(seedState(seed, stream, substream))
+{
+}
+
+void Xoshiro128::jump()
+{
+    static uint32_t const JUMP[] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+
+    State s = { { 0, 0, 0, 0 } };
+    for (uint32_t word : JUMP)
+    {
+        for (int b = 0; b < 32; ++b)
+        {
+            if (word & (1u << b))
+            {
+                for (int j = 0; j < 4; ++j)
+                {
+                    s[j] ^= s_[j];
+                }
+            }
+            operator ()();
+        }
+    }
+    s_ = s;
+}
+
+//! @param  seed        Seed of the whole system
+//! @param  stream      Identifies the stream (usually an object)
+//! @param  substream   Identifies the substream (usually a particle)
+
+Xoshiro128x8::Xoshiro128x8(uint64_t seed /*= 0*/, uint32_t stream /*= 0*/, uint32_t substream /*= 0*/)
+    : index_(LANES)
+{
+    for (size_t l = 0; l < LANES; ++l)
+    {
+        Xoshiro128::State s = seedState(seed, stream, substream * (uint32_t)LANES + (uint32_t)l);
+        s0_[l] = s[0];
+        s1_[l] = s[1];
+        s2_[l] = s[2];
+        s3_[l] = s[3];
+    }
+}
+
+//! @param  values  Receives the numbers
+//!
+//! The state is copied to local arrays while the numbers are generated, so that the compiler knows that the list does
+//! not overlap it and can keep it in vector registers.
+
+void Xoshiro128x8::uniform(Span<float> const & values)
+{
+    size_t const n   = values.size();
+    float *      out = values.data();
+    size_t       i   = 0;
+
+    // Use up the rest of the buffer first
+    for (; i < n && index_ < LANES; ++i)
+    {
+        out[i] = toUniform(buffer_[index_++]);
+    }
+    if (i == n)
+        return;
+
+    uint32_t s0[LANES], s1[LANES], s2[LANES], s3[LANES], result[LANES];
+    for (size_t l = 0; l < LANES; ++l)
+    {
+        s0[l] = s0_[l];
+        s1[l] = s1_[l];
+        s2[l] = s2_[l];
+        s3[l] = s3_[l];
+    }
+
+    // Whole sets of lanes go directly into the list, and the last partial set goes through the buffer
+    for (; i < n; i += LANES)
+    {
+        for (size_t l = 0; l < LANES; ++l)
+        {
+            uint32_t const t = s1[l] << 9;
+            result[l] = s0[l] + s3[l];
+            s2[l] ^= s0[l];
+            s3[l] ^= s1[l];
+            s1[l] ^= s2[l];
+            s0[l] ^= s3[l];
+            s2[l] ^= t;
+            s3[l]  = (s3[l] << 11) | (s3[l] >> 21);
+        }
+
+        if (i + LANES <= n)
+        {
+            for (size_t l = 0; l < LANES; ++l)
+            {
+                out[i + l] = toUniform(result[l]);
+            }
+        }
+        else
+        {
+            for (size_t l = 0; l < LANES; ++l)
+            {
+                buffer_[l] = result[l];
+            }
+            for (index_ = 0; i + index_ < n; ++index_)
+            {
+                out[i + index_] = toUniform(buffer_[index_]);
+            }
+        }
+    }
+
+    for (size_t l = 0; l < LANES; ++l)
+    {
+        s0_[l] = s0[l];
+        s1_[l] = s1[l];
+        s2_[l] = s2[l];
+        s3_[l] = s3[l];
+    }
+}
+} // namespace Confetti
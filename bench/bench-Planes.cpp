@@ -0,0 +1,123 @@
+// Measures the cost of clip planes and surfaces when updating 100,000 particles.
+//
+// The particles are launched above a floor made of several surfaces and clip planes. Most particles are above all of
+// the planes, so most blocks of particles skip the planes after a single test.
+
+#include "Confetti/Appearance.h"
+#include "Confetti/Emitter.h"
+#include "Confetti/Environment.h"
+#include "Confetti/ParticleKernel.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace Confetti;
+
+namespace
+{
+int constexpr   NUMBER_OF_PARTICLES = 100000;
+int constexpr   NUMBER_OF_FRAMES    = 100;
+float constexpr DT                  = 1.0f / 60.0f;
+
+std::vector<PointParticle> makeParticles()
+{
+    std::minstd_rand                      rng(1);
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    std::vector<PointParticle>            particles;
+    particles.reserve(NUMBER_OF_PARTICLES);
+    for (int i = 0; i < NUMBER_OF_PARTICLES; ++i)
+    {
+        particles.emplace_back(2.0f + u(rng),
+                               -1.0f + u(rng),
+                               glm::vec3(u(rng), 5.0f + u(rng), u(rng)),
+                               glm::vec3(u(rng), 2.0f + u(rng), u(rng)),
+                               glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+    }
+    return particles;
+}
+
+// Returns an environment with the given number of surfaces and clip planes (at most 6 of each)
+std::shared_ptr<Environment> makeEnvironment(int planes)
+{
+    // A point is behind a plane if a * x + b * y + c * z < 0, so the planes all pass through the origin. They are
+    // the floor and tilted planes around it, and they are only hit by particles that fall below the floor.
+    static glm::vec4 const PLANES[] =
+    {
+        {  0.0f,  1.0f,  0.0f, 0.0f },
+        {  1.0f,  1.0f,  0.0f, 0.0f },
+        { -1.0f,  1.0f,  0.0f, 0.0f },
+        {  0.0f,  1.0f,  1.0f, 0.0f },
+        {  0.0f,  1.0f, -1.0f, 0.0f },
+        {  0.5f,  1.0f,  0.5f, 0.0f }
+    };
+
+    Environment::SurfaceList surfaces;
+    Environment::ClipperList clippers;
+    for (int i = 0; i < planes / 2; ++i)
+    {
+        surfaces.emplace_back(PLANES[i], 0.5f);
+        clippers.push_back(PLANES[(i + 3) % 6]);
+    }
+    return std::make_shared<Environment>(glm::vec3(0.0f, -9.8f, 0.0f),
+                                         0.0f,
+                                         glm::vec3(0.0f, 0.0f, 0.0f),
+                                         0.0f,
+                                         surfaces,
+                                         clippers);
+}
+
+std::shared_ptr<PointEmitter> makeEmitter(std::vector<PointParticle> const & particles, int planes)
+{
+    auto appearance = std::make_shared<Appearance>();
+    appearance->camera          = nullptr;
+    appearance->colorRate       = glm::vec4(0.0f, 0.0f, 0.0f, -0.5f);
+    appearance->radiusRate      = 0.0f;
+    appearance->angularVelocity = 0.0f;
+    appearance->size            = 1.0f;
+
+    return std::make_shared<PointEmitter>(nullptr, particles, nullptr, makeEnvironment(planes), appearance, false);
+}
+
+// Returns the average time to update one particle, in nanoseconds
+double measure(PointEmitter & emitter)
+{
+    using Clock = std::chrono::steady_clock;
+
+    emitter.update(DT);     // Warm up
+    Clock::time_point start = Clock::now();
+    for (int frame = 0; frame < NUMBER_OF_FRAMES; ++frame)
+    {
+        emitter.update(DT);
+    }
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    return elapsed.count() / (double(NUMBER_OF_FRAMES) * NUMBER_OF_PARTICLES);
+}
+} // anonymous namespace
+
+int main()
+{
+    std::vector<PointParticle> particles = makeParticles();
+
+    printf("%d particles, %d frames\n", NUMBER_OF_PARTICLES, NUMBER_OF_FRAMES);
+    printf("%-10s %12s %12s %12s\n", "kernel", "0 planes ns", "6 planes ns", "12 planes ns");
+
+    int const supported = (int)ParticleKernel::supportedInstructionSet();
+    for (int i = 0; i <= supported; ++i)
+    {
+        ParticleKernel::InstructionSet instructionSet = (ParticleKernel::InstructionSet)i;
+        ParticleKernel::setInstructionSet(instructionSet);
+
+        printf("%-10s", ParticleKernel::name(instructionSet));
+        for (int planes : { 0, 6, 12 })
+        {
+            std::shared_ptr<PointEmitter> emitter = makeEmitter(particles, planes);
+            printf(" %12.2f", measure(*emitter));
+        }
+        printf("\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Measures the throughput of the random number generators when generating floats in [0, 1), one at a time and in
+// batches, and compares them with std::minstd_rand and std::uniform_real_distribution.
+
+#include "Confetti/Random.h"
+#include "Confetti/RngStream.h"
+#include "Confetti/Xoshiro128.h"
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+using namespace Confetti;
+
+namespace
+{
+size_t constexpr NUMBER_OF_VALUES = 1 << 22;
+int constexpr    NUMBER_OF_RUNS   = 10;
+
+// Returns the average time to generate one float, in nanoseconds
+double measure(std::function<void(std::vector<float> &)> const & generate)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<float> values(NUMBER_OF_VALUES);
+    generate(values);   // Warm up
+
+    Clock::time_point start = Clock::now();
+    for (int run = 0; run < NUMBER_OF_RUNS; ++run)
+    {
+        generate(values);
+    }
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+
+    // Use the values so that the work is not optimized away
+    float sum = 0.0f;
+    for (float u : values)
+    {
+        sum += u;
+    }
+    if (sum < 0.0f)
+        printf("impossible\n");
+
+    return elapsed.count() / (double(NUMBER_OF_RUNS) * NUMBER_OF_VALUES);
+}
+} // anonymous namespace
+
+int main()
+{
+    printf("%zu floats, %d runs\n", NUMBER_OF_VALUES, NUMBER_OF_RUNS);
+    printf("%-40s %12s\n", "generator", "ns per float");
+
+    std::minstd_rand                      minstd(1);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    printf("%-40s %12.3f\n", "minstd_rand + uniform_real_distribution", measure([&](std::vector<float> & values) {
+               for (float & u : values)
+               {
+                   u = distribution(minstd);
+               }
+           }));
+
+    std::mt19937 mt(1);
+    printf("%-40s %12.3f\n", "mt19937 + uniform()", measure([&](std::vector<float> & values) {
+               for (float & u : values)
+               {
+                   u = uniform(mt);
+               }
+           }));
+
+    RngStream philox(1);
+    printf("%-40s %12.3f\n", "RngStream::uniform()", measure([&](std::vector<float> & values) {
+               for (float & u : values)
+               {
+                   u = philox.uniform();
+               }
+           }));
+    printf("%-40s %12.3f\n", "RngStream::uniform(Span)", measure([&](std::vector<float> & values) {
+               philox.uniform(values);
+           }));
+
+    Xoshiro128 xoshiro(1);
+    printf("%-40s %12.3f\n", "Xoshiro128::uniform()", measure([&](std::vector<float> & values) {
+               for (float & u : values)
+               {
+                   u = xoshiro.uniform();
+               }
+           }));
+
+    Xoshiro128x8 xoshiro8(1);
+    printf("%-40s %12.3f\n", "Xoshiro128x8::uniform(Span)", measure([&](std::vector<float> & values) {
+               xoshiro8.uniform(values);
+           }));
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+// Measures the time to update 100,000 particles.
+//
+// "per-particle" emulates the old update path, in which every particle fetched the emitter's environment and
+// appearance through shared pointers. "per-frame" is the current path, in which the emitter builds one UpdateContext
+// per frame and the kernel updates all of its particles with it.
+
+#include "Confetti/Appearance.h"
+#include "Confetti/Emitter.h"
+#include "Confetti/Environment.h"
+#include "Confetti/ParticleKernel.h"
+#include "Confetti/UpdateContext.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace Confetti;
+
+namespace
+{
+int constexpr   NUMBER_OF_PARTICLES = 100000;
+int constexpr   NUMBER_OF_FRAMES    = 100;
+float constexpr DT                  = 1.0f / 60.0f;
+
+std::vector<PointParticle> makeParticles()
+{
+    std::minstd_rand                      rng(1);
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    std::vector<PointParticle>            particles;
+    particles.reserve(NUMBER_OF_PARTICLES);
+    for (int i = 0; i < NUMBER_OF_PARTICLES; ++i)
+    {
+        particles.emplace_back(2.0f + u(rng),
+                               -1.0f + u(rng),
+                               glm::vec3(u(rng), u(rng), u(rng)),
+                               glm::vec3(u(rng), 5.0f + u(rng), u(rng)),
+                               glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+    }
+    return particles;
+}
+
+std::shared_ptr<PointEmitter> makeEmitter(std::vector<PointParticle> const & particles)
+{
+    // No surfaces or clip planes, so that only the cost of reaching the environment and appearance is measured
+    auto environment = std::make_shared<Environment>(glm::vec3(0.0f, -9.8f, 0.0f));
+    auto appearance = std::make_shared<Appearance>();
+    appearance->camera          = nullptr;
+    appearance->colorRate       = glm::vec4(0.0f, 0.0f, 0.0f, -0.5f);
+    appearance->radiusRate      = 0.0f;
+    appearance->angularVelocity = 0.0f;
+    appearance->size            = 1.0f;
+
+    return std::make_shared<PointEmitter>(nullptr, particles, nullptr, environment, appearance, false);
+}
+
+// Returns the average time to update one particle, in nanoseconds
+template <typename F>
+double measure(F update)
+{
+    using Clock = std::chrono::steady_clock;
+
+    update();   // Warm up
+    Clock::time_point start = Clock::now();
+    for (int frame = 0; frame < NUMBER_OF_FRAMES; ++frame)
+    {
+        update();
+    }
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    return elapsed.count() / (double(NUMBER_OF_FRAMES) * NUMBER_OF_PARTICLES);
+}
+} // anonymous namespace
+
+int main()
+{
+    std::vector<PointParticle> particles = makeParticles();
+
+    printf("%d particles, %d frames\n", NUMBER_OF_PARTICLES, NUMBER_OF_FRAMES);
+    printf("%-10s %16s %16s\n", "kernel", "per-particle ns", "per-frame ns");
+
+    int const supported = (int)ParticleKernel::supportedInstructionSet();
+    for (int i = 0; i <= supported; ++i)
+    {
+        ParticleKernel::InstructionSet instructionSet = (ParticleKernel::InstructionSet)i;
+        ParticleKernel::setInstructionSet(instructionSet);
+
+        std::shared_ptr<PointEmitter> before = makeEmitter(particles);
+        double perParticle = measure([&before] () {
+                                         ParticleStore & store = before->particles();
+                                         for (size_t j = 0; j < store.size(); ++j)
+                                         {
+                                             std::shared_ptr<Environment> environment = before->environment();
+                                             std::shared_ptr<Appearance>  appearance  = before->appearance();
+                                             UpdateContext context(*environment,
+                                                                   *appearance,
+                                                                   before->currentPosition(),
+                                                                   before->currentVelocity(),
+                                                                   DT);
+                                             ParticleKernel::update(store, j, j + 1, context);
+                                         }
+                                     });
+
+        std::shared_ptr<PointEmitter> after = makeEmitter(particles);
+        double perFrame = measure([&after] () { after->update(DT); });
+
+        printf("%-10s %16.2f %16.2f\n", ParticleKernel::name(instructionSet), perParticle, perFrame);
+    }
+
+    return 0;
+}
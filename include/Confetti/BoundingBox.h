@@ -0,0 +1,62 @@
+#if !defined(CONFETTI_BOUNDINGBOX_H)
+#define CONFETTI_BOUNDINGBOX_H
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <limits>
+
+namespace Confetti
+{
+//! An axis-aligned bounding box.
+//!
+//! @ingroup	Controls
+//!
+//! A default-constructed box is empty. Adding a point or another box grows the box to contain it.
+
+struct BoundingBox
+{
+    glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());      //!< Minimum corner
+    glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());     //!< Maximum corner
+
+    //! Returns true if the box contains nothing.
+    bool empty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+
+    //! Returns true if the box contains a point.
+    bool contains(glm::vec3 const & p) const
+    {
+        return p.x >= min.x && p.y >= min.y && p.z >= min.z && p.x <= max.x && p.y <= max.y && p.z <= max.z;
+    }
+
+    //! Returns true if the box contains another box. Every box contains an empty box.
+    bool contains(BoundingBox const & b) const { return b.empty() || (contains(b.min) && contains(b.max)); }
+
+    //! Grows the box to contain a point.
+    void add(glm::vec3 const & p)
+    {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+
+    //! Grows the box to contain another box.
+    void add(BoundingBox const & b)
+    {
+        min = glm::min(min, b.min);
+        max = glm::max(max, b.max);
+    }
+
+    //! Returns the box moved by an offset. An empty box stays empty.
+    BoundingBox translated(glm::vec3 const & offset) const
+    {
+        return empty() ? *this : BoundingBox{ min + offset, max + offset };
+    }
+
+    //! Returns the box grown by a margin in each direction. An empty box stays empty.
+    BoundingBox expanded(glm::vec3 const & margin) const
+    {
+        return empty() ? *this : BoundingBox{ min - margin, max + margin };
+    }
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_BOUNDINGBOX_H)
@@ -5,8 +5,11 @@
 
 #include <Confetti/Configuration.h>
 #include <Confetti/Environment.h>
+#include <Confetti/RngStream.h>
+#include <map>
 #include <memory>
-#include <random>
+#include <string>
+#include <vector>
 #include <vulkan/vulkan.hpp>
 
 namespace Vkx
@@ -28,15 +31,33 @@ class StreakParticle;
 class TexturedParticle;
 class SphereParticle;
 class EmitterParticle;
+class JobScheduler;
 
 //! A class that builds and maintains Confetti objects.
+//!
+//! Every random value is drawn from an RngStream keyed by the builder's seed. Each particle has its own stream,
+//! identified by the name of its emitter and its index, except for its position. The positions of each chunk of
+//! CHUNK_SIZE particles of an emitter are sampled from its volume all at once, as a part of the emitter's list from a
+//! stream identified by the name of the emitter. Each environment has its own stream for gusts, identified by its
+//! name. So, a configuration built with the same seed always produces the same results, regardless of the order in
+//! which its parts are built and the number of threads building them.
+//!
+//! A particle system is built in parallel. The components that depend on others are built after them, independent
+//! volumes and emitters are built concurrently, and the particles of large emitters are generated in parallel chunks.
+//! The components are registered in the order of the configuration once they are built.
 
 class Builder
 {
 public:
 
+    //! Number of particles of an emitter generated by each job.
+    static size_t constexpr CHUNK_SIZE = 4096;
+
     //! Constructor.
-    Builder(std::minstd_rand & rng);
+    explicit Builder(uint64_t seed = 0, unsigned threads = 0);
+
+    //! Destructor.
+    ~Builder();
 
     //! Returns a new particle system built using the supplied configuration
     std::shared_ptr<ParticleSystem> buildParticleSystem(Configuration const &        configuration,
@@ -141,6 +162,10 @@ public:
 
 private:
 
+    std::shared_ptr<BasicEmitter> makeEmitter(Configuration::Emitter const & configuration,
+                                              std::shared_ptr<Vkx::Device>   device);
+    std::shared_ptr<EmitterVolume> makeEmitterVolume(Configuration::EmitterVolume const & configuration) const;
+
     using EmitterMap       = std::map<std::string, std::shared_ptr<BasicEmitter>>;
     using EmitterVolumeMap = std::map<std::string, std::shared_ptr<EmitterVolume>>;
     using EnvironmentMap   = std::map<std::string, std::shared_ptr<Environment>>;
@@ -159,7 +184,8 @@ private:
     TextureMap textures_;               //!< Active textures
     MaterialMap materials_;             //!< Active materials
 
-    std::minstd_rand & rng_;
+    uint64_t seed_;                             //!< Key of all the random number streams
+    std::unique_ptr<JobScheduler> scheduler_;   //!< Builds the components in parallel
 };
 } // namespace Confetti
 
@@ -0,0 +1,105 @@
+#if !defined(CONFETTI_COLLISIONWORLD_H)
+#define CONFETTI_COLLISIONWORLD_H
+
+#pragma once
+
+#include <Confetti/BoundingBox.h>
+#include <Confetti/Span.h>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Confetti
+{
+//! A set of bounded surfaces that particles bounce off of.
+//!
+//! @ingroup	Controls
+//!
+//! The surfaces of an Environment are infinite planes, and every particle is tested against every plane. A collision
+//! world holds bounded quads, such as the polygons of level geometry, organized in a bounding volume hierarchy (BVH),
+//! so the cost of a collision test depends on the number of quads near the particles rather than the total number
+//! of quads. A world is immutable once it is built, so it can be shared by any number of environments and threads.
+//!
+//! A particle bounces off of a quad if it moves through the quad from its front to its back during an update. The
+//! front of a quad is the side its normal points to.
+
+class CollisionWorld
+{
+public:
+
+    //! A parallelogram that particles bounce off of.
+    struct Quad
+    {
+        glm::vec3 corner;           //!< One corner
+        glm::vec3 u;                //!< The edge from the corner to the next corner
+        glm::vec3 v;                //!< The edge from the corner to the previous corner. The normal is u x v.
+        float     dampening = 1.0f; //!< Ratio of post-bounce velocity to pre-bounce velocity
+    };
+
+    //! A list of Quads.
+    using QuadList = std::vector<Quad>;
+
+    //! Maximum number of quads in a leaf of the hierarchy.
+    static size_t constexpr LEAF_SIZE = 4;
+
+    //! Constructor.
+    explicit CollisionWorld(QuadList const & quads);
+
+    //! Returns the number of quads.
+    size_t size() const { return quads_.size(); }
+
+    //! Returns the bounds of all the quads.
+    BoundingBox bounds() const;
+
+    //! Appends the indexes of the quads whose bounds intersect a box.
+    void query(BoundingBox const & box, std::vector<uint32_t> & quads) const;
+
+    //! Bounces a single particle that moved from one position to another. Returns true if it bounced.
+    bool collide(glm::vec3 const & from, glm::vec3 & to, glm::vec3 & velocity) const;
+
+    //! Bounces particles that moved during an update.
+    void collide(Vec3Span<float const> const & from,
+                 Vec3Span<float> const &       to,
+                 Vec3Span<float> const &       velocities,
+                 Span<float const> const &     ages,
+                 float                         dt,
+                 Span<uint8_t> const &         events = Span<uint8_t>()) const;
+
+private:
+    // A quad prepared for intersection tests
+    struct Primitive
+    {
+        glm::vec3 normal;       // Unit normal
+        float     offset;       // Distance of the plane from the origin along the normal
+        glm::vec3 corner;       // One corner
+        glm::vec3 du;           // Dotted with a point relative to the corner, gives its coordinate along u
+        glm::vec3 dv;           // Dotted with a point relative to the corner, gives its coordinate along v
+        float     dampening;
+    };
+
+    // A node of the hierarchy. The children of an interior node are the nodes at "first" and "second". A leaf contains
+    // the "count" primitives starting at "first".
+    struct Node
+    {
+        BoundingBox box;
+        uint32_t    first;
+        uint32_t    second;
+        uint32_t    count;      // 0 for an interior node
+    };
+
+    uint32_t build(std::vector<uint32_t> & order, size_t begin, size_t end, std::vector<BoundingBox> const & boxes);
+    bool     nearestHit(glm::vec3 const & from,
+                        glm::vec3 const & to,
+                        uint32_t const *  candidates,
+                        size_t            count,
+                        uint32_t &        hit) const;
+    bool     bounce(glm::vec3 const & from, glm::vec3 & to, glm::vec3 & velocity, uint32_t const * candidates,
+                    size_t count) const;
+
+    std::vector<Primitive>   quads_;    // The quads in the order of the leaves
+    std::vector<BoundingBox> boxes_;    // The bounds of each quad
+    std::vector<Node>        nodes_;    // The hierarchy. The root is node 0.
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_COLLISIONWORLD_H)
@@ -4,16 +4,35 @@
 #pragma once
 
 #include <Confetti/Appearance.h>
+#include <Confetti/BoundingBox.h>
 #include <Confetti/Builder.h>
+#include <Confetti/CollisionWorld.h>
 #include <Confetti/Configuration.h>
+#include <Confetti/DepthSorter.h>
+#include <Confetti/DistanceField.h>
 #include <Confetti/Emitter.h>
 #include <Confetti/EmitterVolume.h>
 #include <Confetti/Environment.h>
+#include <Confetti/Frustum.h>
+#include <Confetti/JobScheduler.h>
 #include <Confetti/Particle.h>
+#include <Confetti/ParticleEventRing.h>
+#include <Confetti/ParticleKernel.h>
+#include <Confetti/ParticleStore.h>
 #include <Confetti/ParticleSystem.h>
+#include <Confetti/PlaneSet.h>
+#include <Confetti/Random.h>
+#include <Confetti/PointParticle.h>
+#include <Confetti/RngStream.h>
+#include <Confetti/SamplePool.h>
+#include <Confetti/Span.h>
 #include <Confetti/SphereParticle.h>
 #include <Confetti/StreakParticle.h>
 #include <Confetti/TexturedParticle.h>
+#include <Confetti/Turbulence.h>
+#include <Confetti/UpdateContext.h>
+#include <Confetti/WindField.h>
+#include <Confetti/Xoshiro128.h>
 
 // Group definitions for doxygen
 
@@ -43,6 +43,8 @@ public:
         float minSpeed_ = 0.0f;
         float maxSpeed_ = 0.0f;
         int count_ = 0;
+        bool looping_ = true;  //!< If false, count_ is the size of a pool from which particles are emitted at rate_
+        float rate_ = 0.0f;
         float lifetime_ = 1.0f;
         float spread_ = 0.0f;
         glm::vec4 color_{ 0.0f, 0.0f, 0.0f, 1.0f };
@@ -65,6 +67,7 @@ public:
         float height_ = 0.0f;
         float depth_ = 0.0f;
         float radius_ = 0.0f;
+        int samples_ = 0;      //!< Number of points precomputed for the volume, or 0 if the points are random
     };
 
     //! Environment configuration
@@ -76,6 +79,9 @@ public:
         glm::vec3 windVelocity_{ 0.0f, 0.0f, 0.0f };
         float gustiness_ = 0.0f;
         float airFriction_ = 0.0f;
+        float turbulenceFrequency_ = 1.0f;
+        float turbulenceAmplitude_ = 0.0f;
+        glm::vec3 turbulenceScroll_{ 0.0f, 0.0f, 0.0f };
         std::string surface_;
         std::string clip_;
     };
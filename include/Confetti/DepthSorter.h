@@ -0,0 +1,93 @@
+#if !defined(CONFETTI_DEPTHSORTER_H)
+#define CONFETTI_DEPTHSORTER_H
+
+#pragma once
+
+#include <Confetti/Span.h>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Confetti
+{
+//! Sorts particles back to front.
+//!
+//! @ingroup	Controls
+//!
+//! The squared distance from the viewpoint to each particle is computed once and converted to an integer key, and
+//! the (key, index) pairs are sorted with a radix sort. The result is a list of particle indexes in draw order, so
+//! the particle data itself is never moved. The sort is stable, so particles at the same distance are drawn in
+//! index order.
+//!
+//! The back-to-front order usually changes very little from one frame to the next, so the sorter can instead repair
+//! the previous frame's order with an insertion sort, which is nearly O(n) when only a few particles are out of
+//! place. If the order has changed too much, a full sort is done instead. The sorter can also skip sorting entirely
+//! when neither the viewpoint nor any particle has moved more than a threshold since the last sort.
+//!
+//! The sorter keeps its scratch buffers between calls, so sorting the same number of particles every frame does not
+//! allocate memory.
+
+class DepthSorter
+{
+public:
+
+    //! What the last call to sort() did.
+    enum class Result
+    {
+        SORTED,     //!< The particles were fully sorted
+        REPAIRED,   //!< The previous order was repaired
+        SKIPPED     //!< Nothing moved enough to change the order
+    };
+
+    //! Sorts the particles back to front and returns the indexes of the particles in draw order.
+    //!
+    //! If incremental sorting is enabled, order must contain the order returned by the previous call.
+    void sort(Vec3Span<float const> const & positions, glm::vec3 const & viewpoint, std::vector<uint32_t> & order);
+
+    //! Sorts indexes by ascending key. The sort is stable.
+    void sort(std::vector<uint32_t> & keys, std::vector<uint32_t> & order);
+
+    //! Enables or disables incremental sorting.
+    void setIncremental(bool incremental) { incremental_ = incremental; }
+
+    //! Returns true if incremental sorting is enabled.
+    bool incremental() const { return incremental_; }
+
+    //! Sets the distance the viewpoint or a particle must move before incremental sorting is done again.
+    void setResortThreshold(float threshold) { threshold_ = threshold; }
+
+    //! Returns the distance the viewpoint or a particle must move before incremental sorting is done again.
+    float resortThreshold() const { return threshold_; }
+
+    //! Returns what the last call to sort() did.
+    Result lastResult() const { return lastResult_; }
+
+    //! Returns the number of inversions fixed by the last call to sort() if the previous order was repaired.
+    size_t inversions() const { return inversions_; }
+
+    //! Returns a key that sorts in the opposite order of the value.
+    static uint32_t descendingKey(float value);
+
+private:
+    bool moved(Vec3Span<float const> const & positions, glm::vec3 const & viewpoint) const;
+    bool repair(std::vector<uint32_t> & order);
+    void remember(Vec3Span<float const> const & positions, glm::vec3 const & viewpoint);
+
+    std::vector<uint32_t> keys_;            // Keys of the particles being sorted
+    std::vector<uint32_t> scratchKeys_;     // Scratch buffer for the keys
+    std::vector<uint32_t> scratchOrder_;    // Scratch buffer for the indexes
+
+    bool incremental_  = false;             // If true, the previous order is repaired rather than sorting again
+    float threshold_   = 0.0f;              // Sorting is skipped if nothing has moved farther than this
+    Result lastResult_ = Result::SORTED;    // What the last sort did
+    size_t inversions_ = 0;                 // Number of inversions fixed by the last repair
+
+    glm::vec3 lastViewpoint_;               // Viewpoint at the last sort
+    std::vector<float> lastX_;              // Positions of the particles at the last sort
+    std::vector<float> lastY_;
+    std::vector<float> lastZ_;
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_DEPTHSORTER_H)
@@ -0,0 +1,83 @@
+#if !defined(CONFETTI_DISTANCEFIELD_H)
+#define CONFETTI_DISTANCEFIELD_H
+
+#pragma once
+
+#include <Confetti/BoundingBox.h>
+#include <Confetti/Span.h>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Confetti
+{
+//! A signed distance field that particles bounce off of.
+//!
+//! @ingroup	Controls
+//!
+//! A distance field is a 3D grid of the signed distances to the surface of a shape (negative inside), along with
+//! their gradients. The distance and the surface normal at any point are found with a single trilinear lookup, so the
+//! cost of a collision test doesn't depend on the complexity of the shape. Shapes like statues, rocks, and vehicles
+//! that would take dozens of surfaces are represented by one field.
+//!
+//! A field can be built from a closed triangle mesh, or loaded from a file previously saved with save(). The field
+//! is immutable once it is built, so it can be shared by any number of environments and threads. Outside of the grid,
+//! the distance is unknown and points are assumed to be outside of the shape.
+//!
+//! The file format is the 4-byte tag "CSDF", the version (1), the number of samples along x, y, and z, the origin,
+//! and the spacing of the samples, followed by the distances with x varying fastest. All values are 32-bit and
+//! little-endian.
+
+class DistanceField
+{
+public:
+
+    //! Constructor.
+    DistanceField(glm::ivec3 const & size, glm::vec3 const & origin, float spacing, std::vector<float> const & distances);
+
+    //! Loads a distance field from a file. Throws std::runtime_error if the file can't be loaded.
+    static DistanceField load(char const * path);
+
+    //! Builds a distance field from a closed triangle mesh.
+    static DistanceField fromMesh(std::vector<glm::vec3> const & vertices,
+                                  std::vector<uint32_t> const &  indices,
+                                  float                          spacing,
+                                  float                          margin);
+
+    //! Saves the distance field to a file. Throws std::runtime_error if the file can't be saved.
+    void save(char const * path) const;
+
+    //! Returns the number of samples along each axis.
+    glm::ivec3 size() const { return size_; }
+
+    //! Returns the position of the first sample.
+    glm::vec3 origin() const { return origin_; }
+
+    //! Returns the distance between adjacent samples.
+    float spacing() const { return spacing_; }
+
+    //! Returns the region covered by the grid.
+    BoundingBox bounds() const;
+
+    //! Returns the signed distance and the gradient of the distance at a point. Returns false if it is outside the grid.
+    bool sample(glm::vec3 const & p, float & distance, glm::vec3 & gradient) const;
+
+    //! Pushes particles that are inside the shape out of it and reflects their velocities.
+    void collide(Vec3Span<float> const &   positions,
+                 Vec3Span<float> const &   velocities,
+                 Span<float const> const & ages,
+                 glm::vec3 const &         offset,
+                 float                     dampening,
+                 Span<uint8_t> const &     events = Span<uint8_t>()) const;
+
+private:
+    size_t index(int x, int y, int z) const { return ((size_t)z * size_.y + y) * size_.x + x; }
+
+    glm::ivec3 size_;               // Number of samples along each axis
+    glm::vec3 origin_;              // Position of sample (0, 0, 0)
+    float spacing_;                 // Distance between adjacent samples
+    std::vector<glm::vec4> samples_; // Gradient (xyz) and distance (w) at each sample, interleaved for a single lookup
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_DISTANCEFIELD_H)
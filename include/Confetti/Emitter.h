@@ -3,10 +3,14 @@
 
 #pragma once
 
+#include <Confetti/BoundingBox.h>
+#include <Confetti/DepthSorter.h>
+#include <Confetti/ParticleStore.h>
 #include <Confetti/PointParticle.h>
 #include <Confetti/SphereParticle.h>
 #include <Confetti/StreakParticle.h>
 #include <Confetti/TexturedParticle.h>
+#include <Confetti/UpdateContext.h>
 #include <glm/glm.hpp>
 #include <memory>
 #include <vector>
@@ -17,6 +21,8 @@ namespace Confetti
 class EmitterVolume;
 class Appearance;
 class Environment;
+class Frustum;
+class ParticleEventRing;
 
 //! A particle emitter.
 //!
@@ -28,12 +34,16 @@ class BasicEmitter
 {
 public:
 
+    //! Number of particles in each chunk culled as a unit. Chunks updated concurrently must start at multiples of it.
+    static size_t constexpr CULL_CHUNK_SIZE = 1024;
+
     //! Constructor.
     BasicEmitter(std::shared_ptr<Vkx::Device>   device,
                  std::shared_ptr<EmitterVolume> volume,
                  std::shared_ptr<Environment>   environment,
                  std::shared_ptr<Appearance>    appearance,
-                 bool                           sorted);
+                 bool                           sorted,
+                 uint32_t                       streams = ParticleStore::NONE);
 
     //! Destructor.
     virtual ~BasicEmitter() = default;
@@ -59,6 +69,152 @@ public:
     //! Returns true if the particles are sorted.
     bool sorted() const { return sorted_; }
 
+    //! Enables/Disables analytic evaluation of the particles.
+    //!
+    //! When analytic evaluation is enabled and the environment allows it (see Environment::isAnalytic()), an update
+    //! only advances the ages of the particles. The rest of their state is computed from their age by evaluate() when
+    //! it is needed. Otherwise, the particles are simulated normally.
+    //!
+    //! The particles are evaluated as if they were all emitted from the emitter's current position and velocity, so
+    //! they are simulated while the emitter is moving, and for a lifetime after its position or velocity last changed.
+    void setAnalytic(bool analytic) { analytic_ = analytic; }
+
+    //! Returns true if analytic evaluation is enabled.
+    bool analytic() const { return analytic_; }
+
+    //! Computes the current state of the particles in the range [begin, end) if they are evaluated analytically.
+    void evaluate(size_t begin, size_t end);
+
+    //! Returns true if the state of some particles has not been computed since the last update.
+    bool stale() const { return stale_; }
+
+    //! @name Interpolation
+    //! When the particles are simulated at a fixed rate that is lower than the frame rate, drawing them in the state
+    //! they had after the last update makes their motion look jerky. Instead, an interpolated emitter keeps the state
+    //! of the particles before the last update, and they are drawn at a point between the two states.
+    //@{
+
+    //! Enables/Disables interpolation between updates.
+    void setInterpolated(bool interpolated);
+
+    //! Returns true if the particles are interpolated between updates.
+    bool interpolated() const { return interpolated_; }
+
+    //! Sets the point between the last two updates at which the particles are drawn (0 is the previous update, 1 is the
+    //! last update).
+    void setInterpolationFactor(float t) { interpolationFactor_ = t; }
+
+    //! Returns the point between the last two updates at which the particles are drawn.
+    float interpolationFactor() const { return interpolationFactor_; }
+
+    //! Returns the position of a live particle at the point between the last two updates.
+    glm::vec3 interpolatedPosition(size_t i) const;
+
+    //! Returns the color of a live particle at the point between the last two updates.
+    glm::vec4 interpolatedColor(size_t i) const;
+    //@}
+
+    //! @name Events
+    //! An emitter can record the births, clips, and bounces of its particles in an event ring, which is drained by
+    //! other systems (audio, decals, gameplay), typically once per frame. Events are found from flags written by the
+    //! particle kernels, so recording them costs a byte per particle and nothing per event that doesn't happen. The
+    //! particles are never evaluated analytically while events are recorded.
+    //@{
+
+    //! Sets the ring that receives the events, or nullptr to stop recording them.
+    void setEvents(std::shared_ptr<ParticleEventRing> events) { events_ = events; }
+
+    //! Returns the ring that receives the events, or nullptr if they are not recorded.
+    std::shared_ptr<ParticleEventRing> events() const { return events_; }
+    //@}
+
+    //! @name Emission
+    //! By default, the particles loop: a particle that reaches the end of its lifetime or is clipped is reset to its
+    //! birth state, so the emitter always holds the same number of particles. Instead, the particles can be emitted at
+    //! a rate and in bursts. The store is then a preallocated pool in which the particles that are not alive are free.
+    //! A particle is emitted by taking the first free particle, which already has a birth state, and a particle is
+    //! freed when it reaches the end of its lifetime or is clipped by swapping it with the last live particle. Both are
+    //! O(1), and only the live particles are updated. Particles that don't fit in the pool are not emitted.
+    //@{
+
+    //! Emits the particles at a rate instead of looping them. The particles that have not been born yet are freed.
+    void setEmissionRate(float rate);
+
+    //! Returns the number of particles emitted per second.
+    float emissionRate() const { return emissionRate_; }
+
+    //! Returns true if the particles loop instead of being emitted at a rate.
+    bool looping() const { return looping_; }
+
+    //! Emits n particles at the start of the next update. The particles don't loop after this is called.
+    void burst(size_t n);
+    //@}
+
+    //! Returns the values shared by all the particles during an update.
+    UpdateContext updateContext(float dt) const;
+
+    //! Returns the particles.
+    ParticleStore &       particles()       { return particles_; }
+    ParticleStore const & particles() const { return particles_; }
+
+    //! Returns the number of live particles.
+    //!
+    //! The live particles are kept at the front of the store, in the range [0, aliveCount()). Particles that have not
+    //! been born yet or have been clipped follow them and are not updated, sorted, or drawn.
+    size_t aliveCount() const { return aliveCount_; }
+
+    //! Returns the indexes of the live particles in back-to-front order. It is empty if the particles are not sorted.
+    std::vector<uint32_t> const & drawOrder() const { return drawOrder_; }
+
+    //! @name Bounds
+    //@{
+
+    //! Returns the bounding box of the live particles after the last update.
+    //!
+    //! The box is measured while the particles are simulated. If they are evaluated analytically, this is the
+    //! analytic bound instead.
+    BoundingBox const & bounds() const { return bounds_; }
+
+    //! Returns a conservative bound of the particles over their entire lifetimes.
+    //!
+    //! The bound is derived from the birth positions and velocities of the particles, their maximum lifetime, the
+    //! positions and velocities of the emitter, and the terminal velocities of the environment over the last lifetime,
+    //! widened by the drift of gusts and the speeds of the wind field and turbulence. It does not account for bounces, so
+    //! it is only guaranteed if it is in front of all the surfaces. The birth state is measured again whenever the
+    //! number of particles changes.
+    BoundingBox analyticBounds() const;
+
+    //! Returns the bounding box of a chunk of CULL_CHUNK_SIZE live particles after the last update. Unlike bounds(),
+    //! it includes the radii and tails of the particles, and their previous positions if they are interpolated.
+    BoundingBox const & chunkBounds(size_t chunk) const { return chunkBounds_[chunk]; }
+
+    //! Returns the number of chunks of live particles.
+    size_t chunkCount() const { return chunkBounds_.size(); }
+
+    //! Returns true if the clip planes and surfaces were skipped during the last update because all the particles
+    //! were known to be in front of them.
+    bool skippedPlanes() const { return skippedPlanes_; }
+    //@}
+
+    //! @name Culling
+    //! An emitter is culled before it is drawn. If it is visible, then its chunks are culled individually, and the
+    //! particles in chunks that are not visible should not be drawn.
+    //@{
+
+    //! Determines which chunks of particles are visible.
+    void cull(Frustum const & frustum);
+
+    //! Returns true if any particles were visible when the emitter was last culled.
+    bool visible() const { return visible_; }
+
+    //! Returns true if a chunk of particles was visible when the emitter was last culled.
+    bool chunkVisible(size_t chunk) const { return chunkVisible_[chunk] != 0; }
+    //@}
+
+    //! Returns the sorter used to compute the draw order. It can be used to enable incremental sorting.
+    DepthSorter &       sorter()       { return sorter_; }
+    DepthSorter const & sorter() const { return sorter_; }
+
     //! Enables/Disables the emitter. Returns the previous state.
     bool enable(bool enable = true);
 
@@ -78,19 +234,107 @@ public:
     //! @note	This method must be overridden.
     virtual void draw() const = 0;
 
+    //! @name Update in parts
+    //! The particles can be updated in chunks, possibly on different threads. beginUpdate() is called first, then
+    //! updateChunk() for each chunk, and then endUpdate(). This is equivalent to updateParticles().
+    //!
+    //! Unless the update is analytic, updateChunk() is prepareChunk(), ParticleKernel::update(), and finishChunk(). A
+    //! caller can make those calls itself in order to run the kernel on the particles of several emitters at once.
+    //@{
+
+    //! Begins an update of the particles and returns the context shared by the chunks.
+    UpdateContext beginUpdate(float dt);
+
+    //! Returns true if the particles are evaluated analytically during the current update.
+    bool analyticUpdate() const { return analyticUpdate_; }
+
+    //! Updates the live particles in the range [begin, end) and returns their bounding box.
+    BoundingBox updateChunk(UpdateContext const & context, size_t begin, size_t end);
+
+    //! Prepares the live particles in the range [begin, end) to be updated by the kernel.
+    void prepareChunk(UpdateContext const & context, size_t begin, size_t end);
+
+    //! Finishes updating the live particles in the range [begin, end) after the kernel has updated them, and returns
+    //! their bounding box. The events are those written by the kernel.
+    BoundingBox finishChunk(UpdateContext const & context, size_t begin, size_t end, uint8_t * events);
+
+    //! Finishes an update of the particles by removing clipped particles and computing the draw order if necessary.
+    //! The bounds are the union of the boxes returned by updateChunk().
+    void endUpdate(BoundingBox const & bounds);
+    //@}
+
 protected:
 
+    //! Updates the particles and computes the draw order if necessary.
+    void updateParticles(float dt);
+
     Vkx::LocalBuffer                vertexes_;
     Vkx::LocalBuffer                indexes_;
     std::shared_ptr<Vkx::Device>    device_;
+    ParticleStore                   particles_;
+    std::vector<uint32_t>           drawOrder_;
+    size_t                          aliveCount_ = 0;
 
 private:
+    // Extremes of the birth state of the particles
+    struct BirthBounds
+    {
+        BoundingBox positions;      // Initial positions relative to the emitter
+        glm::vec3 speed;            // Largest magnitude of each component of the initial velocities
+        float lifetime;             // Longest lifetime
+        float elapsed;              // Time since the birth state was measured
+        size_t count = 0;           // Number of particles measured
+    };
+
+    // Extremes of the emitter's motion and of the forces of the environment during a window of time
+    struct MotionBounds
+    {
+        BoundingBox positions;      // Positions of the emitter
+        BoundingBox velocities;     // Velocities of the emitter
+        BoundingBox terminal;       // Terminal velocities, widened by gusts, the wind field, and turbulence
+        float elapsed = 0.0f;       // Length of the window
+    };
+
+    void emit(float dt);
+    void savePreviousState(size_t begin, size_t end);
+    void recordEvents(size_t begin, uint8_t const * events, size_t n);
+    void addExtents(BoundingBox & box, size_t i) const;
+    void measureBirthState();
+    void recordMotion(float dt);
+    MotionBounds recentMotion() const;
+    bool stationary() const;
+    BoundingBox terminalVelocities(float dt) const;
+    glm::vec3 maxVelocity() const;
+    bool inFrontOfPlanes(float dt) const;
+
     // Particle data
 
     std::shared_ptr<EmitterVolume> volume_;     // Emitter volume
     std::shared_ptr<Appearance> appearance_;    // Common appearance parameters
     std::shared_ptr<Environment> environment_;  // Common environment parameters
     bool sorted_;                               // Should the emitter sort the particles back to front?
+    bool analytic_         = false;             // Should the particles be evaluated analytically if possible?
+    bool analyticUpdate_   = false;             // Is the current update analytic?
+    bool stale_            = false;             // Is the state of some particles out of date?
+    float lastDt_          = 0.0f;              // Time step of the last update
+    glm::vec3 lastPosition_ = glm::vec3(0.0f);  // Position of the emitter during the last update
+    glm::vec3 lastVelocity_ = glm::vec3(0.0f);  // Velocity of the emitter during the last update
+    bool interpolated_     = false;             // Are the particles interpolated between updates?
+    float interpolationFactor_ = 1.0f;          // Point between the last two updates at which particles are drawn
+    DepthSorter sorter_;                        // Sorts the particles back to front
+    BoundingBox bounds_;                        // Bounds of the live particles after the last update
+    BirthBounds birth_;                         // Extremes of the birth state of the particles
+    MotionBounds motion_[2];                    // Motion during the current and previous windows of a lifetime
+    bool skippedPlanes_    = false;             // Were the planes skipped during the last update?
+    bool measured_         = false;             // Are the bounds from a previous update?
+    std::vector<BoundingBox> chunkBounds_;      // Bounds of each chunk of live particles
+    std::vector<uint8_t> chunkVisible_;         // Was each chunk visible when last culled?
+    bool visible_          = false;             // Was the emitter visible when last culled?
+    std::shared_ptr<ParticleEventRing> events_; // Receives the events of the particles (optional)
+    bool looping_          = true;              // Are the particles reset when they die instead of being freed?
+    float emissionRate_    = 0.0f;              // Particles emitted per second if not looping
+    float emission_        = 0.0f;              // Fraction of a particle to be emitted carried over to the next update
+    size_t burst_          = 0;                 // Particles to be emitted at the start of the next update
 
     // Emitter state
 
@@ -99,160 +343,68 @@ private:
     glm::vec3 velocity_;    // Current velocity
 };
 
-//! @name Basic Emitters
-//! @ingroup	Emitters
-//@{
-
-//! An Emitter that emits PointParticles
+//! Characteristics of an emitter that emits PointParticles.
 //!
 //! @ingroup	Emitters
 //!
+//! A traits class for BasicEmitterT defines the type of particle and the optional particle streams it uses.
 
-class PointEmitter : public BasicEmitter
+struct PointParticleTraits
 {
-public:
-
-    //! Constructor.
-    PointEmitter(std::shared_ptr<Vkx::Device>   device,
-                 int                            n,
-                 std::shared_ptr<EmitterVolume> volume,
-                 std::shared_ptr<Environment>   environment,
-                 std::shared_ptr<Appearance>    appearance,
-                 bool                           sorted);
-
-    //! Constructor.
-    PointEmitter(std::shared_ptr<Vkx::Device>   device,
-                 std::vector<PointParticle>     particles,
-                 std::shared_ptr<EmitterVolume> volume,
-                 std::shared_ptr<Environment>   environment,
-                 std::shared_ptr<Appearance>    appearance,
-                 bool                           sorted);
-
-    virtual ~PointEmitter() override;
-
-    //! Initializes the emitter
-    void initialize();
-
-    //! Uninitializes the emitter
-    void uninitialize();
-
-    std::vector<PointParticle> &       particles()       { return particles_; }
-    std::vector<PointParticle> const & particles() const { return particles_; }
-
-    //! @name Overrides BasicEmitter
-    //@{
-    virtual void update(float dt) override;
-    virtual void draw() const override;
-    //@}
-
-private:
-    std::vector<PointParticle> particles_;
+    using Particle = PointParticle;                             //!< Type of particle
+    static uint32_t constexpr STREAMS = ParticleStore::NONE;    //!< Optional particle streams
 };
 
-//! An Emitter that emits StreakParticles
+//! Characteristics of an emitter that emits StreakParticles.
 //!
 //! @ingroup	Emitters
-//!
 
-class StreakEmitter : public BasicEmitter
+struct StreakParticleTraits
 {
-public:
-
-    //! Constructor.
-    StreakEmitter(std::shared_ptr<Vkx::Device>   device,
-                  int                            n,
-                  std::shared_ptr<EmitterVolume> volume,
-                  std::shared_ptr<Environment>   environment,
-                  std::shared_ptr<Appearance>    appearance,
-                  bool                           sorted);
-
-    //! Constructor.
-    StreakEmitter(std::shared_ptr<Vkx::Device>   device,
-                  std::vector<StreakParticle>    particles,
-                  std::shared_ptr<EmitterVolume> volume,
-                  std::shared_ptr<Environment>   environment,
-                  std::shared_ptr<Appearance>    appearance,
-                  bool                           sorted);
-
-    virtual ~StreakEmitter() override;
-
-    //! Initializes the emitter
-    void initialize();
-
-    //! Uninitializes the emitter
-    void uninitialize();
-
-    std::vector<StreakParticle> &       particles()       { return particles_; }
-    std::vector<StreakParticle> const & particles() const { return particles_; }
-
-    //! @name Overrides BasicEmitter
-    //@{
-    virtual void update(float dt) override;
-    virtual void draw() const override;
-    //@}
-
-private:
-    std::vector<StreakParticle> particles_;
+    using Particle = StreakParticle;                            //!< Type of particle
+    static uint32_t constexpr STREAMS = ParticleStore::TAIL;    //!< Optional particle streams
 };
 
-//! An Emitter that emits TexturedParticles
+//! Characteristics of an emitter that emits TexturedParticles.
 //!
 //! @ingroup	Emitters
-//!
 
-class TexturedEmitter : public BasicEmitter
+struct TexturedParticleTraits
 {
-public:
-
-    //! Constructor.
-    TexturedEmitter(std::shared_ptr<Vkx::Device>   device,
-                    int                            n,
-                    std::shared_ptr<EmitterVolume> volume,
-                    std::shared_ptr<Environment>   environment,
-                    std::shared_ptr<Appearance>    appearance,
-                    bool                           sorted);
-
-    //! Constructor.
-    TexturedEmitter(std::shared_ptr<Vkx::Device>   device,
-                    std::vector<TexturedParticle>  particles,
-                    std::shared_ptr<EmitterVolume> volume,
-                    std::shared_ptr<Environment>   environment,
-                    std::shared_ptr<Appearance>    appearance,
-                    bool                           sorted);
-
-    virtual ~TexturedEmitter() override;
-
-    //! Initializes the emitter
-    void initialize();
-
-    //! Uninitializes the emitter
-    void uninitialize();
-
-    std::vector<TexturedParticle> &       particles()       { return particles_; }
-    std::vector<TexturedParticle> const & particles() const { return particles_; }
+    using Particle = TexturedParticle;                                                  //!< Type of particle
+    static uint32_t constexpr STREAMS = ParticleStore::RADIUS | ParticleStore::ROTATION; //!< Optional particle streams
+};
 
-    //! @name Overrides BasicEmitter
-    //@{
-    virtual void update(float dt) override;
-    virtual void draw() const override;
-    //@}
+//! Characteristics of an emitter that emits SphereParticles.
+//!
+//! @ingroup	Emitters
 
-private:
-    std::vector<TexturedParticle> particles_;
-    std::shared_ptr<Vkx::LocalBuffer> pIB_;                      // Index buffer for particles
+struct SphereParticleTraits
+{
+    using Particle = SphereParticle;                            //!< Type of particle
+    static uint32_t constexpr STREAMS = ParticleStore::RADIUS;  //!< Optional particle streams
 };
 
-//! An Emitter that emits SphereParticles
+//! An emitter of a specific type of particle.
 //!
 //! @ingroup	Emitters
 //!
+//! All of the emitter's particles are updated by a single non-virtual call to the particle kernel. The particle type
+//! and the streams it uses are determined by the traits class (see PointParticleTraits). Drawing is specialized for
+//! each type of particle.
+//!
+//! @param	Traits	Characteristics of the particles
 
-class SphereEmitter : public BasicEmitter
+template <typename Traits>
+class BasicEmitterT : public BasicEmitter
 {
 public:
 
+    //! Type of particle emitted
+    using ParticleType = typename Traits::Particle;
+
     //! Constructor.
-    SphereEmitter(std::shared_ptr<Vkx::Device>   device,
+    BasicEmitterT(std::shared_ptr<Vkx::Device>   device,
                   int                            n,
                   std::shared_ptr<EmitterVolume> volume,
                   std::shared_ptr<Environment>   environment,
@@ -260,14 +412,14 @@ public:
                   bool                           sorted);
 
     //! Constructor.
-    SphereEmitter(std::shared_ptr<Vkx::Device>   device,
-                  std::vector<SphereParticle>    particles,
-                  std::shared_ptr<EmitterVolume> volume,
-                  std::shared_ptr<Environment>   environment,
-                  std::shared_ptr<Appearance>    appearance,
-                  bool                           sorted);
+    BasicEmitterT(std::shared_ptr<Vkx::Device>      device,
+                  std::vector<ParticleType> const & particles,
+                  std::shared_ptr<EmitterVolume>    volume,
+                  std::shared_ptr<Environment>      environment,
+                  std::shared_ptr<Appearance>       appearance,
+                  bool                              sorted);
 
-    virtual ~SphereEmitter() override;
+    virtual ~BasicEmitterT() override;
 
     //! Initializes the emitter
     void initialize();
@@ -275,18 +427,52 @@ public:
     //! Uninitializes the emitter
     void uninitialize();
 
-    std::vector<SphereParticle> &       particles()       { return particles_; }
-    std::vector<SphereParticle> const & particles() const { return particles_; }
-
     //! @name Overrides BasicEmitter
     //@{
-    virtual void update(float dt) override;
+    virtual void update(float dt) override final;
     virtual void draw() const override;
     //@}
-
-private:
-    std::vector<SphereParticle> particles_;
 };
+
+//! @name Basic Emitters
+//! @ingroup	Emitters
+//@{
+
+//! An Emitter that emits PointParticles
+using PointEmitter = BasicEmitterT<PointParticleTraits>;
+
+//! An Emitter that emits StreakParticles
+using StreakEmitter = BasicEmitterT<StreakParticleTraits>;
+
+//! An Emitter that emits TexturedParticles
+using TexturedEmitter = BasicEmitterT<TexturedParticleTraits>;
+
+//! An Emitter that emits SphereParticles
+using SphereEmitter = BasicEmitterT<SphereParticleTraits>;
+
+//@}
+
+// Each type of emitter initializes and draws its particles differently
+
+template <> void PointEmitter::initialize();
+template <> void PointEmitter::uninitialize();
+template <> void PointEmitter::draw() const;
+template <> void StreakEmitter::initialize();
+template <> void StreakEmitter::uninitialize();
+template <> void StreakEmitter::draw() const;
+template <> void TexturedEmitter::initialize();
+template <> void TexturedEmitter::uninitialize();
+template <> void TexturedEmitter::draw() const;
+template <> void SphereEmitter::initialize();
+template <> void SphereEmitter::uninitialize();
+template <> void SphereEmitter::draw() const;
+
+// The emitter types are instantiated in Emitter.cpp
+
+extern template class BasicEmitterT<PointParticleTraits>;
+extern template class BasicEmitterT<StreakParticleTraits>;
+extern template class BasicEmitterT<TexturedParticleTraits>;
+extern template class BasicEmitterT<SphereParticleTraits>;
 } // namespace Confetti
 
 #endif // !defined(CONFETTI_EMITTER_H)
@@ -3,13 +3,19 @@
 
 #pragma once
 
+#include <Confetti/RngStream.h>
+#include <Confetti/Span.h>
 #include <glm/glm.hpp>
-#include <random>
 
 namespace Confetti
 {
 //! This class generates random points in 3D whose locations are uniformly distributed in a specific volume.
 //!
+//! Each volume maps three numbers uniformly distributed in <tt>[0,1)</tt> to a point in the volume. A single point
+//! can be generated with operator (), but generating many points with sample() is much faster, because the random
+//! numbers are generated in bulk and the mapping is inlined into a loop without branches, which the compiler can
+//! vectorize.
+//!
 //! @note	This is an abstract base class, so it must be derived from to be used.
 //!
 
@@ -22,14 +28,41 @@ public:
     //! Returns a value used to specify a particle's point of emission.
     //!
     //! @param	rng     Random number generator.
+    glm::vec3 operator ()(RngStream & rng) const
+    {
+        float u = rng.uniform();
+        float v = rng.uniform();
+        float w = rng.uniform();
+        return point(u, v, w);
+    }
+
+    //! Returns the point corresponding to three numbers in <tt>[0,1)</tt>.
     //!
     //! @note	This method must be overridden.
-    virtual glm::vec3 operator ()(std::minstd_rand & rng) const = 0;
+    virtual glm::vec3 point(float u, float v, float w) const = 0;
+
+    //! Fills a list of points of emission.
+    //!
+    //! @param	points  Receives the points.
+    //! @param	rng     Random number generator.
+    //!
+    //! @note	This method must be overridden.
+    virtual void sample(Vec3Span<float> const & points, RngStream & rng) const = 0;
+
+    //! Fills part of a list of points of emission, so that the parts of a long list can be filled in parallel.
+    //!
+    //! @param	points  Receives the points of the part.
+    //! @param	rng     Random number generator of the whole list. Every part is given the same stream.
+    //! @param	offset  Index in the list of the first point of the part.
+    //! @param	total   Number of points in the list.
+    //!
+    //! By default, each part is sampled from its own range of the stream.
+    virtual void sample(Vec3Span<float> const & points, RngStream const & rng, size_t offset, size_t total) const;
 };
 
 //! An EmitterVolume that emits particles from the point <tt>[0,0,0]</tt>.
 
-class EmitterPoint : public EmitterVolume
+class EmitterPoint final : public EmitterVolume
 {
 public:
     //! Destructor.
@@ -37,7 +70,8 @@ public:
 
     //! @name Overrides EmitterVolume
     //@{
-    glm::vec3 operator ()(std::minstd_rand &) const override { return { 0.0f, 0.0f, 0.0f }; }
+    glm::vec3 point(float, float, float) const override { return { 0.0f, 0.0f, 0.0f }; }
+    void sample(Vec3Span<float> const & points, RngStream & rng) const override;
     //@}
 };
 
@@ -53,7 +87,7 @@ public:
 //!		</tt>
 //! </pre>
 
-class EmitterLine : public EmitterVolume
+class EmitterLine final : public EmitterVolume
 {
 public:
 
@@ -65,11 +99,12 @@ public:
 
     //! @name Overrides EmitterVolume
     //@{
-    glm::vec3 operator ()(std::minstd_rand & rng) const override;
+    glm::vec3 point(float u, float v, float w) const override;
+    void sample(Vec3Span<float> const & points, RngStream & rng) const override;
     //@}
 
 private:
-    std::uniform_real_distribution<float> randomX;
+    float size_;
 };
 
 //! An EmitterVolume that emits particles from the interior of a rectangle.
@@ -79,12 +114,12 @@ private:
 //!		Given the value <tt>[a,b]</tt> and the random values <tt>t:[0,1)</tt> and <tt>u:[0,1)</tt>,
 //!		<tt>
 //!			x = a * t - a/2
-//!			y = b * u - b/2
-//!			z = 0
+//!			y = 0
+//!			z = b * u - b/2
 //!		</tt>
 //!	</pre>
 
-class EmitterRectangle : public EmitterVolume
+class EmitterRectangle final : public EmitterVolume
 {
 public:
 
@@ -96,12 +131,13 @@ public:
 
     //! @name Overrides EmitterVolume
     //@{
-    glm::vec3 operator ()(std::minstd_rand & rng) const override;
+    glm::vec3 point(float u, float v, float w) const override;
+    void sample(Vec3Span<float> const & points, RngStream & rng) const override;
     //@}
 
 private:
-    std::uniform_real_distribution<float> randomX_;
-    std::uniform_real_distribution<float> randomZ_;
+    float width_;
+    float height_;
 };
 
 //! An EmitterVolume that emits particles from the interior of a circle.
@@ -110,13 +146,13 @@ private:
 //!	<pre>
 //!		Given the radius r and the random values <tt>t:[0,1)</tt> and <tt>u:[0,1)</tt>,
 //!		<tt>
-//!			x = t * r * cos( u * TWO_PI )
-//!			y = t * r * sin( u * TWO_PI )
+//!			x = sqrt( t ) * r * cos( u * TWO_PI )
+//!			y = sqrt( t ) * r * sin( u * TWO_PI )
 //!			z = 0
 //!		</tt>
 //!	</pre>
 
-class EmitterCircle : public EmitterVolume
+class EmitterCircle final : public EmitterVolume
 {
 public:
 
@@ -128,12 +164,12 @@ public:
 
     //! @name Overrides EmitterVolume
     //@{
-    glm::vec3 operator ()(std::minstd_rand & rng) const override;
+    glm::vec3 point(float u, float v, float w) const override;
+    void sample(Vec3Span<float> const & points, RngStream & rng) const override;
     //@}
 
 private:
-    std::uniform_real_distribution<float> randomAngle_;
-    std::uniform_real_distribution<float> randomR_;
+    float radius_;
 };
 
 //! An EmitterVolume that emits particles from the interior of a sphere.
@@ -142,13 +178,15 @@ private:
 //!	<pre>
 //!		Given the radius r and the random values <tt>t:[0,1)</tt>, <tt>u:[0,1)</tt>, and <tt>v:[0,1)</tt>,
 //!		<tt>
-//!			x = t * r * sin( u * PI ) * cos( v * TWO_PI )
-//!			y = t * r * sin( u * PI ) * sin( v * TWO_PI )
-//!			z = t * r * cos( u * PI )
+//!			c = 2 * u - 1
+//!			s = sqrt( 1 - c * c )
+//!			x = t**(1/3) * r * s * cos( v * TWO_PI )
+//!			y = t**(1/3) * r * s * sin( v * TWO_PI )
+//!			z = t**(1/3) * r * c
 //!		</tt>
 //!	</pre>
 
-class EmitterSphere : public EmitterVolume
+class EmitterSphere final : public EmitterVolume
 {
 public:
 
@@ -160,13 +198,12 @@ public:
 
     //! @name Overrides EmitterVolume
     //@{
-    glm::vec3 operator ()(std::minstd_rand & rng) const override;
+    glm::vec3 point(float u, float v, float w) const override;
+    void sample(Vec3Span<float> const & points, RngStream & rng) const override;
     //@}
 
 private:
-    std::uniform_real_distribution<float> randomR_;
-    std::uniform_real_distribution<float> randomAngle_;
-    std::uniform_real_distribution<float> randomCos_;
+    float radius_;
 };
 
 //! An EmitterVolume that emits particles from the interior of a box.
@@ -182,7 +219,7 @@ private:
 //!		</tt>
 //!	</pre>
 
-class EmitterBox : public EmitterVolume
+class EmitterBox final : public EmitterVolume
 {
 public:
 
@@ -194,13 +231,12 @@ public:
 
     //! @name Overrides EmitterVolume
     //@{
-    glm::vec3 operator ()(std::minstd_rand & rng) const override;
+    glm::vec3 point(float u, float v, float w) const override;
+    void sample(Vec3Span<float> const & points, RngStream & rng) const override;
     //@}
 
 private:
-    std::uniform_real_distribution<float> randomX_;
-    std::uniform_real_distribution<float> randomY_;
-    std::uniform_real_distribution<float> randomZ_;
+    glm::vec3 size_;
 };
 
 //! An EmitterVolume that emits particles from the interior of a cylinder.
@@ -210,13 +246,13 @@ private:
 //!		Given the values r and h, and the random values <tt>t:[0,1)</tt>, <tt>u:[0,1)</tt>, and
 //!		<tt>v:[0,1)</tt>,
 //!		<tt>
-//!			x = t * r * cos( u * TWO_PI )
-//!			y = t * r * sin( u * TWO_PI )
-//!			z = h * v
+//!			x = sqrt( t ) * r * cos( u * TWO_PI )
+//!			y = sqrt( t ) * r * sin( u * TWO_PI )
+//!			z = h * v - h/2
 //!		</tt>
 //!	</pre>
 
-class EmitterCylinder : public EmitterVolume
+class EmitterCylinder final : public EmitterVolume
 {
 public:
 
@@ -228,29 +264,30 @@ public:
 
     //! @name Overrides EmitterVolume
     //@{
-    glm::vec3 operator ()(std::minstd_rand & rng) const override;
+    glm::vec3 point(float u, float v, float w) const override;
+    void sample(Vec3Span<float> const & points, RngStream & rng) const override;
     //@}
 
 private:
-    std::uniform_real_distribution<float> randomAngle_;
-    std::uniform_real_distribution<float> randomR_;
-    std::uniform_real_distribution<float> randomZ_;
+    float radius_;
+    float height_;
 };
 
 //! An EmitterVolume that emits particles from the interior of a cone.
 //!
-//! The points are distributed uniformly in the volume using this function:
+//! The apex of the cone is at the origin and its base is at <tt>z = h</tt>. The points are distributed uniformly in
+//! the volume using this function:
 //!	<pre>
 //!		Given the values r and h, and the random values <tt>t:[0,1)</tt>, <tt>u:[0,1)</tt>, and
 //!		<tt>v:[0,1)</tt>,
 //!		<tt>
-//!			x = sqrt( t ) / r * v**(1/3) * h * cos( u * TWO_PI )
-//!			y = sqrt( t ) / r * v**(1/3) * h * sin( u * TWO_PI )
 //!			z = v**(1/3) * h
+//!			x = sqrt( t ) * r * z / h * cos( u * TWO_PI )
+//!			y = sqrt( t ) * r * z / h * sin( u * TWO_PI )
 //!		</tt>
 //!	</pre>
 
-class EmitterCone : public EmitterVolume
+class EmitterCone final : public EmitterVolume
 {
 public:
 
@@ -262,13 +299,13 @@ public:
 
     //! @name Overrides EmitterVolume
     //@{
-    glm::vec3 operator ()(std::minstd_rand & rng) const override;
+    glm::vec3 point(float u, float v, float w) const override;
+    void sample(Vec3Span<float> const & points, RngStream & rng) const override;
     //@}
 
 private:
-    std::uniform_real_distribution<float> randomAngle_;
-    std::uniform_real_distribution<float> randomZ_;
-    std::uniform_real_distribution<float> randomR_;
+    float radius_;
+    float height_;
 };
 } // namespace Confetti
 
@@ -3,13 +3,20 @@
 
 #pragma once
 
+#include <Confetti/PlaneSet.h>
+#include <Confetti/RngStream.h>
+#include <Confetti/Turbulence.h>
 #include <glm/glm.hpp>
-#include <random>
+#include <memory>
 #include <vector>
 #include <Vkx/Random.h>
 
 namespace Confetti
 {
+class CollisionWorld;
+class DistanceField;
+class WindField;
+
 //! An external (to any particle or emitter) set of factors that affect a particle's position and velocity.
 //!
 //! @ingroup	Controls
@@ -24,6 +31,13 @@ namespace Confetti
 //!                     area of the particle.
 //!     - wind: Particles can be affected by a wind that consists of a constant speed and direction modified randomly according to
 //!             the gustiness factor. Gustiness is a constant acceleration applied to the wind velocity in a random direction.
+//!             A wind field can be added to the wind so that it varies from place to place.
+//!     - turbulence: A swirling wind computed from curl noise is added to the wind.
+//!     - surfaces: Particles bounce off of infinite planes.
+//!     - clip planes: Particles are reset when they move through a plane.
+//!     - collision world: Particles bounce off of bounded quads, such as level geometry. A world can be shared by
+//!                        many environments.
+//!     - colliders: Particles bounce off of shapes represented by signed distance fields.
 //!
 
 class Environment
@@ -47,12 +61,23 @@ public:
     //! A plane that clips particles.
     using Clipper = glm::vec4;
 
+    //! A shape that the particles bounce off of.
+    struct Collider
+    {
+        std::shared_ptr<DistanceField const> field;    //!< The shape
+        glm::vec3 position = glm::vec3(0.0f);          //!< Location of the field's origin
+        float dampening    = 1.0f;                     //!< Ratio of post-bounce velocity to pre-bounce velocity.
+    };
+
     //! A list of Surfaces.
     using SurfaceList = std::vector<Surface>;
 
     //! A list of Clippers.
     using ClipperList = std::vector<Clipper>;
 
+    //! A list of Colliders.
+    using ColliderList = std::vector<Collider>;
+
     //! Constructor.
     explicit Environment(glm::vec3 const &   gravity      = { 0.0f, 0.0f, 0.0f },
                          float               airFriction  = 0.0f,
@@ -79,6 +104,18 @@ public:
     //! Returns wind velocity
     glm::vec3 windVelocity() const { return currentWindVelocity_; }
 
+    //! Sets the wind field (or none if nullptr). The field's velocities are added to the wind velocity.
+    void setWindField(std::shared_ptr<WindField const> field) { windField_ = field; }
+
+    //! Returns the wind field (or nullptr if there is none).
+    std::shared_ptr<WindField const> windField() const { return windField_; }
+
+    //! Sets the turbulence.
+    void setTurbulence(Turbulence const & turbulence) { turbulence_ = turbulence; }
+
+    //! Returns the turbulence.
+    Turbulence const & turbulence() const { return turbulence_; }
+
     //! Sets gustiness
     void setGustiness(float gustiness) { gustiness_ = gustiness; }
 
@@ -86,20 +123,54 @@ public:
     float gustiness() const { return gustiness_; }
 
     //! Sets the list of surface
-    void setSurfaces(SurfaceList const & bpl) { surfaces_ = bpl; }
+    void setSurfaces(SurfaceList const & bpl);
 
     //! Returns the list of surface
     SurfaceList const & surfaces() const { return surfaces_; }
 
     //! Sets the list of clip planes
-    void setClippers(ClipperList const & cpl) { clippers_ = cpl; }
+    void setClippers(ClipperList const & cpl);
 
     //! Returns the list of clip planes
     ClipperList const & clippers() const { return clippers_; }
 
+    //! Returns the surfaces compiled into a plane set for the particle kernels.
+    PlaneSet const & surfacePlanes() const { return surfacePlanes_; }
+
+    //! Returns the clip planes compiled into a plane set for the particle kernels.
+    PlaneSet const & clipperPlanes() const { return clipperPlanes_; }
+
+    //! Sets the collision world (or none if nullptr).
+    void setCollisionWorld(std::shared_ptr<CollisionWorld const> world) { collisionWorld_ = world; }
+
+    //! Returns the collision world (or nullptr if there is none).
+    std::shared_ptr<CollisionWorld const> collisionWorld() const { return collisionWorld_; }
+
+    //! Sets the list of colliders
+    void setColliders(ColliderList const & colliders) { colliders_ = colliders; }
+
+    //! Returns the list of colliders
+    ColliderList const & colliders() const { return colliders_; }
+
+    //! Returns true if the motion of particles in this environment can be computed analytically.
+    //!
+    //! Motion can be computed analytically if there are no gusts, wind field, turbulence, surfaces, clip planes,
+    //! collision world, or colliders.
+    bool isAnalytic() const
+    {
+        return gustiness_ == 0.0f && !windField_ && !turbulence_.enabled() && surfaces_.empty() && clippers_.empty() &&
+               !collisionWorld_ && colliders_.empty();
+    }
+
+    //! Sets the random number stream used for gusts.
+    void setRng(RngStream const & rng) { rng_ = rng; }
+
     //! Updates the environment.
     void update(float dt);
 
+    //! Returns the amount of time the environment has been updated for.
+    float time() const { return time_; }
+
     //! Returns the terminal velocity
     glm::vec3 terminalVelocity() const { return terminalVelocity_; }
 
@@ -115,15 +186,22 @@ private:
     glm::vec3 windVelocity_;                // Constant wind velocity component of the current wind velocity.
     float airFriction_;                     // Friction factor.
     float gustiness_;                       // Gustiness factor.
+    std::shared_ptr<WindField const> windField_; // Spatially varying part of the wind velocity (optional).
+    Turbulence turbulence_;                 // Turbulent part of the wind velocity.
     SurfaceList surfaces_;                  // A list of planes that the particles bounce against.
     ClipperList clippers_;                  // A list of planes that clip the particles.
+    PlaneSet surfacePlanes_;                // The surfaces compiled for the particle kernels.
+    PlaneSet clipperPlanes_;                // The clip planes compiled for the particle kernels.
+    std::shared_ptr<CollisionWorld const> collisionWorld_; // Quads that the particles bounce against (optional).
+    ColliderList colliders_;                // Shapes that the particles bounce against.
     Vkx::RandomDirection gustDirection_;    // Direction generator for gusts
     glm::vec3 gust_;                        // Gust component of the current wind velocity.
     glm::vec3 currentWindVelocity_;         // Current wind velocity.
     glm::vec3 terminalVelocity_;            // Terminal velocity.
     glm::vec3 terminalDistance_;            // Movement of a particle traveling at terminal velocity.
     float ect1_;                            // The value 1.0f - exp( -airFriction_ * dt ) calculated during the last update.
-    std::minstd_rand rng_;                  // The RNG for environments
+    float time_;                            // Total time of all updates.
+    RngStream rng_;                         // The RNG for gusts
 };
 } // namespace Confetti
 
@@ -0,0 +1,39 @@
+#if !defined(CONFETTI_FRUSTUM_H)
+#define CONFETTI_FRUSTUM_H
+
+#pragma once
+
+#include <array>
+#include <glm/glm.hpp>
+
+namespace Confetti
+{
+struct BoundingBox;
+
+//! A view frustum, used to cull emitters and particles that are not visible.
+//!
+//! @ingroup	Controls
+//!
+//! The frustum is extracted from a view-projection matrix. Points inside the frustum are on the positive side of all
+//! six of its planes. The near plane is placed where it is for a depth range of [-1, 1], so the frustum is slightly
+//! larger than necessary for a depth range of [0, 1] and culling is conservative for both.
+
+class Frustum
+{
+public:
+
+    //! Constructor.
+    explicit Frustum(glm::mat4 const & viewProjection);
+
+    //! Returns true if the point is inside the frustum.
+    bool contains(glm::vec3 const & p) const;
+
+    //! Returns true if any part of the box might be inside the frustum. An empty box is never inside.
+    bool intersects(BoundingBox const & box) const;
+
+private:
+    std::array<glm::vec4, 6> planes_;   // Left, right, bottom, top, near, far
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_FRUSTUM_H)
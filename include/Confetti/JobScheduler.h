@@ -0,0 +1,76 @@
+#if !defined(CONFETTI_JOBSCHEDULER_H)
+#define CONFETTI_JOBSCHEDULER_H
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Confetti
+{
+//! A work-stealing thread pool.
+//!
+//! @ingroup	Controls
+//!
+//! The scheduler runs batches of jobs, where a job is a function called with an index. The jobs of a batch are divided
+//! evenly among the threads, and a thread that runs out of jobs steals them from the other threads. The calling thread
+//! takes part in running the jobs and run() returns when all of them are done.
+//!
+//! If the scheduler has only one thread, or if run() is called by one of its jobs, the jobs are run on the calling
+//! thread in order.
+
+class JobScheduler
+{
+public:
+
+    //! A job. It is called with the index of the job in the batch, and it must not throw.
+    using Job = std::function<void(size_t)>;
+
+    //! Constructor.
+    explicit JobScheduler(unsigned threads = 0);
+
+    //! Destructor.
+    ~JobScheduler();
+
+    JobScheduler(JobScheduler const &) = delete;
+    JobScheduler & operator =(JobScheduler const &) = delete;
+
+    //! Returns the number of threads that run jobs, including the calling thread.
+    unsigned threadCount() const { return (unsigned)queues_.size(); }
+
+    //! Calls job(i) for each i in [0, count) and waits for all the calls to return.
+    void run(size_t count, Job const & job);
+
+private:
+
+    // Indexes of the jobs assigned to a thread
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<size_t> jobs;
+    };
+
+    void work(unsigned id);
+    bool execute(unsigned id);
+
+    std::vector<std::unique_ptr<Queue>> queues_;    // One queue per thread. Queue 0 belongs to the calling thread.
+    std::vector<std::thread> threads_;              // Worker threads
+    std::mutex mutex_;                              // Protects generation_ and quit_
+    std::condition_variable wake_;                  // Signals the workers that there is a new batch or to quit
+    std::condition_variable done_;                  // Signals the calling thread that the batch is done
+    Job const * job_ = nullptr;                     // The current batch's job
+    std::atomic<size_t> remaining_{ 0 };            // Number of jobs in the current batch not yet done
+    uint64_t generation_ = 0;                       // Incremented for each batch
+    bool quit_ = false;                             // True if the workers should exit
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_JOBSCHEDULER_H)
@@ -4,17 +4,9 @@
 #pragma once
 
 #include <glm/glm.hpp>
-#include <memory>
-
-namespace Vkx
-{
-    class Device;
-}
 
 namespace Confetti
 {
-class BasicEmitter;
-
 //! A particle base class.
 //!
 //! @ingroup	Particles
@@ -22,7 +14,8 @@ class BasicEmitter;
 //! A Particle is a point with a lifetime, age, position, and velocity. It has no size, shape, orientation, color,
 //! or texture.
 //!
-//! @note This is an abstract base class. You must derive from this class in order to use it.
+//! An emitter keeps its particles in a ParticleStore. Particle objects describe the state of a particle at birth
+//! and are used to populate the store.
 
 class Particle
 {
@@ -38,31 +31,19 @@ public:
              glm::vec3 const & velocity,
              glm::vec4 const & color);
 
-    //! Destructor.
-    virtual ~Particle() = default;
-
-    //! Updates the particle. Returns true if the particle was reborn.
-    virtual bool update(float dt);
-
-    //! Draws the particle.
-    //!
-    //!
-    //! @note	This method must be overridden.
-    virtual void draw(std::shared_ptr<Vkx::Device> device) const = 0;
-
-    //! Binds to an emitter.
-    void bind(BasicEmitter * pEmitter) { emitter_ = pEmitter; }
+    //! Returns the lifetime of the particle.
+    float lifetime() const { return lifetime_; }
 
     //! Returns the age of the particle.
     float age() const { return age_; }
 
-    //! Returns the particle's current position.
+    //! Returns the particle's position at birth.
     glm::vec3 position() const { return position_; }
 
-    //! Returns the particle's current velocity.
+    //! Returns the particle's velocity at birth.
     glm::vec3 velocity() const { return velocity_; }
 
-    //! Returns the particle's current velocity.
+    //! Returns the particle's color at birth.
     glm::vec4 color() const { return color_; }
 
 protected:
@@ -74,25 +55,19 @@ protected:
                     glm::vec3 const & velocity,
                     glm::vec4 const & color);
 
-    BasicEmitter const * emitter_;            //!< This particle's emitter
-
     // Age data
 
     float lifetime_;    //!< Max age
-    float age_;         //!< Current age
+    float age_;         //!< Initial age
 
     // Motion data
 
-    glm::vec3 initialPosition_; //!< Position at birth relative to emitter
-    glm::vec3 initialVelocity_; //!< Velocity at birth relative to emitter
-
-    glm::vec3 position_;        //!< Current position
-    glm::vec3 velocity_;        //!< Current velocity
+    glm::vec3 position_;        //!< Position at birth relative to emitter
+    glm::vec3 velocity_;        //!< Velocity at birth relative to emitter
 
     // Appearance data
 
-    glm::vec4 initialColor_;    //!< Color at birth
-    glm::vec4 color_;           //!< Current color
+    glm::vec4 color_;           //!< Color at birth
 };
 } // namespace Confetti
 
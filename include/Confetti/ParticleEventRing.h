@@ -0,0 +1,88 @@
+#if !defined(CONFETTI_PARTICLEEVENTRING_H)
+#define CONFETTI_PARTICLEEVENTRING_H
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+namespace Confetti
+{
+//! Something that happened to a particle during an update.
+//!
+//! @ingroup	Particles
+
+struct ParticleEvent
+{
+    //! Types of events. The values are distinct bits, so a set of events can be stored in a single byte.
+    enum Type : uint8_t
+    {
+        BIRTH  = 1,     //!< The particle was born or reborn
+        CLIP   = 2,     //!< The particle passed through a clip plane
+        BOUNCE = 4      //!< The particle bounced off of a surface, the collision world, or a collider
+    };
+
+    Type      type;         //!< What happened
+    glm::vec3 position;     //!< Position of the particle after the update
+    glm::vec3 velocity;     //!< Velocity of the particle after the update
+};
+
+//! A fixed-size, lock-free queue of particle events.
+//!
+//! @ingroup	Particles
+//!
+//! Any number of threads can record events concurrently while a single thread drains them, typically once per frame.
+//! The storage is allocated when the ring is constructed, so recording an event never allocates or blocks. If the ring
+//! is full, the event is dropped and counted instead.
+//!
+//! Events recorded by one thread are drained in the order they were recorded, but events recorded concurrently by
+//! different threads are interleaved arbitrarily.
+//!
+//! Source: Dmitry Vyukov, "Bounded MPMC queue"
+
+class ParticleEventRing
+{
+public:
+
+    //! Constructor. The capacity is rounded up to a power of 2.
+    explicit ParticleEventRing(size_t capacity);
+
+    ParticleEventRing(ParticleEventRing const &) = delete;
+    ParticleEventRing & operator =(ParticleEventRing const &) = delete;
+
+    //! Returns the maximum number of events waiting to be drained.
+    size_t capacity() const { return mask_ + 1; }
+
+    //! Records an event. Returns false if the ring is full and the event was dropped.
+    bool push(ParticleEvent const & event);
+
+    //! Removes the oldest event. Returns false if there are no events. Only one thread at a time may remove events.
+    bool pop(ParticleEvent & event);
+
+    //! Removes all the events and appends them to a list. Returns the number of events removed.
+    size_t drain(std::vector<ParticleEvent> & events);
+
+    //! Returns the number of events dropped because the ring was full.
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    // An event and the position in the sequence of pushes and pops that may access it next
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        ParticleEvent       event;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;                           // capacity - 1
+    alignas(64) std::atomic<size_t> head_;  // Position of the next event to push
+    alignas(64) size_t tail_;               // Position of the next event to pop
+    std::atomic<uint64_t> dropped_;         // Number of events dropped
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_PARTICLEEVENTRING_H)
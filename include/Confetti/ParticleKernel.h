@@ -0,0 +1,95 @@
+#if !defined(CONFETTI_PARTICLEKERNEL_H)
+#define CONFETTI_PARTICLEKERNEL_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Confetti
+{
+class ParticleStore;
+class UpdateContext;
+
+//! The particle integration kernels.
+//!
+//! @ingroup	Particles
+//!
+//! The kernels advance the particles in a ParticleStore by one time step. There is a scalar implementation and
+//! vectorized implementations that process 4 (SSE2), 8 (AVX2), or 16 (AVX-512) particles per iteration. The best
+//! instruction set supported by the CPU is selected when the program starts, and it can be overridden.
+//!
+//! The vectorized kernels perform the same operations in the same order as the scalar kernel, so their results are
+//! normally identical. Since the compiler is free to contract or reorder floating point operations differently in
+//! each implementation, the results are only guaranteed to match to within a relative error of TOLERANCE.
+
+class ParticleKernel
+{
+public:
+
+    //! Instruction sets used by the kernels.
+    enum class InstructionSet
+    {
+        SCALAR,     //!< No vector instructions
+        SSE2,       //!< 4 particles per iteration
+        AVX2,       //!< 8 particles per iteration
+        AVX512      //!< 16 particles per iteration
+    };
+
+    //! A range of the particles of one emitter in a store holding the particles of several emitters.
+    struct Range
+    {
+        size_t                begin;    //!< Index of the first particle
+        size_t                end;      //!< Index of the particle following the last particle
+        UpdateContext const * context;  //!< Context of the emitter
+    };
+
+    //! Maximum relative difference between the results of the scalar and vectorized kernels.
+    static float constexpr TOLERANCE = 1.0e-5f;
+
+    //! Updates the particles in the range [begin, end) of a store.
+    //!
+    //! If events is not null, the events (see ParticleEvent::Type) of particle i are written to events[i - begin].
+    static void update(ParticleStore &       particles,
+                       size_t                begin,
+                       size_t                end,
+                       UpdateContext const & context,
+                       uint8_t *             events = nullptr);
+
+    //! Updates several ranges of a store, each with its own context.
+    //!
+    //! The ranges must be in increasing order and must not overlap, and the contexts must share an environment and an
+    //! appearance. If events is not null, the events of particle i are written to events[i - ranges[0].begin].
+    static void update(ParticleStore & particles,
+                       Range const *   ranges,
+                       size_t          count,
+                       uint8_t *       events = nullptr);
+
+    //! @name Analytic Evaluation
+    //! If the environment has a closed-form solution (see Environment::isAnalytic()), the state of a particle is a
+    //! function of its birth state and its age. Only the ages need to be updated each frame, and the rest of the state
+    //! can be evaluated when (and if) it is needed.
+    //@{
+
+    //! Advances the ages of the particles in the range [begin, end) of a store.
+    static void advance(ParticleStore & particles, size_t begin, size_t end, UpdateContext const & context);
+
+    //! Computes the state of the particles in the range [begin, end) of a store from their birth state and age.
+    static void evaluate(ParticleStore & particles, size_t begin, size_t end, UpdateContext const & context);
+    //@}
+
+    //! Returns the best instruction set supported by the CPU.
+    static InstructionSet supportedInstructionSet();
+
+    //! Returns the instruction set currently used by the kernels.
+    static InstructionSet instructionSet();
+
+    //! Sets the instruction set used by the kernels. Returns the instruction set actually selected.
+    static InstructionSet setInstructionSet(InstructionSet instructionSet);
+
+    //! Returns the name of an instruction set.
+    static char const * name(InstructionSet instructionSet);
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_PARTICLEKERNEL_H)
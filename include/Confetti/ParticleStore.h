@@ -0,0 +1,227 @@
+#if !defined(CONFETTI_PARTICLESTORE_H)
+#define CONFETTI_PARTICLESTORE_H
+
+#pragma once
+
+#include <Confetti/Span.h>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Confetti
+{
+//! Structure-of-arrays storage for an emitter's particles.
+//!
+//! @ingroup	Particles
+//!
+//! Each property of the particles is kept in its own contiguous stream, and vector properties are split into one
+//! stream per component. The streams updated every frame (age, position, velocity, color, radius, rotation, and
+//! tail) are kept apart from the birth state (lifetime and the initial values), which is only read when a particle
+//! is reborn.
+//!
+//! The age, position, velocity, and color streams are always present. The radius, rotation, tail, and previous state
+//! streams are optional and are only allocated if requested when the store is constructed or by addStreams().
+//!
+//! A store can be attached to a range of another store, called its group, so that the particles of several emitters
+//! are contiguous and can be updated by a single kernel call. While it is attached, the store has no streams of its
+//! own, and its particles are the particles in its range of the group. If it grows past the end of its range, it is
+//! detached and its particles are moved back into its own streams. The group must outlive the stores attached to it.
+
+class ParticleStore
+{
+public:
+
+    //! Optional streams
+    enum Streams : uint32_t
+    {
+        NONE     = 0,       //!< Only the required streams
+        RADIUS   = 1 << 0,  //!< Radius and initial radius
+        ROTATION = 1 << 1,  //!< Rotation and initial rotation
+        TAIL     = 1 << 2,  //!< Tail position
+        PREVIOUS = 1 << 3   //!< Position and color before the last update
+    };
+
+    //! Constructor.
+    explicit ParticleStore(uint32_t streams = NONE);
+
+    //! Returns the set of optional streams in this store.
+    uint32_t streams() const { return streams_; }
+
+    //! Allocates optional streams that are not already present. The new streams are zero-initialized.
+    void addStreams(uint32_t streams);
+
+    //! Returns true if all the specified optional streams are present.
+    bool has(uint32_t streams) const { return (streams_ & streams) == streams; }
+
+    //! Returns the number of particles.
+    size_t size() const { return group_ ? size_ : age_.size(); }
+
+    //! Returns true if there are no particles.
+    bool empty() const { return size() == 0; }
+
+    //! Reserves space for n particles.
+    void reserve(size_t n);
+
+    //! Removes all particles.
+    void clear();
+
+    //! Resizes the store. New particles are zero-initialized.
+    void resize(size_t n);
+
+    //! Adds a particle. Returns its index.
+    size_t add(float             lifetime,
+               float             age,
+               glm::vec3 const & position,
+               glm::vec3 const & velocity,
+               glm::vec4 const & color,
+               float             radius   = 0.0f,
+               float             rotation = 0.0f);
+
+    //! Swaps two particles.
+    void swap(size_t a, size_t b);
+
+    //! Reorders the particles so that the particle at order[i] is moved to index i.
+    void reorder(std::vector<uint32_t> const & order);
+
+    //! @name Groups
+    //@{
+
+    //! Moves the particles into the range [offset, offset + capacity) of a group.
+    void attach(ParticleStore & group, size_t offset, size_t capacity);
+
+    //! Moves the particles out of the group back into the store's own streams.
+    void detach();
+
+    //! Returns the group the store is attached to, or nullptr if it is not attached.
+    ParticleStore const * group() const { return group_; }
+
+    //! Returns the index in the group of the first particle (0 if the store is not attached).
+    size_t offset() const { return offset_; }
+
+    //! Returns the number of particles the store can hold in its range of the group (0 if it is not attached).
+    size_t capacity() const { return capacity_; }
+    //@}
+
+    //! @name Birth State
+    //@{
+    Span<float const>     lifetimes() const        { return span(storage().lifetime_); }
+    Vec3Span<float const> initialPositions() const { return view(storage().initialPosition_); }
+    Vec3Span<float const> initialVelocities() const { return view(storage().initialVelocity_); }
+    Vec4Span<float const> initialColors() const    { return view(storage().initialColor_); }
+    Span<float const>     initialRadii() const     { return span(storage().initialRadius_, RADIUS); }
+    Span<float const>     initialRotations() const { return span(storage().initialRotation_, ROTATION); }
+    //@}
+
+    //! @name Current State
+    //@{
+    Span<float const>     ages() const       { return span(storage().age_); }
+    Vec3Span<float const> positions() const  { return view(storage().position_); }
+    Vec3Span<float const> velocities() const { return view(storage().velocity_); }
+    Vec4Span<float const> colors() const     { return view(storage().color_); }
+    Span<float const>     radii() const      { return span(storage().radius_, RADIUS); }
+    Span<float const>     rotations() const  { return span(storage().rotation_, ROTATION); }
+    Vec3Span<float const> tails() const      { return view(storage().tail_, TAIL); }
+
+    Span<float>     ages()       { return span(storage().age_); }
+    Vec3Span<float> positions()  { return view(storage().position_); }
+    Vec3Span<float> velocities() { return view(storage().velocity_); }
+    Vec4Span<float> colors()     { return view(storage().color_); }
+    Span<float>     radii()      { return span(storage().radius_, RADIUS); }
+    Span<float>     rotations()  { return span(storage().rotation_, ROTATION); }
+    Vec3Span<float> tails()      { return view(storage().tail_, TAIL); }
+    //@}
+
+    //! @name Previous State
+    //! The state before the last update, used to interpolate between updates (optional).
+    //@{
+    Vec3Span<float const> previousPositions() const { return view(storage().previousPosition_, PREVIOUS); }
+    Vec4Span<float const> previousColors() const    { return view(storage().previousColor_, PREVIOUS); }
+
+    Vec3Span<float> previousPositions() { return view(storage().previousPosition_, PREVIOUS); }
+    Vec4Span<float> previousColors()    { return view(storage().previousColor_, PREVIOUS); }
+    //@}
+
+private:
+
+    using Stream = std::vector<float>;
+
+    struct Vec3Stream
+    {
+        Stream x, y, z;
+    };
+
+    struct Vec4Stream
+    {
+        Stream x, y, z, w;
+    };
+
+    // The streams holding the particles, which are the group's if the store is attached
+    ParticleStore const & storage() const { return group_ ? *group_ : *this; }
+    ParticleStore &       storage()       { return group_ ? *group_ : *this; }
+
+    // Views of the particles in a stream of the storage. Optional streams that are not present are empty.
+    Span<float const> span(Stream const & s, uint32_t stream = NONE) const
+    {
+        return has(stream) ? Span<float const>(s.data() + offset_, size()) : Span<float const>();
+    }
+    Span<float> span(Stream & s, uint32_t stream = NONE)
+    {
+        return has(stream) ? Span<float>(s.data() + offset_, size()) : Span<float>();
+    }
+    Vec3Span<float const> view(Vec3Stream const & s, uint32_t stream = NONE) const
+    {
+        return { span(s.x, stream), span(s.y, stream), span(s.z, stream) };
+    }
+    Vec3Span<float> view(Vec3Stream & s, uint32_t stream = NONE)
+    {
+        return { span(s.x, stream), span(s.y, stream), span(s.z, stream) };
+    }
+    Vec4Span<float const> view(Vec4Stream const & s, uint32_t stream = NONE) const
+    {
+        return { span(s.x, stream), span(s.y, stream), span(s.z, stream), span(s.w, stream) };
+    }
+    Vec4Span<float> view(Vec4Stream & s, uint32_t stream = NONE)
+    {
+        return { span(s.x, stream), span(s.y, stream), span(s.z, stream), span(s.w, stream) };
+    }
+
+    // Calls f on every allocated stream of a store holding the streams of this store
+    template <typename F>
+    void forEachStream(ParticleStore & store, F f) const;
+
+    uint32_t streams_;              // Optional streams present
+
+    // Group
+
+    ParticleStore * group_ = nullptr;   // Store holding the particles if attached
+    size_t offset_   = 0;               // Index in the group of the first particle
+    size_t size_     = 0;               // Number of particles if attached
+    size_t capacity_ = 0;               // Size of the range in the group if attached
+
+    // Birth state
+
+    Stream lifetime_;               // Max age
+    Vec3Stream initialPosition_;    // Position at birth relative to the emitter
+    Vec3Stream initialVelocity_;    // Velocity at birth relative to the emitter
+    Vec4Stream initialColor_;       // Color at birth
+    Stream initialRadius_;          // Radius at birth (optional)
+    Stream initialRotation_;        // Rotation at birth (optional)
+
+    // Current state
+
+    Stream age_;                    // Current age
+    Vec3Stream position_;           // Current position
+    Vec3Stream velocity_;           // Current velocity
+    Vec4Stream color_;              // Current color
+    Stream radius_;                 // Current radius (optional)
+    Stream rotation_;               // Current rotation (optional)
+    Vec3Stream tail_;               // Location of the tail (optional)
+
+    // Previous state
+
+    Vec3Stream previousPosition_;   // Position before the last update (optional)
+    Vec4Stream previousColor_;      // Color before the last update (optional)
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_PARTICLESTORE_H)
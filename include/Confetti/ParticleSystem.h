@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 #include "vulkan/vulkan.hpp"
@@ -20,19 +21,50 @@ class BasicEmitter;
 class Appearance;
 class EmitterVolume;
 class Environment;
+class JobScheduler;
+class UpdateContext;
 
 //! The particle system.
 //!
 //! This class updates and draws particles associated with a set of emitters using a set of appearances and environments.
+//!
+//! The emitters are updated in parallel by a work-stealing scheduler. Emitters with many particles are split into
+//! chunks of CHUNK_SIZE particles so that a single large emitter is also spread across the threads. Emitters with at
+//! most BATCH_SIZE particles are put in groups of up to CHUNK_SIZE particles with emitters of the same type that share
+//! an environment and an appearance. The particles of a group are kept in a single store, each emitter's in its own
+//! range (see ParticleStore::attach()), and each group is updated by a single job with one kernel call, which is given
+//! the range and context of each emitter. An emitter keeps its range while it is small, even while it is disabled, so
+//! the particles only move when an emitter joins or leaves a group. Every particle is updated independently, so the
+//! results do not depend on the number of threads or on how the emitters are grouped.
+//!
+//! By default, the system is simulated once per update using the elapsed time. If a fixed time step is set, the
+//! system is instead simulated in steps of that length, as many times as the elapsed time allows, and the leftover
+//! time is carried over to the next update. The emitters are then interpolated between their last two steps so that
+//! the particles move smoothly even though they are simulated less often than they are drawn.
 
 class ParticleSystem
 {
 public:
 
+    //! Number of particles updated by each job. It is a multiple of the widest vectorized kernel and of
+    //! BasicEmitter::CULL_CHUNK_SIZE.
+    static size_t constexpr CHUNK_SIZE = 4096;
+
+    //! Emitters with at most this many particles are updated in groups rather than on their own.
+    static size_t constexpr BATCH_SIZE = 1024;
+
+    //! Maximum number of fixed steps per update. Any more elapsed time is dropped so that a slow frame does not cause
+    //! the following frames to be slow too.
+    static int constexpr MAX_STEPS = 8;
+
     //! Constructor.
     ParticleSystem(std::shared_ptr<Vkx::Device> device,
                    vk::CommandPool const &      commandPool,
-                   vk::Queue const &            queue);
+                   vk::Queue const &            queue,
+                   unsigned                     threads = 0);
+
+    //! Destructor.
+    ~ParticleSystem();
 
     //@{
     //! Registers a component.
@@ -51,14 +83,34 @@ public:
     //! Updates the system.
     void update(float dt);
 
+    //! Sets the length of a simulation step. If 0, the system is simulated once per update.
+    void setFixedTimestep(float step);
+
+    //! Returns the length of a simulation step, or 0 if the system is simulated once per update.
+    float fixedTimestep() const { return fixedTimestep_; }
+
     //! Draws all particles for all the emitters.
     void draw() const;
 
+    //! Returns the number of live particles in all the enabled emitters.
+    size_t aliveCount() const;
+
 private:
 
+    struct Group;
+
     using EmitterList     = std::vector<std::shared_ptr<BasicEmitter>>;
     using EnvironmentList = std::vector<std::shared_ptr<Environment>>;
     using AppearanceList  = std::vector<std::shared_ptr<Appearance>>;
+    using GroupList       = std::vector<std::unique_ptr<Group>>;
+
+    void simulate(float dt);
+    void prune();
+    void join(std::vector<BasicEmitter *> const & active,
+              std::vector<size_t> &               ungrouped,
+              std::vector<std::vector<size_t>> &  members);
+    void ungroup();
+    void updateGroup(Group & group, UpdateContext const * contexts, size_t const * indexes);
 
     std::shared_ptr<Vkx::Device> device_;   // Device hosting the particle system
     vk::CommandPool commandPool_;           // Command pool for creating buffers
@@ -66,6 +118,10 @@ private:
     EmitterList emitters_;                  // Active emitters
     EnvironmentList environments_;          // Active environments
     AppearanceList appearances_;            // Active appearances
+    GroupList groups_;                      // Groups of small emitters sharing a store
+    std::unique_ptr<JobScheduler> scheduler_;   // Runs the updates of the emitters
+    float fixedTimestep_ = 0.0f;            // Length of a simulation step (0 if not fixed)
+    float accumulator_   = 0.0f;            // Elapsed time not yet simulated
 };
 } // namespace Confetti
 
@@ -0,0 +1,75 @@
+#if !defined(CONFETTI_PLANESET_H)
+#define CONFETTI_PLANESET_H
+
+#pragma once
+
+#include <Confetti/BoundingBox.h>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Confetti
+{
+//! A set of planes stored as a structure of arrays.
+//!
+//! @ingroup	Controls
+//!
+//! An environment compiles its clip planes and surfaces into plane sets so that the particle kernels can test a
+//! particle (or a block of particles) against all the planes without gathering the coefficients from a list of
+//! structures. Each coefficient (a, b, c, d, and the dampening) is kept in its own array.
+//!
+//! The arrays are padded with null planes to a multiple of PACKET_SIZE so that the planes can be processed in packets.
+//! A null plane has a zero normal, so no point is ever behind it.
+
+class PlaneSet
+{
+public:
+
+    //! The arrays are padded to a multiple of this number of planes.
+    static size_t constexpr PACKET_SIZE = 4;
+
+    //! Removes all the planes.
+    void clear();
+
+    //! Adds a plane.
+    void add(glm::vec4 const & plane, float dampening = 0.0f);
+
+    //! Returns the number of planes.
+    size_t size() const { return size_; }
+
+    //! Returns true if there are no planes.
+    bool empty() const { return size_ == 0; }
+
+    //! Returns the number of planes including the padding.
+    size_t paddedSize() const { return a_.size(); }
+
+    //! Returns true if no point in the box is behind any of the planes.
+    bool inFront(BoundingBox const & box) const;
+
+    //! Returns plane i.
+    glm::vec4 plane(size_t i) const;
+
+    //! Returns the dampening of plane i.
+    float dampening(size_t i) const;
+
+    //! @name Coefficient Arrays
+    //! Each array contains paddedSize() values.
+    //@{
+    float const * a() const          { return a_.data(); }
+    float const * b() const          { return b_.data(); }
+    float const * c() const          { return c_.data(); }
+    float const * d() const          { return d_.data(); }
+    float const * dampenings() const { return dampening_.data(); }
+    //@}
+
+private:
+    size_t size_ = 0;
+    std::vector<float> a_;
+    std::vector<float> b_;
+    std::vector<float> c_;
+    std::vector<float> d_;
+    std::vector<float> dampening_;
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_PLANESET_H)
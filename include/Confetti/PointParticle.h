@@ -6,15 +6,8 @@
 #include <Confetti/Particle.h>
 #include <glm/glm.hpp>
 
-namespace Vkx
-{
-    class Device;
-}
-
 namespace Confetti
 {
-class BasicEmitter;
-
 //! A point Particle scaled by distance.
 //!
 //! @ingroup	Particles
@@ -34,9 +27,6 @@ public:
                   glm::vec3 const & velocity,
                   glm::vec4 const & color);
 
-    //! Destructor.
-    virtual ~PointParticle() override = default;
-
     //! Initializes a particle constructed with the default constructor
     void Initialize(float             lifetime,
                     float             age,
@@ -44,12 +34,6 @@ public:
                     glm::vec3 const & velocity,
                     glm::vec4 const & color);
 
-    //! @name Overrides Particle
-    //@{
-    virtual bool update(float dt) override;
-    virtual void draw(std::shared_ptr<Vkx::Device> device) const override;
-    //@}
-
     //! Vertex buffer info.
     struct VBEntry
     {
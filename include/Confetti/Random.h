@@ -0,0 +1,54 @@
+#if !defined(CONFETTI_RANDOM_H)
+#define CONFETTI_RANDOM_H
+
+#pragma once
+
+#include <Confetti/Span.h>
+#include <cstdint>
+
+namespace Confetti
+{
+//! @name Random Numbers
+//! Confetti's random number generators (RngStream and Xoshiro128) and the standard 32-bit generators are
+//! interchangeable: any uniform random bit generator whose numbers fill 32 bits can be used with these functions.
+//! They convert the numbers to floats directly, which is much faster than going through
+//! std::uniform_real_distribution, and gives the same values on every platform.
+//!
+//! @ingroup	Controls
+//@{
+
+//! Returns a float uniformly distributed in [0, 1) made from the high 24 bits of a 32-bit number.
+inline float toUniform(uint32_t x)
+{
+    return (float)(x >> 8) * (1.0f / 16777216.0f);
+}
+
+//! Returns a float uniformly distributed in [0, 1).
+template <typename Generator>
+float uniform(Generator & generator)
+{
+    static_assert(Generator::min() == 0 && Generator::max() == UINT32_MAX, "The generator must fill 32 bits");
+    return toUniform((uint32_t)generator());
+}
+
+//! Returns a float uniformly distributed in [min, max).
+template <typename Generator>
+float uniform(Generator & generator, float min, float max)
+{
+    return min + (max - min) * uniform(generator);
+}
+
+//! Fills a list with floats uniformly distributed in [0, 1), one number at a time. Generators with a faster way to do
+//! this provide their own uniform(Span<float>).
+template <typename Generator>
+void fillUniform(Generator & generator, Span<float> const & values)
+{
+    for (float & value : values)
+    {
+        value = uniform(generator);
+    }
+}
+//@}
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_RANDOM_H)
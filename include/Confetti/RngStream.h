@@ -0,0 +1,96 @@
+#if !defined(CONFETTI_RNGSTREAM_H)
+#define CONFETTI_RNGSTREAM_H
+
+#pragma once
+
+#include <Confetti/Random.h>
+#include <Confetti/Span.h>
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace Confetti
+{
+//! A counter-based random number generator.
+//!
+//! @ingroup	Controls
+//!
+//! The numbers are generated by Philox4x32-10, which encrypts a 128-bit counter with a 64-bit key. Nothing is shared
+//! between streams, so each stream's numbers depend only on its key and counter, and not on how many other streams
+//! exist, what order they are used in, or which thread uses them. This makes simulations reproducible whether they
+//! are run serially or in parallel.
+//!
+//! The key is the seed of the whole system. The high 64 bits of the counter identify the stream, usually an object's
+//! id and the index of a particle, and the low 64 bits count the blocks of 4 numbers drawn from the stream.
+//!
+//! An RngStream satisfies the requirements of a uniform random bit generator, so it can be used with the standard
+//! distributions.
+//!
+//! Source: Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC11
+
+class RngStream
+{
+public:
+
+    using result_type = uint32_t;       //!< Type of the generated numbers
+    using Block       = std::array<uint32_t, 4>;    //!< A block of numbers or a counter
+    using Key         = std::array<uint32_t, 2>;    //!< A key
+
+    //! Number of blocks generated together by uniform(Span<float>)
+    static size_t constexpr LANES = 8;
+
+    //! Constructor.
+    explicit RngStream(uint64_t seed = 0, uint32_t stream = 0, uint32_t substream = 0)
+        : key_{ { (uint32_t)seed, (uint32_t)(seed >> 32) } }
+        , counter_{ { 0, 0, stream, substream } }
+        , index_(4)
+    {
+    }
+
+    //! Returns the smallest number generated.
+    static constexpr result_type min() { return 0; }
+
+    //! Returns the largest number generated.
+    static constexpr result_type max() { return UINT32_MAX; }
+
+    //! Returns the next number in the stream.
+    result_type operator ()()
+    {
+        if (index_ == 4)
+        {
+            buffer_ = philox(counter_, key_);
+            if (++counter_[0] == 0)
+                ++counter_[1];
+            index_ = 0;
+        }
+        return buffer_[index_++];
+    }
+
+    //! Skips numbers in the stream.
+    void discard(uint64_t n);
+
+    //! Returns a float uniformly distributed in [0, 1).
+    float uniform() { return toUniform(operator ()()); }
+
+    //! Returns a float uniformly distributed in [min, max).
+    float uniform(float min, float max) { return min + (max - min) * uniform(); }
+
+    //! Fills a list with floats uniformly distributed in [0, 1). The values are the same as successive calls to
+    //! uniform(), but they are generated LANES blocks at a time so that the loop can be vectorized.
+    void uniform(Span<float> const & values);
+
+    //! Returns the block of numbers for a counter and key.
+    static Block philox(Block counter, Key key);
+
+    //! Returns a stream id for a name.
+    static uint32_t id(std::string const & name);
+
+private:
+    Key      key_;
+    Block    counter_;  // Counter of the next block
+    Block    buffer_;   // The current block
+    unsigned index_;    // Index of the next number in the buffer
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_RNGSTREAM_H)
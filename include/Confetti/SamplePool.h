@@ -0,0 +1,79 @@
+#if !defined(CONFETTI_SAMPLEPOOL_H)
+#define CONFETTI_SAMPLEPOOL_H
+
+#pragma once
+
+#include <Confetti/EmitterVolume.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Confetti
+{
+//! An EmitterVolume that emits particles from a precomputed pool of points in another volume.
+//!
+//! @ingroup	Emitters
+//!
+//! The points are the points of the volume for the first numbers of a 3D Sobol sequence. Unlike random points, they
+//! are stratified: they don't clump or leave gaps, even when there are only a few particles. The numbers are computed
+//! once, so emitting a point is a table lookup and the volume's mapping.
+//!
+//! The number of points in the pool is a power of 2. sample() gives each emitter a different part of the pool: it
+//! starts at a random multiple of the smallest power of 2 that is at least the number of points requested. Any such
+//! block of points is as evenly distributed as the start of the sequence, and points only repeat if more points are
+//! requested than there are in the pool. A list sampled in parts gets a single block, and each part is its own range of
+//! the block.
+//!
+//! The numbers of each list are also scrambled by XORing them with random bits (a random digital shift) before they
+//! are mapped to the volume. The shift keeps the stratification of the blocks, and it gives emitters that share a pool
+//! different points, even when they take the same block.
+//!
+//! Source: Joe and Kuo, "Constructing Sobol sequences with better two-dimensional projections", SIAM J. Sci. Comput.
+//! 2008
+
+class SamplePool final : public EmitterVolume
+{
+public:
+
+    //! Constructor. The size is rounded up to a power of 2.
+    SamplePool(std::shared_ptr<EmitterVolume const> volume, size_t size);
+
+    //! Destructor.
+    virtual ~SamplePool() override = default;
+
+    //! Returns the volume the points are in.
+    std::shared_ptr<EmitterVolume const> volume() const { return volume_; }
+
+    //! Returns the number of points in the pool.
+    size_t size() const { return u_.size(); }
+
+    //! Returns point i of the pool, without any scrambling.
+    glm::vec3 operator [](size_t i) const;
+
+    //! Returns the numbers in [0,1) used to compute point i of the pool.
+    static glm::vec3 sobol(uint32_t i);
+
+    //! @name Overrides EmitterVolume
+    //@{
+
+    //! Returns the point of the pool selected by u. v and w are not used.
+    glm::vec3 point(float u, float v, float w) const override;
+
+    //! Copies a scrambled block of points from the pool.
+    void sample(Vec3Span<float> const & points, RngStream & rng) const override;
+
+    //! Copies part of a scrambled block of points from the pool.
+    void sample(Vec3Span<float> const & points, RngStream const & rng, size_t offset, size_t total) const override;
+    //@}
+
+private:
+    void copy(Vec3Span<float> const & points, size_t start, RngStream & rng) const;
+
+    std::shared_ptr<EmitterVolume const> volume_;
+    std::vector<uint32_t> u_;   // Sobol numbers of the points, as fractions of 2^32
+    std::vector<uint32_t> v_;
+    std::vector<uint32_t> w_;
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_SAMPLEPOOL_H)
@@ -0,0 +1,145 @@
+#if !defined(CONFETTI_SPAN_H)
+#define CONFETTI_SPAN_H
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <type_traits>
+#include <vector>
+
+namespace Confetti
+{
+//! A non-owning view of a contiguous array.
+//!
+//! @ingroup	Controls
+//!
+//! This is a minimal stand-in for C++20's std::span.
+
+template <typename T>
+class Span
+{
+public:
+
+    //! Constructor.
+    Span() = default;
+
+    //! Constructor.
+    Span(T * data, size_t size)
+        : data_(data)
+        , size_(size)
+    {
+    }
+
+    //! Constructor.
+    template <typename A>
+    Span(std::vector<std::remove_const_t<T>, A> & v)
+        : data_(v.data())
+        , size_(v.size())
+    {
+    }
+
+    //! Constructor.
+    template <typename A, typename U = T, typename = std::enable_if_t<std::is_const<U>::value>>
+    Span(std::vector<std::remove_const_t<T>, A> const & v)
+        : data_(v.data())
+        , size_(v.size())
+    {
+    }
+
+    //! Constructor. Converts a mutable span to a const span.
+    template <typename U, typename = std::enable_if_t<std::is_same<T, U const>::value>>
+    Span(Span<U> const & other)
+        : data_(other.data())
+        , size_(other.size())
+    {
+    }
+
+    //! Returns a pointer to the first element.
+    T * data() const { return data_; }
+
+    //! Returns the number of elements.
+    size_t size() const { return size_; }
+
+    //! Returns true if there are no elements.
+    bool empty() const { return size_ == 0; }
+
+    //! Returns the element at index i.
+    T & operator [](size_t i) const { assert(i < size_); return data_[i]; }
+
+    //! Returns an iterator to the first element.
+    T * begin() const { return data_; }
+
+    //! Returns an iterator to just past the last element.
+    T * end() const { return data_ + size_; }
+
+    //! Returns a view of count elements starting at offset.
+    Span subspan(size_t offset, size_t count) const
+    {
+        assert(offset + count <= size_);
+        return Span(data_ + offset, count);
+    }
+
+private:
+    T * data_    = nullptr;
+    size_t size_ = 0;
+};
+
+//! A view of an array of 3D vectors stored as separate x, y, and z arrays.
+//!
+//! @ingroup	Controls
+
+template <typename T>
+struct Vec3Span
+{
+    Span<T> x;  //!< X components
+    Span<T> y;  //!< Y components
+    Span<T> z;  //!< Z components
+
+    //! Returns the number of elements.
+    size_t size() const { return x.size(); }
+
+    //! Returns the vector at index i.
+    glm::vec3 operator [](size_t i) const { return glm::vec3(x[i], y[i], z[i]); }
+
+    //! Sets the vector at index i.
+    void set(size_t i, glm::vec3 const & v) const { x[i] = v.x; y[i] = v.y; z[i] = v.z; }
+
+    //! Returns a view of count elements starting at offset.
+    Vec3Span subspan(size_t offset, size_t count) const
+    {
+        return { x.subspan(offset, count), y.subspan(offset, count), z.subspan(offset, count) };
+    }
+
+    //! Converts to a read-only view.
+    operator Vec3Span<T const>() const { return { x, y, z }; }
+};
+
+//! A view of an array of 4D vectors stored as separate x, y, z, and w arrays.
+//!
+//! @ingroup	Controls
+
+template <typename T>
+struct Vec4Span
+{
+    Span<T> x;  //!< X (red) components
+    Span<T> y;  //!< Y (green) components
+    Span<T> z;  //!< Z (blue) components
+    Span<T> w;  //!< W (alpha) components
+
+    //! Returns the number of elements.
+    size_t size() const { return x.size(); }
+
+    //! Returns the vector at index i.
+    glm::vec4 operator [](size_t i) const { return glm::vec4(x[i], y[i], z[i], w[i]); }
+
+    //! Sets the vector at index i.
+    void set(size_t i, glm::vec4 const & v) const { x[i] = v.x; y[i] = v.y; z[i] = v.z; w[i] = v.w; }
+
+    //! Converts to a read-only view.
+    operator Vec4Span<T const>() const { return { x, y, z, w }; }
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_SPAN_H)
@@ -6,11 +6,6 @@
 #include <Confetti/Particle.h>
 #include <glm/glm.hpp>
 
-namespace Vkx
-{
-    class Device;
-}
-
 namespace Confetti
 {
 //! A sphere-shaped lit Particle with a radius.
@@ -33,11 +28,7 @@ public:
                    glm::vec4 const & color,
                    float             radius);
 
-    //! Destructor.
-    virtual ~SphereParticle() override = default;
-
-    //! @name Overrides Particle
-    //@{
+    //! Initializes a particle constructed with the default constructor
     void Initialize(float             lifetime,
                     float             age,
                     glm::vec3 const & position,
@@ -45,11 +36,7 @@ public:
                     glm::vec4 const & color,
                     float             radius);
 
-    virtual bool update(float dt) override;
-    virtual void draw(std::shared_ptr<Vkx::Device> device) const override;
-    //!@}
-
-    //! Returns the particle's radius.
+    //! Returns the particle's radius at birth.
     float GetRadius() const { return radius_; }
 
     // Vertex buffer info
@@ -69,8 +56,7 @@ private:
 
     // Appearance data
 
-    float initialRadius_;                      // Radius (distance from center to edge) at birth.
-    float radius_;                             // Current radius.
+    float radius_;                             // Radius (distance from center to edge) at birth.
 };
 } // namespace Confetti
 
@@ -6,17 +6,13 @@
 #include <Confetti/Particle.h>
 #include <glm/glm.hpp>
 
-namespace Vkx
-{
-    class Device;
-}
-
 namespace Confetti
 {
 //! A line-shaped Particle whose length and direction depend on its velocity.
 //!
 //! @ingroup	Particles
 //!
+//! The location of the tail is not part of the birth state. It is kept in the ParticleStore::TAIL stream.
 
 class StreakParticle : public Particle
 {
@@ -32,9 +28,6 @@ public:
                    glm::vec3 const & velocity,
                    glm::vec4 const & color);
 
-    //! Destructor.
-    virtual ~StreakParticle() override = default;
-
     //! Initializes a particle constructed with the default constructor
     void Initialize(float             lifetime,
                     float             age,
@@ -42,15 +35,6 @@ public:
                     glm::vec3 const & velocity,
                     glm::vec4 const & color);
 
-    //! @name Overrides Particle
-    //@{
-    virtual bool update(float dt) override;
-    virtual void draw(std::shared_ptr<Vkx::Device> device) const override;
-    //@}
-
-    //! Returns the position of the particle's tail.
-    glm::vec3 const & GetTailPosition() const { return tail_; }
-
     //! Vertex buffer info
     struct VBEntry
     {
@@ -67,12 +51,6 @@ public:
 //
 //     //! Vertex shader data declaration
 //     static D3DVERTEXELEMENT11 const aVSDataDeclarationInfo_[];
-
-private:
-
-    // Appearance data
-
-    glm::vec3 tail_;                         //!< Location of the tail
 };
 } // namespace Confetti
 
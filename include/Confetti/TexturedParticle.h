@@ -6,11 +6,6 @@
 #include <Confetti/Particle.h>
 #include <glm/glm.hpp>
 
-namespace Vkx
-{
-    class Device;
-}
-
 namespace Confetti
 {
 //! A square camera-facing Particle with a texture, radius, and 2D rotation.
@@ -34,9 +29,6 @@ public:
                      float             radius,
                      float             rotation);
 
-    //! Destructor.
-    virtual ~TexturedParticle() override = default;
-
     //! Initializes a particle constructed with the default constructor
     void Initialize(float             lifetime,
                     float             age,
@@ -46,16 +38,10 @@ public:
                     float             radius,
                     float             rotation = 0);
 
-    //! @name Overrides Particle
-    //@{
-    virtual bool update(float dt) override;
-    virtual void draw(std::shared_ptr<Vkx::Device> device) const override;
-    //@}
-
-    //! Returns the particle's current radius.
+    //! Returns the particle's radius at birth.
     float radius() const { return radius_; }
 
-    //! Returns the particle's current rotation.
+    //! Returns the particle's rotation at birth.
     float rotation() const { return rotation_; }
 
     //! Vertex buffer info
@@ -83,11 +69,8 @@ private:
 
     // Appearance data
 
-    float initialRadius_;          // Radius (distance from center to edge) at birth.
-    float radius_;                 // Current radius.
-
-    float initialRotation_;        // Rotation at birth (0 is unrotated).
-    float rotation_;               // Current rotation.
+    float radius_;                 // Radius (distance from center to edge) at birth.
+    float rotation_;               // Rotation at birth (0 is unrotated).
 };
 } // namespace Confetti
 
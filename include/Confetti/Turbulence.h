@@ -0,0 +1,66 @@
+#if !defined(CONFETTI_TURBULENCE_H)
+#define CONFETTI_TURBULENCE_H
+
+#pragma once
+
+#include <Confetti/Span.h>
+#include <cmath>
+#include <glm/glm.hpp>
+
+namespace Confetti
+{
+//! A turbulent wind computed from curl noise.
+//!
+//! @ingroup	Controls
+//!
+//! The turbulent wind is the curl of a vector field of gradient noise, so it swirls without sources or sinks
+//! (it is divergence-free) and particles carried by it don't bunch up or spread out. Unlike gusts, it varies from place
+//! to place, so it moves neighboring particles differently.
+//!
+//! The frequency is the number of noise features per unit of distance, the amplitude scales the velocity, and the
+//! noise pattern moves at the scroll velocity. Like the uniform wind, the turbulent wind only affects particles in an
+//! environment with air friction.
+//!
+//! Source: Bridson et al., "Curl-Noise for Procedural Fluid Flow", SIGGRAPH 2007
+
+class Turbulence
+{
+public:
+
+    //! Largest magnitude of a component of the velocity when the amplitude is 1.
+    static float constexpr MAX_SPEED = 24.5f;
+
+    //! Constructor.
+    explicit Turbulence(float             frequency = 1.0f,
+                        float             amplitude = 0.0f,
+                        glm::vec3 const & scroll    = glm::vec3(0.0f));
+
+    //! Returns the number of noise features per unit of distance.
+    float frequency() const { return frequency_; }
+
+    //! Returns the scale of the velocity.
+    float amplitude() const { return amplitude_; }
+
+    //! Returns the velocity of the noise pattern.
+    glm::vec3 scroll() const { return scroll_; }
+
+    //! Returns true if the turbulence has any effect.
+    bool enabled() const { return amplitude_ != 0.0f; }
+
+    //! Returns an upper bound on the magnitude of each component of the velocity.
+    glm::vec3 maxSpeed() const { return glm::vec3(std::abs(amplitude_) * MAX_SPEED); }
+
+    //! Returns the velocity at a point and time.
+    glm::vec3 velocity(glm::vec3 const & p, float time) const;
+
+    //! Adds the velocities at a list of points and a time to a list of velocities.
+    void addVelocities(Vec3Span<float const> const & positions, float time, Vec3Span<float> const & velocities) const;
+
+private:
+    float     frequency_;
+    float     amplitude_;
+    glm::vec3 scroll_;
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_TURBULENCE_H)
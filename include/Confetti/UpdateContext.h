@@ -0,0 +1,119 @@
+#if !defined(CONFETTI_UPDATECONTEXT_H)
+#define CONFETTI_UPDATECONTEXT_H
+
+#pragma once
+
+#include <Confetti/Environment.h>
+#include <glm/glm.hpp>
+
+namespace Confetti
+{
+class Appearance;
+class CollisionWorld;
+class Turbulence;
+class WindField;
+
+//! Everything a particle kernel needs to know about an emitter during one update.
+//!
+//! @ingroup	Controls
+//!
+//! An emitter builds its context once per frame from its environment, appearance, position, and velocity, and the
+//! context is passed to the particle kernels. The kernels never look at the emitter, so the inner loop contains no
+//! pointer chasing or reference counting. A context can't be changed once it has been built.
+//!
+//! The clip planes and surfaces are not copied. The context refers to the plane sets compiled by the environment, so
+//! the environment's planes, wind field, turbulence, collision world, and colliders must not be changed while the context is in use.
+
+class UpdateContext
+{
+public:
+
+    //! Constructor.
+    UpdateContext(Environment const & environment,
+                  Appearance const &  appearance,
+                  glm::vec3 const &   position,
+                  glm::vec3 const &   velocity,
+                  float               dt);
+
+    //! Returns the amount of time since the last update.
+    float dt() const { return dt_; }
+
+    //! Returns the emitter's position.
+    glm::vec3 emitterPosition() const { return emitterPosition_; }
+
+    //! Returns the emitter's velocity.
+    glm::vec3 emitterVelocity() const { return emitterVelocity_; }
+
+    //! Returns gravity.
+    glm::vec3 gravity() const { return gravity_; }
+
+    //! Returns air friction.
+    float airFriction() const { return airFriction_; }
+
+    //! Returns the terminal velocity.
+    glm::vec3 terminalVelocity() const { return terminalVelocity_; }
+
+    //! Returns the distance traveled by a particle at terminal velocity during this update.
+    glm::vec3 terminalDistance() const { return terminalDistance_; }
+
+    //! Returns the value 1.0f - exp( -airFriction * dt ).
+    float ect1() const { return ect1_; }
+
+    //! Returns the wind field, or nullptr if there is none.
+    WindField const * windField() const { return windField_; }
+
+    //! Returns the turbulence, or nullptr if there is none.
+    Turbulence const * turbulence() const { return turbulence_; }
+
+    //! Returns the environment's time, which determines the turbulence.
+    float time() const { return time_; }
+
+    //! Returns the color rate of change.
+    glm::vec4 colorRate() const { return colorRate_; }
+
+    //! Returns the radius rate of change.
+    float radiusRate() const { return radiusRate_; }
+
+    //! Returns the angular velocity.
+    float angularVelocity() const { return angularVelocity_; }
+
+    //! Returns the clip planes.
+    PlaneSet const & clippers() const { return *clippers_; }
+
+    //! Returns the surfaces.
+    PlaneSet const & surfaces() const { return *surfaces_; }
+
+    //! Returns the collision world, or nullptr if there is none.
+    CollisionWorld const * collisionWorld() const { return collisionWorld_; }
+
+    //! Returns the colliders.
+    Environment::ColliderList const & colliders() const { return *colliders_; }
+
+    //! Returns a copy of this context with no clip planes or surfaces. The collision world is kept.
+    //!
+    //! This is used when the particles are known to be in front of all the planes, so the kernels can skip them.
+    UpdateContext withoutPlanes() const;
+
+private:
+    float dt_;
+    glm::vec3 emitterPosition_;
+    glm::vec3 emitterVelocity_;
+    glm::vec3 gravity_;
+    float airFriction_;
+    glm::vec3 terminalVelocity_;
+    glm::vec3 terminalDistance_;
+    float ect1_;
+    WindField const * windField_;
+    Turbulence const * turbulence_;
+    float time_;
+    glm::vec4 colorRate_;
+    float radiusRate_;
+    float angularVelocity_;
+    PlaneSet const * clippers_;
+    PlaneSet const * surfaces_;
+    CollisionWorld const * collisionWorld_;
+    Environment::ColliderList const * colliders_;
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_UPDATECONTEXT_H)
@@ -0,0 +1,78 @@
+#if !defined(CONFETTI_WINDFIELD_H)
+#define CONFETTI_WINDFIELD_H
+
+#pragma once
+
+#include <Confetti/BoundingBox.h>
+#include <Confetti/Span.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Confetti
+{
+//! A spatially varying wind.
+//!
+//! @ingroup	Controls
+//!
+//! A wind field is a 3D grid of wind velocities that is added to the uniform wind of an Environment. Between the
+//! samples, the velocity is interpolated trilinearly, and outside of the grid it is the velocity at the nearest edge.
+//! Like the uniform wind, it only affects particles in an environment with air friction.
+//!
+//! The velocities can be changed between updates (for example, by a fluid simulation), but not during an update.
+
+class WindField
+{
+public:
+
+    //! Constructor. The velocities are all zero.
+    WindField(glm::ivec3 const & size, glm::vec3 const & origin, float spacing);
+
+    //! Constructor.
+    WindField(glm::ivec3 const &             size,
+              glm::vec3 const &              origin,
+              float                          spacing,
+              std::vector<glm::vec3> const & velocities);
+
+    //! Returns the number of samples along each axis.
+    glm::ivec3 size() const { return size_; }
+
+    //! Returns the position of the first sample.
+    glm::vec3 origin() const { return origin_; }
+
+    //! Returns the distance between adjacent samples.
+    float spacing() const { return spacing_; }
+
+    //! Returns the region covered by the grid.
+    BoundingBox bounds() const;
+
+    //! Sets all the velocities, with x varying fastest, then y, then z.
+    void setVelocities(std::vector<glm::vec3> const & velocities);
+
+    //! Sets the velocity of one sample.
+    void setVelocity(int x, int y, int z, glm::vec3 const & velocity);
+
+    //! Returns the velocity of one sample.
+    glm::vec3 velocity(int x, int y, int z) const { return velocities_[index(x, y, z)]; }
+
+    //! Returns an upper bound on the magnitude of each component of the velocities.
+    glm::vec3 maxSpeed() const { return maxSpeed_; }
+
+    //! Returns the velocity at a point.
+    glm::vec3 sample(glm::vec3 const & p) const;
+
+    //! Returns the velocities at a list of points.
+    void sample(Vec3Span<float const> const & positions, Vec3Span<float> const & velocities) const;
+
+private:
+    size_t index(int x, int y, int z) const { return ((size_t)z * size_.y + y) * size_.x + x; }
+    void   updateMaxSpeed();
+
+    glm::ivec3 size_;                   // Number of samples along each axis
+    glm::vec3 origin_;                  // Position of sample (0, 0, 0)
+    float spacing_;                     // Distance between adjacent samples
+    std::vector<glm::vec3> velocities_; // Velocity at each sample
+    glm::vec3 maxSpeed_;                // Largest magnitude of each component of the velocities
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_WINDFIELD_H)
@@ -0,0 +1,110 @@
+#if !defined(CONFETTI_XOSHIRO128_H)
+#define CONFETTI_XOSHIRO128_H
+
+#pragma once
+
+#include <Confetti/Random.h>
+#include <Confetti/Span.h>
+#include <array>
+#include <cstdint>
+
+namespace Confetti
+{
+//! A fast random number generator.
+//!
+//! @ingroup	Controls
+//!
+//! xoshiro128+ generates a 32-bit number with a handful of shifts, rotates, and xors of a 128-bit state. Its high
+//! bits are of high quality and are the ones used to make floats, but its lowest bits are weak, so it should not be
+//! used to generate integers. It is several times faster than RngStream, but each number depends on the previous
+//! one, so an Xoshiro128 can't skip ahead cheaply or be shared between threads. Like RngStream, it is seeded with a
+//! seed, a stream, and a substream, so separate objects and particles can have separate generators.
+//!
+//! An Xoshiro128 satisfies the requirements of a uniform random bit generator.
+//!
+//! Source: Blackman and Vigna, "Scrambled Linear Pseudorandom Number Generators", ACM TOMS 2021
+
+class Xoshiro128
+{
+public:
+
+    using result_type = uint32_t;                   //!< Type of the generated numbers
+    using State       = std::array<uint32_t, 4>;    //!< State of the generator
+
+    //! Constructor.
+    explicit Xoshiro128(uint64_t seed = 0, uint32_t stream = 0, uint32_t substream = 0);
+
+    //! Constructor. The state must not be all zeros.
+    explicit Xoshiro128(State const & state) : s_(state) {}
+
+    //! Returns the smallest number generated.
+    static constexpr result_type min() { return 0; }
+
+    //! Returns the largest number generated.
+    static constexpr result_type max() { return UINT32_MAX; }
+
+    //! Returns the next number.
+    result_type operator ()()
+    {
+        uint32_t const result = s_[0] + s_[3];
+        uint32_t const t      = s_[1] << 9;
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3]  = (s_[3] << 11) | (s_[3] >> 21);
+        return result;
+    }
+
+    //! Returns a float uniformly distributed in [0, 1).
+    float uniform() { return toUniform(operator ()()); }
+
+    //! Returns a float uniformly distributed in [min, max).
+    float uniform(float min, float max) { return min + (max - min) * uniform(); }
+
+    //! Fills a list with floats uniformly distributed in [0, 1).
+    void uniform(Span<float> const & values) { fillUniform(*this, values); }
+
+    //! Advances the state by 2^64 numbers. Calling jump() n times gives n non-overlapping sequences.
+    void jump();
+
+    //! Returns the state.
+    State const & state() const { return s_; }
+
+private:
+    State s_;
+};
+
+//! Several Xoshiro128 generators running side by side.
+//!
+//! @ingroup	Controls
+//!
+//! The state of each generator is a lane of four arrays, so filling a list of floats updates all the lanes at once
+//! with vector instructions. The numbers are taken from the lanes in turn. Lane i is seeded with the substream
+//! substream * LANES + i.
+
+class Xoshiro128x8
+{
+public:
+
+    //! Number of generators
+    static size_t constexpr LANES = 8;
+
+    //! Constructor.
+    explicit Xoshiro128x8(uint64_t seed = 0, uint32_t stream = 0, uint32_t substream = 0);
+
+    //! Fills a list with floats uniformly distributed in [0, 1).
+    void uniform(Span<float> const & values);
+
+private:
+    uint32_t s0_[LANES];
+    uint32_t s1_[LANES];
+    uint32_t s2_[LANES];
+    uint32_t s3_[LANES];
+    uint32_t buffer_[LANES];    // Numbers generated but not yet used
+    size_t   index_;            // Index of the next number in the buffer
+};
+} // namespace Confetti
+
+#endif // !defined(CONFETTI_XOSHIRO128_H)
@@ -0,0 +1,80 @@
+#if !defined(CONFETTI_TEST_TESTEMITTER_H)
+#define CONFETTI_TEST_TESTEMITTER_H
+
+#pragma once
+
+#include "Confetti/Appearance.h"
+#include "Confetti/Emitter.h"
+#include "Confetti/Environment.h"
+#include "Confetti/ParticleStore.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+
+// Fixtures shared by the tests of the emitters and of the code that updates them
+
+// An emitter that only updates its particles
+class TestEmitter : public Confetti::BasicEmitter
+{
+public:
+    TestEmitter(std::shared_ptr<Confetti::Environment> environment,
+                std::shared_ptr<Confetti::Appearance>  appearance,
+                uint32_t                               streams)
+        : BasicEmitter(nullptr, nullptr, environment, appearance, false, streams)
+    {
+    }
+
+    using BasicEmitter::update;
+
+    virtual void update(float dt) override { updateParticles(dt); }
+    virtual void draw() const override {}
+};
+
+// Gravity, a clip plane at x = 0, and a bouncing surface at y = 0
+inline std::shared_ptr<Confetti::Environment> makeEnvironment()
+{
+    Confetti::Environment::SurfaceList surfaces{
+        Confetti::Environment::Surface(glm::vec4(0.0f, 1.0f, 0.0f, 0.5f), 0.5f)
+    };
+    Confetti::Environment::ClipperList clippers{ glm::vec4(1.0f, 0.0f, 0.0f, 0.0f) };
+    return std::make_shared<Confetti::Environment>(glm::vec3(0.0f, -9.8f, 0.0f),
+                                                   0.0f,
+                                                   glm::vec3(0.0f, 0.0f, 0.0f),
+                                                   0.0f,
+                                                   surfaces,
+                                                   clippers);
+}
+
+// An appearance that changes the color, radius, and rotation of the particles
+inline std::shared_ptr<Confetti::Appearance> makeAppearance()
+{
+    auto appearance = std::make_shared<Confetti::Appearance>();
+    appearance->camera          = nullptr;
+    appearance->colorRate       = glm::vec4(-0.1f, 0.2f, -0.3f, -0.25f);
+    appearance->radiusRate      = 0.5f;
+    appearance->angularVelocity = 1.5f;
+    appearance->size            = 1.0f;
+    return appearance;
+}
+
+// Fills the store with particles in various stages of their lives
+inline void populate(Confetti::ParticleStore & particles, size_t n, unsigned seed = 1)
+{
+    std::minstd_rand rng(seed);
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    for (size_t i = 0; i < n; ++i)
+    {
+        particles.add(2.0f + u(rng),
+                      -1.0f + 2.0f * u(rng),
+                      { 0.5f + u(rng), u(rng), u(rng) },
+                      { 2.0f * u(rng), 5.0f + u(rng), u(rng) },
+                      { 0.5f + 0.5f * u(rng), 0.5f + 0.5f * u(rng), 0.5f + 0.5f * u(rng), 1.0f },
+                      1.0f + 0.5f * u(rng),
+                      u(rng));
+    }
+}
+
+#endif // !defined(CONFETTI_TEST_TESTEMITTER_H)
@@ -0,0 +1,81 @@
+#include "Confetti/Appearance.h"
+#include "Confetti/Builder.h"
+#include "Confetti/Configuration.h"
+#include "Confetti/EmitterVolume.h"
+#include "Confetti/Environment.h"
+#include "Confetti/PointParticle.h"
+#include "Confetti/SamplePool.h"
+#include "gtest/gtest.h"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <set>
+#include <tuple>
+#include <vector>
+
+using namespace Confetti;
+
+TEST(BuilderTest, buildPointParticles_deterministic)
+{
+    Configuration::Emitter configuration;
+    configuration.name_     = "emitter";
+    configuration.minSpeed_ = 1.0f;
+    configuration.maxSpeed_ = 2.0f;
+    configuration.lifetime_ = 3.0f;
+    configuration.spread_   = 0.5f;
+
+    EmitterSphere volume(2.0f);
+    Environment   environment(glm::vec3(0.0f, -9.8f, 0.0f));
+    Appearance    appearance;
+
+    // The particles are the same no matter how many threads generate them
+
+    int const n = 3 * (int)Builder::CHUNK_SIZE + 17;
+    Builder   serial(7, 1);
+    Builder   parallel(7, 4);
+    std::vector<PointParticle> expected = serial.buildPointParticles(n, configuration, volume, environment, appearance);
+    std::vector<PointParticle> actual   = parallel.buildPointParticles(n, configuration, volume, environment, appearance);
+    ASSERT_EQ(actual.size(), (size_t)n);
+    for (int i = 0; i < n; ++i)
+    {
+        EXPECT_EQ(actual[i].lifetime(), expected[i].lifetime()) << "particle " << i;
+        EXPECT_EQ(actual[i].age(), expected[i].age()) << "particle " << i;
+        EXPECT_EQ(actual[i].position(), expected[i].position()) << "particle " << i;
+        EXPECT_EQ(actual[i].velocity(), expected[i].velocity()) << "particle " << i;
+    }
+
+    // A different seed gives different particles
+
+    Builder other(8, 4);
+    std::vector<PointParticle> different = other.buildPointParticles(n, configuration, volume, environment, appearance);
+    EXPECT_NE(different[0].position(), expected[0].position());
+    EXPECT_NE(different[n - 1].age(), expected[n - 1].age());
+}
+
+TEST(BuilderTest, buildPointParticles_pooled)
+{
+    Configuration::Emitter configuration;
+    configuration.name_     = "emitter";
+    configuration.minSpeed_ = 1.0f;
+    configuration.maxSpeed_ = 2.0f;
+    configuration.lifetime_ = 3.0f;
+    configuration.spread_   = 0.5f;
+
+    SamplePool  pool(std::make_shared<EmitterBox>(glm::vec3(1.0f)), 4 * Builder::CHUNK_SIZE);
+    Environment environment(glm::vec3(0.0f, -9.8f, 0.0f));
+    Appearance  appearance;
+
+    // The chunks of the emitter take different parts of one block of the pool, so no position is repeated
+
+    int const n = 3 * (int)Builder::CHUNK_SIZE + 17;
+    Builder   builder(7, 4);
+    std::vector<PointParticle> particles = builder.buildPointParticles(n, configuration, pool, environment, appearance);
+    std::set<std::tuple<float, float, float>> positions;
+    for (auto const & particle : particles)
+    {
+        glm::vec3 const p = particle.position();
+        positions.emplace(p.x, p.y, p.z);
+    }
+    EXPECT_EQ(positions.size(), (size_t)n);
+}
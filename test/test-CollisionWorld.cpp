@@ -0,0 +1,101 @@
+#include "Confetti/CollisionWorld.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+using namespace Confetti;
+
+namespace
+{
+// A grid of n x n unit quads in the plane y = 0, facing up
+CollisionWorld::QuadList floorGrid(int n, float dampening = 1.0f)
+{
+    CollisionWorld::QuadList quads;
+    for (int i = 0; i < n; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            quads.push_back({ glm::vec3(float(i), 0.0f, float(j)),
+                              glm::vec3(0.0f, 0.0f, 1.0f),
+                              glm::vec3(1.0f, 0.0f, 0.0f),
+                              dampening });
+        }
+    }
+    return quads;
+}
+} // anonymous namespace
+
+TEST(CollisionWorldTest, Constructor)
+{
+    CollisionWorld empty({});
+    EXPECT_EQ(empty.size(), 0u);
+    EXPECT_TRUE(empty.bounds().empty());
+
+    CollisionWorld world(floorGrid(10));
+    EXPECT_EQ(world.size(), 100u);
+    EXPECT_EQ(world.bounds().min, glm::vec3(0.0f, 0.0f, 0.0f));
+    EXPECT_EQ(world.bounds().max, glm::vec3(10.0f, 0.0f, 10.0f));
+}
+
+TEST(CollisionWorldTest, query)
+{
+    CollisionWorld world(floorGrid(32));
+
+    // A small box finds only the quads around it, not all of them
+    std::vector<uint32_t> quads;
+    world.query(BoundingBox{ glm::vec3(5.25f, -1.0f, 7.25f), glm::vec3(5.75f, 1.0f, 7.75f) }, quads);
+    EXPECT_EQ(quads.size(), 1u);
+
+    quads.clear();
+    world.query(BoundingBox{ glm::vec3(4.5f, -1.0f, 4.5f), glm::vec3(6.5f, 1.0f, 6.5f) }, quads);
+    EXPECT_EQ(quads.size(), 9u);
+    std::sort(quads.begin(), quads.end());
+    EXPECT_TRUE(std::unique(quads.begin(), quads.end()) == quads.end());
+
+    quads.clear();
+    world.query(BoundingBox{ glm::vec3(-5.0f, -1.0f, -5.0f), glm::vec3(-4.0f, 1.0f, -4.0f) }, quads);
+    EXPECT_TRUE(quads.empty());
+}
+
+TEST(CollisionWorldTest, collide)
+{
+    CollisionWorld world(floorGrid(4, 0.5f));
+
+    // A particle passing through a quad from the front bounces
+    glm::vec3 to(1.5f, -0.5f, 1.5f);
+    glm::vec3 velocity(0.0f, -2.0f, 0.0f);
+    EXPECT_TRUE(world.collide(glm::vec3(1.5f, 0.5f, 1.5f), to, velocity));
+    EXPECT_FLOAT_EQ(to.y, 0.25f);
+    EXPECT_FLOAT_EQ(velocity.y, 1.0f);
+
+    // A particle passing beside the quads doesn't
+    to       = glm::vec3(5.5f, -0.5f, 1.5f);
+    velocity = glm::vec3(0.0f, -2.0f, 0.0f);
+    EXPECT_FALSE(world.collide(glm::vec3(5.5f, 0.5f, 1.5f), to, velocity));
+    EXPECT_EQ(to.y, -0.5f);
+
+    // Neither does a particle passing through from the back
+    to       = glm::vec3(1.5f, 0.5f, 1.5f);
+    velocity = glm::vec3(0.0f, 2.0f, 0.0f);
+    EXPECT_FALSE(world.collide(glm::vec3(1.5f, -0.5f, 1.5f), to, velocity));
+}
+
+TEST(CollisionWorldTest, collide_batch)
+{
+    CollisionWorld world(floorGrid(4));
+
+    std::vector<float> fx{ 1.5f, 9.5f, 2.5f }, fy{ 1.0f, 1.0f, 1.0f }, fz{ 1.5f, 1.5f, 2.5f };
+    std::vector<float> px{ 1.5f, 9.5f, 2.5f }, py{ -1.0f, -1.0f, -1.0f }, pz{ 1.5f, 1.5f, 2.5f };
+    std::vector<float> vx(3, 0.0f), vy(3, -2.0f), vz(3, 0.0f);
+    std::vector<float> ages{ 1.0f, 1.0f, 0.5f };
+
+    // The third particle was born during the update, so its previous position is meaningless and it is ignored
+    world.collide(Vec3Span<float const>{ fx, fy, fz }, Vec3Span<float>{ px, py, pz }, Vec3Span<float>{ vx, vy, vz },
+                  ages, 1.0f);
+
+    EXPECT_FLOAT_EQ(py[0], 1.0f);
+    EXPECT_FLOAT_EQ(vy[0], 2.0f);
+    EXPECT_FLOAT_EQ(py[1], -1.0f);
+    EXPECT_FLOAT_EQ(vy[1], -2.0f);
+    EXPECT_FLOAT_EQ(py[2], -1.0f);
+}
@@ -0,0 +1,128 @@
+#include "Confetti/DepthSorter.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace Confetti;
+
+TEST(DepthSorterTest, descendingKey)
+{
+    float const values[] = { -1.0e10f, -2.0f, -1.0f, -0.0f, 0.0f, 1.0e-30f, 0.5f, 1.0f, 2.0f, 1.0e10f };
+    for (size_t i = 1; i < sizeof(values) / sizeof(values[0]); ++i)
+    {
+        EXPECT_GE(DepthSorter::descendingKey(values[i - 1]), DepthSorter::descendingKey(values[i])) << values[i];
+    }
+}
+
+TEST(DepthSorterTest, sort_empty)
+{
+    DepthSorter           sorter;
+    std::vector<float>    x, y, z;
+    std::vector<uint32_t> order{ 1, 2, 3 };
+    sorter.sort(Vec3Span<float const>{ x, y, z }, glm::vec3(0.0f), order);
+    EXPECT_TRUE(order.empty());
+}
+
+TEST(DepthSorterTest, sort_backToFront)
+{
+    std::minstd_rand                      rng(1);
+    std::uniform_real_distribution<float> u(-100.0f, 100.0f);
+
+    size_t const       n = 50000;
+    std::vector<float> x(n), y(n), z(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        // Every tenth particle is at the same position as the one before it, to check that the sort is stable
+        if (i % 10 == 9)
+        {
+            x[i] = x[i - 1];
+            y[i] = y[i - 1];
+            z[i] = z[i - 1];
+        }
+        else
+        {
+            x[i] = u(rng);
+            y[i] = u(rng);
+            z[i] = u(rng);
+        }
+    }
+
+    glm::vec3 const viewpoint(10.0f, 20.0f, -30.0f);
+    auto distance2 = [&] (uint32_t i) {
+                         float dx = x[i] - viewpoint.x;
+                         float dy = y[i] - viewpoint.y;
+                         float dz = z[i] - viewpoint.z;
+                         return dx * dx + dy * dy + dz * dz;
+                     };
+
+    std::vector<uint32_t> expected(n);
+    std::iota(expected.begin(), expected.end(), 0);
+    std::stable_sort(expected.begin(), expected.end(), [&] (uint32_t a, uint32_t b) {
+                         return distance2(a) > distance2(b);
+                     });
+
+    DepthSorter           sorter;
+    std::vector<uint32_t> order;
+    sorter.sort(Vec3Span<float const>{ x, y, z }, viewpoint, order);
+    EXPECT_EQ(order, expected);
+
+    // Sorting again with the same sorter gives the same result
+    sorter.sort(Vec3Span<float const>{ x, y, z }, viewpoint, order);
+    EXPECT_EQ(order, expected);
+}
+
+TEST(DepthSorterTest, sort_incremental)
+{
+    std::minstd_rand                      rng(2);
+    std::uniform_real_distribution<float> u(-100.0f, 100.0f);
+
+    size_t const       n = 10000;
+    std::vector<float> x(n), y(n), z(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = u(rng);
+        y[i] = u(rng);
+        z[i] = u(rng);
+    }
+    Vec3Span<float const> positions{ x, y, z };
+    glm::vec3             viewpoint(0.0f, 0.0f, -200.0f);
+
+    DepthSorter sorter;
+    sorter.setIncremental(true);
+    sorter.setResortThreshold(0.05f);
+
+    // The first sort is a full sort
+    std::vector<uint32_t> order;
+    sorter.sort(positions, viewpoint, order);
+    EXPECT_EQ(sorter.lastResult(), DepthSorter::Result::SORTED);
+
+    // Moving less than the threshold does nothing
+    viewpoint.x += 0.01f;
+    sorter.sort(positions, viewpoint, order);
+    EXPECT_EQ(sorter.lastResult(), DepthSorter::Result::SKIPPED);
+
+    // Moving a little more repairs the order, and the result is the same as a full sort
+    viewpoint.x += 0.1f;
+    sorter.sort(positions, viewpoint, order);
+    EXPECT_EQ(sorter.lastResult(), DepthSorter::Result::REPAIRED);
+    EXPECT_GT(sorter.inversions(), 0);
+
+    DepthSorter           full;
+    std::vector<uint32_t> expected;
+    full.sort(positions, viewpoint, expected);
+    ASSERT_EQ(order.size(), expected.size());
+    for (size_t i = 1; i < n; ++i)
+    {
+        EXPECT_LE(DepthSorter::descendingKey(glm::length(positions[order[i - 1]] - viewpoint)),
+                  DepthSorter::descendingKey(glm::length(positions[order[i]] - viewpoint)));
+    }
+
+    // Moving to the other side reverses the order, so a full sort is done instead
+    viewpoint.z = 200.0f;
+    sorter.sort(positions, viewpoint, order);
+    EXPECT_EQ(sorter.lastResult(), DepthSorter::Result::SORTED);
+    EXPECT_EQ(order, [&] () { full.sort(positions, viewpoint, expected); return expected; }());
+}
@@ -0,0 +1,119 @@
+#include "Confetti/DistanceField.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+
+using namespace Confetti;
+
+namespace
+{
+// A field of a sphere of radius 1 at the origin, sampled every 0.25 over [-2, 2]
+DistanceField sphereField()
+{
+    int const          n = 17;
+    std::vector<float> distances;
+    for (int z = 0; z < n; ++z)
+    {
+        for (int y = 0; y < n; ++y)
+        {
+            for (int x = 0; x < n; ++x)
+            {
+                glm::vec3 p = glm::vec3(-2.0f) + glm::vec3((float)x, (float)y, (float)z) * 0.25f;
+                distances.push_back(glm::length(p) - 1.0f);
+            }
+        }
+    }
+    return DistanceField(glm::ivec3(n, n, n), glm::vec3(-2.0f), 0.25f, distances);
+}
+
+// A closed unit cube centered at the origin
+void cube(std::vector<glm::vec3> & vertices, std::vector<uint32_t> & indices)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        vertices.push_back(glm::vec3((i & 1) ? 0.5f : -0.5f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 0.5f : -0.5f));
+    }
+    indices = { 0, 2, 1, 1, 2, 3,   4, 5, 6, 5, 7, 6,   0, 1, 4, 1, 5, 4,
+                2, 6, 3, 3, 6, 7,   0, 4, 2, 2, 4, 6,   1, 3, 5, 3, 7, 5 };
+}
+} // anonymous namespace
+
+TEST(DistanceFieldTest, sample)
+{
+    DistanceField field = sphereField();
+    EXPECT_EQ(field.bounds().min, glm::vec3(-2.0f));
+    EXPECT_EQ(field.bounds().max, glm::vec3(2.0f));
+
+    float     distance;
+    glm::vec3 gradient;
+    ASSERT_TRUE(field.sample(glm::vec3(1.5f, 0.0f, 0.0f), distance, gradient));
+    EXPECT_NEAR(distance, 0.5f, 1e-5f);
+    EXPECT_NEAR(gradient.x, 1.0f, 0.05f);
+    EXPECT_NEAR(gradient.y, 0.0f, 1e-5f);
+
+    ASSERT_TRUE(field.sample(glm::vec3(0.0f, -0.6f, 0.0f), distance, gradient));
+    EXPECT_NEAR(distance, -0.4f, 0.02f);
+    EXPECT_LT(gradient.y, 0.0f);
+
+    EXPECT_FALSE(field.sample(glm::vec3(3.0f, 0.0f, 0.0f), distance, gradient));
+}
+
+TEST(DistanceFieldTest, collide)
+{
+    DistanceField field = sphereField();
+
+    // One particle inside moving inward, one inside moving outward, one outside, and one that is dead
+    std::vector<float> px{ 10.9f, 11.0f, 12.5f, 11.0f }, py(4, 0.0f), pz(4, 0.0f);
+    std::vector<float> vx{ -1.0f, 1.0f, -1.0f, -1.0f }, vy(4, 0.0f), vz(4, 0.0f);
+    std::vector<float> ages{ 1.0f, 1.0f, 1.0f, -1.0f };
+
+    field.collide(Vec3Span<float>{ px, py, pz }, Vec3Span<float>{ vx, vy, vz }, ages, glm::vec3(10.0f, 0.0f, 0.0f), 0.5f);
+
+    EXPECT_NEAR(px[0], 11.05f, 0.01f);
+    EXPECT_NEAR(vx[0], 0.5f, 0.01f);
+    EXPECT_NEAR(px[1], 11.0f, 0.01f);
+    EXPECT_EQ(vx[1], 1.0f);
+    EXPECT_EQ(px[2], 12.5f);
+    EXPECT_EQ(px[3], 11.0f);
+    EXPECT_EQ(vx[3], -1.0f);
+}
+
+TEST(DistanceFieldTest, fromMesh)
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<uint32_t>  indices;
+    cube(vertices, indices);
+
+    DistanceField field = DistanceField::fromMesh(vertices, indices, 0.125f, 0.5f);
+
+    float     distance;
+    glm::vec3 gradient;
+    ASSERT_TRUE(field.sample(glm::vec3(0.0f), distance, gradient));
+    EXPECT_NEAR(distance, -0.5f, 1e-4f);
+    ASSERT_TRUE(field.sample(glm::vec3(0.75f, 0.0f, 0.0f), distance, gradient));
+    EXPECT_NEAR(distance, 0.25f, 1e-4f);
+    ASSERT_TRUE(field.sample(glm::vec3(0.0f, 0.0f, -0.25f), distance, gradient));
+    EXPECT_NEAR(distance, -0.25f, 1e-4f);
+    EXPECT_LT(gradient.z, 0.0f);
+}
+
+TEST(DistanceFieldTest, saveAndLoad)
+{
+    DistanceField field = sphereField();
+    field.save("test-DistanceField.sdf");
+    DistanceField loaded = DistanceField::load("test-DistanceField.sdf");
+    std::remove("test-DistanceField.sdf");
+
+    EXPECT_EQ(loaded.size().x, field.size().x);
+    EXPECT_EQ(loaded.origin(), field.origin());
+    EXPECT_EQ(loaded.spacing(), field.spacing());
+
+    float     d0, d1;
+    glm::vec3 g0, g1;
+    ASSERT_TRUE(field.sample(glm::vec3(0.3f, -0.7f, 1.1f), d0, g0));
+    ASSERT_TRUE(loaded.sample(glm::vec3(0.3f, -0.7f, 1.1f), d1, g1));
+    EXPECT_EQ(d0, d1);
+    EXPECT_EQ(g0, g1);
+
+    EXPECT_THROW(DistanceField::load("does-not-exist.sdf"), std::runtime_error);
+}
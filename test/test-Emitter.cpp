@@ -0,0 +1,347 @@
+#include "Confetti/Appearance.h"
+#include "Confetti/Emitter.h"
+#include "Confetti/Environment.h"
+#include "Confetti/Frustum.h"
+#include "Confetti/ParticleStore.h"
+#include "Confetti/WindField.h"
+#include "TestEmitter.h"
+#include "gtest/gtest.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace Confetti;
+
+namespace
+{
+// Checks that the analytic bound reaches the clip plane at x = 0 when a force of the environment can carry the
+// particles of an emitter at (x, 0, 0) across it, and that the particles that cross it are clipped
+void expectBoundsCrossPlane(float x, std::function<void(Environment &)> const & addForce)
+{
+    Environment::ClipperList clippers{ glm::vec4(-1.0f, 0.0f, 0.0f, 0.0f) };
+    auto environment = std::make_shared<Environment>(glm::vec3(0.0f),
+                                                     0.5f,
+                                                     glm::vec3(0.0f),
+                                                     0.0f,
+                                                     Environment::SurfaceList(),
+                                                     clippers);
+    addForce(*environment);
+    std::shared_ptr<Appearance> appearance = makeAppearance();
+
+    TestEmitter emitter(environment, appearance, 0);
+    emitter.update(glm::vec3(x, 0.0f, 0.0f), glm::vec3(0.0f));
+    populate(emitter.particles(), 1000);
+
+    for (int frame = 0; frame < 240; ++frame)
+    {
+        emitter.update(1.0f / 30.0f);
+        EXPECT_FALSE(environment->clipperPlanes().inFront(emitter.analyticBounds())) << "frame " << frame;
+
+        for (size_t i = 0; i < emitter.aliveCount(); ++i)
+        {
+            ASSERT_LE(emitter.particles().positions()[i].x, 0.0f) << "frame " << frame << ", particle " << i;
+        }
+    }
+}
+} // anonymous namespace
+
+TEST(EmitterTest, aliveCount)
+{
+    // A clip plane at y = 0 below the emitter, so particles are clipped as they fall
+    Environment::ClipperList clippers{ glm::vec4(0.0f, 1.0f, 0.0f, 0.0f) };
+    auto environment = std::make_shared<Environment>(glm::vec3(0.0f, -9.8f, 0.0f),
+                                                     0.0f,
+                                                     glm::vec3(0.0f, 0.0f, 0.0f),
+                                                     0.0f,
+                                                     Environment::SurfaceList(),
+                                                     clippers);
+    std::shared_ptr<Appearance> appearance = makeAppearance();
+
+    TestEmitter emitter(environment, appearance, 0);
+    populate(emitter.particles(), 1000);
+    EXPECT_EQ(emitter.aliveCount(), 0u);
+
+    for (int frame = 0; frame < 90; ++frame)
+    {
+        emitter.update(1.0f / 30.0f);
+
+        // The live particles are all at the front of the store
+        Span<float const> ages = emitter.particles().ages();
+        size_t const      alive = emitter.aliveCount();
+        for (size_t i = 0; i < ages.size(); ++i)
+        {
+            ASSERT_EQ(ages[i] >= 0.0f, i < alive) << "frame " << frame << ", particle " << i;
+        }
+    }
+    EXPECT_GT(emitter.aliveCount(), 0u);
+    EXPECT_LT(emitter.aliveCount(), emitter.particles().size());
+}
+
+TEST(EmitterTest, emissionRate)
+{
+    auto environment = std::make_shared<Environment>(glm::vec3(0.0f, -9.8f, 0.0f));
+    std::shared_ptr<Appearance> appearance = makeAppearance();
+
+    TestEmitter emitter(environment, appearance, 0);
+    for (int i = 0; i < 1000; ++i)
+    {
+        emitter.particles().add(1.0f, 0.0f, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec4(1.0f));
+    }
+    EXPECT_TRUE(emitter.looping());
+    emitter.setEmissionRate(300.0f);
+    EXPECT_FALSE(emitter.looping());
+
+    // 10 particles are emitted per frame and each lives for 30 frames
+
+    float const dt = 1.0f / 30.0f;
+    for (int frame = 0; frame < 90; ++frame)
+    {
+        emitter.update(dt);
+
+        size_t const expected = std::min(frame + 1, 29) * 10;
+        ASSERT_NEAR((float)emitter.aliveCount(), (float)expected, 10.0f) << "frame " << frame;
+
+        // The live particles are at the front, and particles emitted during an update are younger than dt
+        Span<float const> ages = emitter.particles().ages();
+        for (size_t i = 0; i < emitter.aliveCount(); ++i)
+        {
+            ASSERT_GE(ages[i], 0.0f);
+            ASSERT_LT(ages[i], 1.0f);
+        }
+    }
+
+    // Stopping the emission frees all the particles once they reach the end of their lifetimes
+
+    emitter.setEmissionRate(0.0f);
+    for (int frame = 0; frame < 31; ++frame)
+    {
+        emitter.update(dt);
+    }
+    EXPECT_EQ(emitter.aliveCount(), 0u);
+}
+
+TEST(EmitterTest, burst)
+{
+    auto environment = std::make_shared<Environment>(glm::vec3(0.0f, -9.8f, 0.0f));
+    std::shared_ptr<Appearance> appearance = makeAppearance();
+
+    TestEmitter emitter(environment, appearance, 0);
+    for (int i = 0; i < 100; ++i)
+    {
+        emitter.particles().add(0.5f, 0.0f, glm::vec3(1.0f, 2.0f, 3.0f), glm::vec3(0.0f), glm::vec4(1.0f));
+    }
+
+    // A burst is emitted at the start of the next update, from the birth state of the particles
+
+    float const dt = 0.1f;
+    emitter.burst(40);
+    EXPECT_EQ(emitter.aliveCount(), 0u);
+    emitter.update(dt);
+    ASSERT_EQ(emitter.aliveCount(), 40u);
+    for (size_t i = 0; i < 40; ++i)
+    {
+        EXPECT_NEAR(emitter.particles().ages()[i], dt, dt / 100.0f);
+        EXPECT_NEAR(emitter.particles().positions()[i].y, 2.0f - 0.5f * 9.8f * dt * dt, 1.0e-3f);
+    }
+
+    // Particles that don't fit in the pool are not emitted
+
+    emitter.burst(100);
+    emitter.update(dt);
+    EXPECT_EQ(emitter.aliveCount(), 100u);
+
+    // The particles are freed at the end of their lifetimes instead of looping
+
+    for (int frame = 0; frame < 5; ++frame)
+    {
+        emitter.update(dt);
+    }
+    EXPECT_EQ(emitter.aliveCount(), 0u);
+}
+
+TEST(EmitterTest, interpolation)
+{
+    auto environment = std::make_shared<Environment>(glm::vec3(0.0f, -9.8f, 0.0f));
+    std::shared_ptr<Appearance> appearance = makeAppearance();
+
+    TestEmitter emitter(environment, appearance, 0);
+    populate(emitter.particles(), 100);
+    emitter.setInterpolated(true);
+    ASSERT_TRUE(emitter.particles().has(ParticleStore::PREVIOUS));
+
+    float const dt = 1.0f / 30.0f;
+    for (int frame = 0; frame < 30; ++frame)
+    {
+        emitter.update(dt);
+    }
+
+    ParticleStore const & particles = emitter.particles();
+    for (size_t i = 0; i < emitter.aliveCount(); ++i)
+    {
+        glm::vec3 current  = particles.positions()[i];
+        glm::vec3 previous = particles.previousPositions()[i];
+        bool      newborn = particles.ages()[i] < dt;
+
+        emitter.setInterpolationFactor(1.0f);
+        EXPECT_EQ(emitter.interpolatedPosition(i), current);
+        emitter.setInterpolationFactor(0.0f);
+        EXPECT_EQ(emitter.interpolatedPosition(i), newborn ? current : previous);
+    }
+}
+
+TEST(EmitterTest, bounds)
+{
+    Environment::ClipperList clippers{ glm::vec4(0.0f, 1.0f, 0.0f, 0.0f) };
+    auto environment = std::make_shared<Environment>(glm::vec3(0.0f, -9.8f, 0.0f),
+                                                     0.0f,
+                                                     glm::vec3(0.0f, 0.0f, 0.0f),
+                                                     0.0f,
+                                                     Environment::SurfaceList(),
+                                                     clippers);
+    std::shared_ptr<Appearance> appearance = makeAppearance();
+
+    // The near emitter is at the clip plane, and the far emitter is high above it
+    TestEmitter near(environment, appearance, 0);
+    populate(near.particles(), 1000);
+
+    TestEmitter far(environment, appearance, 0);
+    far.update(glm::vec3(0.0f, 1000.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f));
+    populate(far.particles(), 1000);
+
+    for (int frame = 0; frame < 120; ++frame)
+    {
+        near.update(1.0f / 30.0f);
+        far.update(1.0f / 30.0f);
+        EXPECT_FALSE(near.skippedPlanes());
+
+        // The bounds contain every live particle, and the analytic bounds contain the bounds
+        BoundingBox const & bounds   = far.bounds();
+        BoundingBox const   analytic = far.analyticBounds();
+        for (size_t i = 0; i < far.aliveCount(); ++i)
+        {
+            glm::vec3 p = far.particles().positions()[i];
+            ASSERT_TRUE(bounds.contains(p)) << "frame " << frame << ", particle " << i;
+        }
+        EXPECT_TRUE(analytic.contains(bounds)) << "frame " << frame;
+    }
+
+    // Once the particles that started away from the emitter have all been reborn, the clip plane can be skipped
+    EXPECT_TRUE(far.skippedPlanes());
+}
+
+TEST(EmitterTest, bounds_movingEmitter)
+{
+    auto environment = std::make_shared<Environment>(glm::vec3(0.0f, -9.8f, 0.0f));
+    std::shared_ptr<Appearance> appearance = makeAppearance();
+
+    // The emitter moves, but reports that it is not moving, so the bound can't assume a constant velocity
+    TestEmitter emitter(environment, appearance, 0);
+    populate(emitter.particles(), 1000);
+
+    for (int frame = 0; frame < 120; ++frame)
+    {
+        emitter.update(glm::vec3(5.0f * frame, 0.0f, 0.0f), glm::vec3(0.0f));
+        emitter.update(1.0f / 30.0f);
+
+        BoundingBox const analytic = emitter.analyticBounds();
+        for (size_t i = 0; i < emitter.aliveCount(); ++i)
+        {
+            ASSERT_TRUE(analytic.contains(emitter.particles().positions()[i])) << "frame " << frame << ", particle " << i;
+        }
+    }
+}
+
+TEST(EmitterTest, bounds_gusts)
+{
+    // The emitters are at x = -20, and the particles can only reach the clip plane at x = 0 if gusts blow them there
+    Environment::ClipperList clippers{ glm::vec4(-1.0f, 0.0f, 0.0f, 0.0f) };
+    auto calm = std::make_shared<Environment>(glm::vec3(0.0f),
+                                              0.5f,
+                                              glm::vec3(0.0f),
+                                              0.0f,
+                                              Environment::SurfaceList(),
+                                              clippers);
+    auto gusty = std::make_shared<Environment>(glm::vec3(0.0f),
+                                               0.5f,
+                                               glm::vec3(0.0f),
+                                               300.0f,
+                                               Environment::SurfaceList(),
+                                               clippers);
+    std::shared_ptr<Appearance> appearance = makeAppearance();
+
+    TestEmitter calmEmitter(calm, appearance, 0);
+    calmEmitter.update(glm::vec3(-20.0f, 0.0f, 0.0f), glm::vec3(0.0f));
+    populate(calmEmitter.particles(), 1000);
+    TestEmitter gustyEmitter(gusty, appearance, 0);
+    gustyEmitter.update(glm::vec3(-20.0f, 0.0f, 0.0f), glm::vec3(0.0f));
+    populate(gustyEmitter.particles(), 1000);
+
+    // Wait until the particles that started at the origin have all been reborn at the emitters
+    for (int frame = 0; frame < 120; ++frame)
+    {
+        calmEmitter.update(1.0f / 30.0f);
+        gustyEmitter.update(1.0f / 30.0f);
+    }
+
+    // The particles have not actually been blown anywhere, but gusts could have blown them across the plane
+    EXPECT_TRUE(gustyEmitter.analyticBounds().contains(calmEmitter.analyticBounds()));
+    EXPECT_TRUE(calm->clipperPlanes().inFront(calmEmitter.analyticBounds()));
+    EXPECT_FALSE(gusty->clipperPlanes().inFront(gustyEmitter.analyticBounds()));
+    EXPECT_TRUE(calmEmitter.skippedPlanes());
+}
+
+TEST(EmitterTest, bounds_windField)
+{
+    // The wind field blows the particles across the clip plane
+    std::vector<glm::vec3> velocities(8, glm::vec3(40.0f, 0.0f, 0.0f));
+    auto field = std::make_shared<WindField>(glm::ivec3(2, 2, 2), glm::vec3(-1.0f), 2.0f, velocities);
+    expectBoundsCrossPlane(-20.0f, [&field] (Environment & environment) { environment.setWindField(field); });
+}
+
+TEST(EmitterTest, bounds_turbulence)
+{
+    // The turbulence swirls some of the particles across the clip plane
+    Turbulence const turbulence(0.1f, 8.0f);
+    expectBoundsCrossPlane(-8.0f, [&turbulence] (Environment & environment) { environment.setTurbulence(turbulence); });
+}
+
+TEST(EmitterTest, cull)
+{
+    auto environment = std::make_shared<Environment>(glm::vec3(0.0f, -9.8f, 0.0f));
+    std::shared_ptr<Appearance> appearance = makeAppearance();
+
+    TestEmitter emitter(environment, appearance, 0);
+    populate(emitter.particles(), 3000);
+    for (int frame = 0; frame < 30; ++frame)
+    {
+        emitter.update(1.0f / 30.0f);
+    }
+    size_t const chunkSize = BasicEmitter::CULL_CHUNK_SIZE;
+    ASSERT_EQ(emitter.chunkCount(), (emitter.aliveCount() + chunkSize - 1) / chunkSize);
+
+    // Every live particle is within the bounds of its chunk
+    for (size_t i = 0; i < emitter.aliveCount(); ++i)
+    {
+        ASSERT_TRUE(emitter.chunkBounds(i / chunkSize).contains(emitter.particles().positions()[i]));
+    }
+
+    // A huge frustum around the origin sees everything, and one far away sees nothing
+    glm::mat4 everything(0.001f);
+    everything[3][3] = 1.0f;
+    emitter.cull(Frustum(everything));
+    EXPECT_TRUE(emitter.visible());
+    for (size_t i = 0; i < emitter.chunkCount(); ++i)
+    {
+        EXPECT_TRUE(emitter.chunkVisible(i));
+    }
+
+    glm::mat4 nothing(1.0f);
+    nothing[3] = glm::vec4(-1000.0f, 0.0f, 0.0f, 1.0f);
+    emitter.cull(Frustum(nothing));
+    EXPECT_FALSE(emitter.visible());
+}
@@ -0,0 +1,148 @@
+#include "Confetti/EmitterVolume.h"
+#include "gtest/gtest.h"
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace Confetti;
+
+namespace
+{
+size_t constexpr COUNT = 10000;
+
+// Samples COUNT points from a volume
+std::vector<glm::vec3> sample(EmitterVolume const & volume, uint32_t stream = 0)
+{
+    std::vector<float> x(COUNT), y(COUNT), z(COUNT);
+    RngStream          rng(1, stream);
+    volume.sample(Vec3Span<float>{ x, y, z }, rng);
+
+    std::vector<glm::vec3> points;
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        points.emplace_back(x[i], y[i], z[i]);
+    }
+    return points;
+}
+
+// Returns the fraction of the points for which a predicate is true
+double fraction(std::vector<glm::vec3> const & points, std::function<bool(glm::vec3 const &)> predicate)
+{
+    size_t count = 0;
+    for (glm::vec3 const & p : points)
+    {
+        if (predicate(p))
+            ++count;
+    }
+    return (double)count / (double)points.size();
+}
+} // anonymous namespace
+
+TEST(EmitterVolumeTest, point)
+{
+    EmitterPoint volume;
+    for (glm::vec3 const & p : sample(volume))
+    {
+        EXPECT_EQ(p, glm::vec3(0.0f));
+    }
+}
+
+TEST(EmitterVolumeTest, line)
+{
+    std::vector<glm::vec3> points = sample(EmitterLine(4.0f));
+    for (glm::vec3 const & p : points)
+    {
+        ASSERT_GE(p.x, -2.0f);
+        ASSERT_LT(p.x, 2.0f);
+        ASSERT_EQ(p.y, 0.0f);
+        ASSERT_EQ(p.z, 0.0f);
+    }
+    EXPECT_NEAR(fraction(points, [](glm::vec3 const & p) { return p.x < 1.0f; }), 0.75, 0.02);
+}
+
+TEST(EmitterVolumeTest, circle)
+{
+    std::vector<glm::vec3> points = sample(EmitterCircle(2.0f));
+    for (glm::vec3 const & p : points)
+    {
+        ASSERT_LE(glm::length(p), 2.0f + 1.0e-5f);
+        ASSERT_EQ(p.z, 0.0f);
+    }
+
+    // The points are uniform in the area, in all four quadrants
+    EXPECT_NEAR(fraction(points, [](glm::vec3 const & p) { return glm::length(p) < 1.0f; }), 0.25, 0.02);
+    EXPECT_NEAR(fraction(points, [](glm::vec3 const & p) { return p.x < 0.0f && p.y < 0.0f; }), 0.25, 0.02);
+}
+
+TEST(EmitterVolumeTest, sphere)
+{
+    std::vector<glm::vec3> points = sample(EmitterSphere(3.0f));
+    for (glm::vec3 const & p : points)
+    {
+        ASSERT_LE(glm::length(p), 3.0f + 1.0e-5f);
+    }
+
+    // The points are uniform in the volume, in all eight octants
+    EXPECT_NEAR(fraction(points, [](glm::vec3 const & p) { return glm::length(p) < 1.5f; }), 0.125, 0.015);
+    EXPECT_NEAR(fraction(points, [](glm::vec3 const & p) { return p.x < 0.0f && p.y < 0.0f && p.z < 0.0f; }),
+                0.125,
+                0.015);
+}
+
+TEST(EmitterVolumeTest, box)
+{
+    std::vector<glm::vec3> points = sample(EmitterBox(glm::vec3(1.0f, 2.0f, 4.0f)));
+    for (glm::vec3 const & p : points)
+    {
+        ASSERT_LT(std::abs(p.x), 0.5f + 1.0e-6f);
+        ASSERT_LT(std::abs(p.y), 1.0f + 1.0e-6f);
+        ASSERT_LT(std::abs(p.z), 2.0f + 1.0e-6f);
+    }
+}
+
+TEST(EmitterVolumeTest, cone)
+{
+    std::vector<glm::vec3> points = sample(EmitterCone(2.0f, 4.0f));
+    for (glm::vec3 const & p : points)
+    {
+        ASSERT_GE(p.z, 0.0f);
+        ASSERT_LE(p.z, 4.0f + 1.0e-5f);
+        ASSERT_LE(std::sqrt(p.x * p.x + p.y * p.y), 2.0f * p.z / 4.0f + 1.0e-5f);
+    }
+
+    // The bottom half of the cone (the tip) holds 1/8 of its volume
+    EXPECT_NEAR(fraction(points, [](glm::vec3 const & p) { return p.z < 2.0f; }), 0.125, 0.015);
+}
+
+TEST(EmitterVolumeTest, sample_matches_point)
+{
+    std::vector<std::shared_ptr<EmitterVolume>> volumes{ std::make_shared<EmitterLine>(2.0f),
+                                                         std::make_shared<EmitterRectangle>(1.0f, 2.0f),
+                                                         std::make_shared<EmitterCircle>(1.5f),
+                                                         std::make_shared<EmitterSphere>(1.5f),
+                                                         std::make_shared<EmitterBox>(glm::vec3(1.0f, 2.0f, 3.0f)),
+                                                         std::make_shared<EmitterCylinder>(1.0f, 2.0f),
+                                                         std::make_shared<EmitterCone>(1.0f, 2.0f) };
+    for (auto const & volume : volumes)
+    {
+        std::vector<glm::vec3> points = sample(*volume, 7);
+
+        // Each point is the point of the volume for the random numbers in its position
+        std::vector<float> u(COUNT, 0.0f), v(COUNT, 0.0f), w(COUNT, 0.0f);
+        RngStream          rng(1, 7);
+        rng.uniform(u);
+        rng.uniform(v);
+        rng.uniform(w);
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            glm::vec3 expected = volume->point(u[i], v[i], w[i]);
+            ASSERT_NEAR(points[i].x, expected.x, 1.0e-6f);
+            ASSERT_NEAR(points[i].y, expected.y, 1.0e-6f);
+            ASSERT_NEAR(points[i].z, expected.z, 1.0e-6f);
+        }
+    }
+}
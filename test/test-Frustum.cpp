@@ -0,0 +1,42 @@
+#include "Confetti/BoundingBox.h"
+#include "Confetti/Frustum.h"
+#include "gtest/gtest.h"
+
+using namespace Confetti;
+
+namespace
+{
+// The identity view-projection gives the frustum -1 <= x, y, z <= 1. The translated one moves it by +10 in x.
+glm::mat4 const IDENTITY(1.0f);
+
+glm::mat4 translated()
+{
+    glm::mat4 m(1.0f);
+    m[3] = glm::vec4(-10.0f, 0.0f, 0.0f, 1.0f);
+    return m;
+}
+} // anonymous namespace
+
+TEST(FrustumTest, contains)
+{
+    Frustum frustum(IDENTITY);
+    EXPECT_TRUE(frustum.contains(glm::vec3(0.0f, 0.0f, 0.0f)));
+    EXPECT_TRUE(frustum.contains(glm::vec3(1.0f, -1.0f, 1.0f)));
+    EXPECT_FALSE(frustum.contains(glm::vec3(1.5f, 0.0f, 0.0f)));
+    EXPECT_FALSE(frustum.contains(glm::vec3(0.0f, 0.0f, -2.0f)));
+
+    Frustum moved(translated());
+    EXPECT_FALSE(moved.contains(glm::vec3(0.0f, 0.0f, 0.0f)));
+    EXPECT_TRUE(moved.contains(glm::vec3(10.0f, 0.0f, 0.0f)));
+}
+
+TEST(FrustumTest, intersects)
+{
+    Frustum frustum(IDENTITY);
+    EXPECT_FALSE(frustum.intersects(BoundingBox()));
+    EXPECT_TRUE(frustum.intersects(BoundingBox{ glm::vec3(-0.5f), glm::vec3(0.5f) }));
+    EXPECT_TRUE(frustum.intersects(BoundingBox{ glm::vec3(-5.0f), glm::vec3(5.0f) }));
+    EXPECT_TRUE(frustum.intersects(BoundingBox{ glm::vec3(0.5f), glm::vec3(5.0f) }));
+    EXPECT_FALSE(frustum.intersects(BoundingBox{ glm::vec3(2.0f, -1.0f, -1.0f), glm::vec3(3.0f, 1.0f, 1.0f) }));
+    EXPECT_FALSE(frustum.intersects(BoundingBox{ glm::vec3(-1.0f, -1.0f, -9.0f), glm::vec3(1.0f, 1.0f, -2.0f) }));
+}
@@ -0,0 +1,85 @@
+#include "Confetti/JobScheduler.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <vector>
+
+using namespace Confetti;
+
+TEST(JobSchedulerTest, Constructor)
+{
+    JobScheduler one(1);
+    EXPECT_EQ(one.threadCount(), 1);
+
+    JobScheduler four(4);
+    EXPECT_EQ(four.threadCount(), 4);
+
+    JobScheduler hardware;
+    EXPECT_GE(hardware.threadCount(), 1);
+}
+
+TEST(JobSchedulerTest, run_oneThreadInOrder)
+{
+    JobScheduler        scheduler(1);
+    std::vector<size_t> order;
+    scheduler.run(100, [&order] (size_t i) { order.push_back(i); });
+
+    ASSERT_EQ(order.size(), 100);
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        EXPECT_EQ(order[i], i);
+    }
+}
+
+TEST(JobSchedulerTest, run_eachJobOnce)
+{
+    JobScheduler scheduler(8);
+
+    // Run several batches of different sizes to make sure that the scheduler can be reused
+    for (size_t count : { 0, 1, 7, 1000, 100000 })
+    {
+        std::vector<std::atomic<int>> calls(count);
+        scheduler.run(count, [&calls] (size_t i) { ++calls[i]; });
+        for (size_t i = 0; i < count; ++i)
+        {
+            EXPECT_EQ(calls[i], 1) << "job " << i << " of " << count;
+        }
+    }
+}
+
+TEST(JobSchedulerTest, run_unevenJobs)
+{
+    JobScheduler     scheduler(4);
+    std::atomic<int> total(0);
+
+    // The first jobs take much longer than the rest, so the other threads must steal them
+    scheduler.run(64, [&total] (size_t i) {
+                      volatile int sum = 0;
+                      for (int j = 0; j < (i < 16 ? 100000 : 10); ++j)
+                      {
+                          sum = sum + j;
+                      }
+                      ++total;
+                  });
+    EXPECT_EQ(total, 64);
+}
+
+TEST(JobSchedulerTest, run_nested)
+{
+    JobScheduler scheduler(4);
+
+    // A job that runs a batch of its own runs it in order on its thread
+    std::vector<std::vector<size_t>> orders(16);
+    scheduler.run(orders.size(), [&scheduler, &orders] (size_t i) {
+                      scheduler.run(8, [&orders, i] (size_t j) { orders[i].push_back(j); });
+                  });
+    for (auto const & order : orders)
+    {
+        EXPECT_EQ(order, (std::vector<size_t>{ 0, 1, 2, 3, 4, 5, 6, 7 }));
+    }
+
+    // The scheduler still runs batches in parallel afterwards
+    std::atomic<int> total(0);
+    scheduler.run(1000, [&total] (size_t) { ++total; });
+    EXPECT_EQ(total, 1000);
+}
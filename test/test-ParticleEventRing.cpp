@@ -0,0 +1,118 @@
+#include "Confetti/ParticleEventRing.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+using namespace Confetti;
+
+namespace
+{
+ParticleEvent makeEvent(float id)
+{
+    return { ParticleEvent::BOUNCE, glm::vec3(id, 0.0f, 0.0f), glm::vec3(0.0f, id, 0.0f) };
+}
+} // anonymous namespace
+
+TEST(ParticleEventRingTest, Constructor)
+{
+    ParticleEventRing ring(100);
+    EXPECT_EQ(ring.capacity(), 128u);
+    EXPECT_EQ(ring.dropped(), 0u);
+
+    ParticleEvent event;
+    EXPECT_FALSE(ring.pop(event));
+}
+
+TEST(ParticleEventRingTest, Fifo)
+{
+    ParticleEventRing ring(4);
+
+    // Several laps around the ring
+    for (int lap = 0; lap < 3; ++lap)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            EXPECT_TRUE(ring.push(makeEvent((float)(lap * 3 + i))));
+        }
+        std::vector<ParticleEvent> events;
+        EXPECT_EQ(ring.drain(events), 3u);
+        ASSERT_EQ(events.size(), 3u);
+        for (int i = 0; i < 3; ++i)
+        {
+            EXPECT_EQ(events[i].type, ParticleEvent::BOUNCE);
+            EXPECT_EQ(events[i].position.x, (float)(lap * 3 + i));
+            EXPECT_EQ(events[i].velocity.y, (float)(lap * 3 + i));
+        }
+    }
+    EXPECT_EQ(ring.dropped(), 0u);
+}
+
+TEST(ParticleEventRingTest, Full)
+{
+    ParticleEventRing ring(4);
+    for (int i = 0; i < 6; ++i)
+    {
+        EXPECT_EQ(ring.push(makeEvent((float)i)), i < 4);
+    }
+    EXPECT_EQ(ring.dropped(), 2u);
+
+    // The oldest events are kept
+    ParticleEvent event;
+    ASSERT_TRUE(ring.pop(event));
+    EXPECT_EQ(event.position.x, 0.0f);
+    EXPECT_TRUE(ring.push(makeEvent(6.0f)));
+
+    std::vector<ParticleEvent> events;
+    EXPECT_EQ(ring.drain(events), 4u);
+    EXPECT_EQ(events.back().position.x, 6.0f);
+}
+
+TEST(ParticleEventRingTest, Concurrent)
+{
+    int const THREADS = 4;
+    int const EVENTS  = 20000;
+
+    ParticleEventRing ring(1024);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < THREADS; ++t)
+    {
+        producers.emplace_back([&ring, t] {
+            for (int i = 0; i < EVENTS; ++i)
+            {
+                ParticleEvent event{ ParticleEvent::BIRTH, glm::vec3((float)t), glm::vec3((float)i) };
+                while (!ring.push(event))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Every event is received exactly once, and each thread's events are in order
+    std::vector<int>           received(THREADS, 0);
+    std::vector<ParticleEvent> events;
+    int                        total = 0;
+    while (total < THREADS * EVENTS)
+    {
+        events.clear();
+        total += (int)ring.drain(events);
+        for (ParticleEvent const & event : events)
+        {
+            int t = (int)event.position.x;
+            EXPECT_EQ((int)event.velocity.x, received[t]);
+            ++received[t];
+        }
+    }
+    for (std::thread & producer : producers)
+    {
+        producer.join();
+    }
+
+    for (int t = 0; t < THREADS; ++t)
+    {
+        EXPECT_EQ(received[t], EVENTS);
+    }
+    ParticleEvent event;
+    EXPECT_FALSE(ring.pop(event));
+}
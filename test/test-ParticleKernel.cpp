@@ -0,0 +1,375 @@
+#include "Confetti/Appearance.h"
+#include "Confetti/Emitter.h"
+#include "Confetti/Environment.h"
+#include "Confetti/ParticleEventRing.h"
+#include "Confetti/ParticleKernel.h"
+#include "Confetti/ParticleStore.h"
+#include "Confetti/UpdateContext.h"
+#include "Confetti/WindField.h"
+#include "TestEmitter.h"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace Confetti;
+
+namespace
+{
+void expectNear(Span<float const> expected, Span<float const> actual)
+{
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        float tolerance = ParticleKernel::TOLERANCE * std::max(1.0f, std::abs(expected[i]));
+        EXPECT_NEAR(expected[i], actual[i], tolerance) << "particle " << i;
+    }
+}
+} // anonymous namespace
+
+TEST(ParticleKernelTest, setInstructionSet)
+{
+    ParticleKernel::InstructionSet original  = ParticleKernel::instructionSet();
+    ParticleKernel::InstructionSet supported = ParticleKernel::supportedInstructionSet();
+
+    EXPECT_EQ(ParticleKernel::setInstructionSet(ParticleKernel::InstructionSet::SCALAR),
+              ParticleKernel::InstructionSet::SCALAR);
+    EXPECT_EQ(ParticleKernel::instructionSet(), ParticleKernel::InstructionSet::SCALAR);
+    EXPECT_EQ(ParticleKernel::setInstructionSet(ParticleKernel::InstructionSet::AVX512), supported);
+
+    ParticleKernel::setInstructionSet(original);
+}
+
+TEST(ParticleKernelTest, vectorized_matches_scalar)
+{
+    ParticleKernel::InstructionSet original  = ParticleKernel::instructionSet();
+    ParticleKernel::InstructionSet supported = ParticleKernel::supportedInstructionSet();
+
+    std::shared_ptr<Environment> environment = makeEnvironment();
+    std::shared_ptr<Appearance>  appearance  = makeAppearance();
+    uint32_t const               streams     = ParticleStore::RADIUS | ParticleStore::ROTATION | ParticleStore::TAIL;
+
+    // 1001 particles so that every kernel has a remainder handled by the scalar kernel
+    TestEmitter reference(environment, appearance, streams);
+    populate(reference.particles(), 1001);
+
+    ParticleKernel::setInstructionSet(ParticleKernel::InstructionSet::SCALAR);
+    for (int frame = 0; frame < 60; ++frame)
+    {
+        reference.update(1.0f / 30.0f);
+    }
+
+    for (int i = (int)ParticleKernel::InstructionSet::SSE2; i <= (int)supported; ++i)
+    {
+        ParticleKernel::InstructionSet instructionSet = (ParticleKernel::InstructionSet)i;
+        SCOPED_TRACE(ParticleKernel::name(instructionSet));
+
+        TestEmitter emitter(environment, appearance, streams);
+        populate(emitter.particles(), 1001);
+
+        ParticleKernel::setInstructionSet(instructionSet);
+        for (int frame = 0; frame < 60; ++frame)
+        {
+            emitter.update(1.0f / 30.0f);
+        }
+
+        ParticleStore const & expected = reference.particles();
+        ParticleStore const & actual   = emitter.particles();
+        expectNear(expected.ages(), actual.ages());
+        expectNear(expected.positions().x, actual.positions().x);
+        expectNear(expected.positions().y, actual.positions().y);
+        expectNear(expected.positions().z, actual.positions().z);
+        expectNear(expected.velocities().x, actual.velocities().x);
+        expectNear(expected.velocities().y, actual.velocities().y);
+        expectNear(expected.velocities().z, actual.velocities().z);
+        expectNear(expected.colors().x, actual.colors().x);
+        expectNear(expected.colors().w, actual.colors().w);
+        expectNear(expected.radii(), actual.radii());
+        expectNear(expected.rotations(), actual.rotations());
+        expectNear(expected.tails().y, actual.tails().y);
+    }
+
+    ParticleKernel::setInstructionSet(original);
+}
+
+TEST(ParticleKernelTest, ranges)
+{
+    std::shared_ptr<Environment> environment = makeEnvironment();
+    std::shared_ptr<Appearance>  appearance  = makeAppearance();
+    uint32_t const               streams     = ParticleStore::RADIUS | ParticleStore::ROTATION | ParticleStore::TAIL;
+    float const                  dt          = 1.0f / 30.0f;
+
+    // Two emitters in different places. Their sizes are not multiples of any kernel's width.
+
+    UpdateContext const contextA(*environment, *appearance, glm::vec3(1.0f, 2.0f, 0.0f), glm::vec3(0.5f), dt);
+    UpdateContext const contextB(*environment, *appearance, glm::vec3(-3.0f, 1.0f, 2.0f), glm::vec3(0.0f), dt);
+
+    ParticleStore expectedA(streams);
+    ParticleStore expectedB(streams);
+    populate(expectedA, 1001);
+    populate(expectedB, 37);
+
+    ParticleStore a(streams);
+    ParticleStore b(streams);
+    populate(a, 1001);
+    populate(b, 37);
+
+    ParticleStore group;
+    group.resize(1008 + 48);
+    a.attach(group, 0, 1008);
+    b.attach(group, 1008, 48);
+
+    // Updating the ranges of the group at once is the same as updating the emitters separately
+
+    std::vector<uint8_t> expectedEventsA(1001);
+    std::vector<uint8_t> expectedEventsB(37);
+    std::vector<uint8_t> events(1008 + 37);
+    ParticleKernel::Range const ranges[] = { { 0, 1001, &contextA }, { 1008, 1008 + 37, &contextB } };
+    for (int frame = 0; frame < 60; ++frame)
+    {
+        ParticleKernel::update(expectedA, 0, 1001, contextA, expectedEventsA.data());
+        ParticleKernel::update(expectedB, 0, 37, contextB, expectedEventsB.data());
+        ParticleKernel::update(group, ranges, 2, events.data());
+        for (size_t i = 0; i < 1001; ++i)
+        {
+            ASSERT_EQ(events[i], expectedEventsA[i]) << "frame " << frame << ", particle " << i;
+        }
+        for (size_t i = 0; i < 37; ++i)
+        {
+            ASSERT_EQ(events[1008 + i], expectedEventsB[i]) << "frame " << frame << ", particle " << i;
+        }
+    }
+
+    for (auto const & pair : { std::make_pair(&expectedA, &a), std::make_pair(&expectedB, &b) })
+    {
+        ParticleStore const & expected = *pair.first;
+        ParticleStore const & actual   = *pair.second;
+        expectNear(expected.ages(), actual.ages());
+        expectNear(expected.positions().x, actual.positions().x);
+        expectNear(expected.positions().y, actual.positions().y);
+        expectNear(expected.positions().z, actual.positions().z);
+        expectNear(expected.velocities().y, actual.velocities().y);
+        expectNear(expected.colors().x, actual.colors().x);
+        expectNear(expected.radii(), actual.radii());
+        expectNear(expected.rotations(), actual.rotations());
+        expectNear(expected.tails().y, actual.tails().y);
+    }
+}
+
+TEST(ParticleKernelTest, events)
+{
+    ParticleKernel::InstructionSet original  = ParticleKernel::instructionSet();
+    ParticleKernel::InstructionSet supported = ParticleKernel::supportedInstructionSet();
+
+    std::shared_ptr<Environment> environment = makeEnvironment();
+    std::shared_ptr<Appearance>  appearance  = makeAppearance();
+
+    // Counts the events of each type recorded by each instruction set. They must all be the same.
+    std::vector<std::vector<size_t>> counts;
+    for (int i = (int)ParticleKernel::InstructionSet::SCALAR; i <= (int)supported; ++i)
+    {
+        ParticleKernel::InstructionSet instructionSet = (ParticleKernel::InstructionSet)i;
+        SCOPED_TRACE(ParticleKernel::name(instructionSet));
+
+        TestEmitter emitter(environment, appearance, 0);
+        populate(emitter.particles(), 1001);
+        auto ring = std::make_shared<ParticleEventRing>(4096);
+        emitter.setEvents(ring);
+
+        ParticleKernel::setInstructionSet(instructionSet);
+        std::vector<size_t>        count(ParticleEvent::BOUNCE + 1, 0);
+        std::vector<ParticleEvent> events;
+        for (int frame = 0; frame < 60; ++frame)
+        {
+            emitter.update(1.0f / 30.0f);
+            events.clear();
+            ring->drain(events);
+            for (ParticleEvent const & event : events)
+            {
+                ++count[event.type];
+
+                // Clipped particles are reported where they were clipped, behind the plane x = 0
+                if (event.type == ParticleEvent::CLIP)
+                {
+                    EXPECT_LT(event.position.x, 0.0f);
+                }
+            }
+        }
+        EXPECT_EQ(ring->dropped(), 0u);
+        EXPECT_GT(count[ParticleEvent::BIRTH], 0u);
+        EXPECT_GT(count[ParticleEvent::CLIP], 0u);
+        EXPECT_GT(count[ParticleEvent::BOUNCE], 0u);
+        counts.push_back(count);
+        EXPECT_EQ(counts.front(), count);
+    }
+
+    ParticleKernel::setInstructionSet(original);
+}
+
+TEST(ParticleKernelTest, wind_field)
+{
+    ParticleKernel::InstructionSet original  = ParticleKernel::instructionSet();
+    ParticleKernel::InstructionSet supported = ParticleKernel::supportedInstructionSet();
+
+    // The velocity of the field at (x, y, z) is (x, y, 0)
+    std::vector<glm::vec3> velocities;
+    for (int z = 0; z < 2; ++z)
+    {
+        for (int y = 0; y < 2; ++y)
+        {
+            for (int x = 0; x < 2; ++x)
+            {
+                velocities.push_back(glm::vec3(2.0f * x - 1.0f, 2.0f * y - 1.0f, 0.0f));
+            }
+        }
+    }
+    auto field = std::make_shared<WindField>(glm::ivec3(2, 2, 2), glm::vec3(-1.0f), 2.0f, velocities);
+
+    // The environment has air friction but has not been updated, so the terminal velocity is 0 and only the wind field
+    // moves the particles.
+    auto environment = std::make_shared<Environment>(glm::vec3(0.0f), 0.5f);
+    environment->setWindField(field);
+    EXPECT_FALSE(environment->isAnalytic());
+    UpdateContext context(*environment, *makeAppearance(), glm::vec3(0.0f), glm::vec3(0.0f), 0.1f);
+
+    for (int i = (int)ParticleKernel::InstructionSet::SCALAR; i <= (int)supported; ++i)
+    {
+        ParticleKernel::InstructionSet instructionSet = (ParticleKernel::InstructionSet)i;
+        SCOPED_TRACE(ParticleKernel::name(instructionSet));
+        ParticleKernel::setInstructionSet(instructionSet);
+
+        ParticleStore particles;
+        for (int j = 0; j < 37; ++j)
+        {
+            glm::vec3 position(std::sin(j * 1.0f), std::cos(j * 2.0f), 0.5f);
+            particles.add(100.0f, 1.0f, position, glm::vec3(0.0f), glm::vec4(1.0f));
+        }
+
+        // Update all but the first particle
+        ParticleKernel::update(particles, 1, particles.size(), context);
+
+        EXPECT_EQ(particles.positions()[0], glm::vec3(std::sin(0.0f), std::cos(0.0f), 0.5f));
+        for (size_t j = 1; j < particles.size(); ++j)
+        {
+            glm::vec3 initial  = particles.initialPositions()[j];
+            glm::vec3 position = particles.positions()[j];
+            EXPECT_NEAR(position.x, initial.x + 0.1f * initial.x, 1.0e-6f);
+            EXPECT_NEAR(position.y, initial.y + 0.1f * initial.y, 1.0e-6f);
+            EXPECT_EQ(position.z, initial.z);
+        }
+    }
+
+    ParticleKernel::setInstructionSet(original);
+}
+
+TEST(ParticleKernelTest, evaluate_matches_update)
+{
+    // Gravity only, so the environment can be evaluated analytically
+    auto environment = std::make_shared<Environment>(glm::vec3(0.0f, -9.8f, 0.0f));
+    ASSERT_TRUE(environment->isAnalytic());
+    std::shared_ptr<Appearance> appearance = makeAppearance();
+    uint32_t const              streams    = ParticleStore::RADIUS | ParticleStore::ROTATION | ParticleStore::TAIL;
+
+    TestEmitter simulated(environment, appearance, streams);
+    populate(simulated.particles(), 1000);
+
+    TestEmitter evaluated(environment, appearance, streams);
+    populate(evaluated.particles(), 1000);
+    evaluated.setAnalytic(true);
+
+    for (int frame = 0; frame < 90; ++frame)
+    {
+        simulated.update(1.0f / 30.0f);
+        evaluated.update(1.0f / 30.0f);
+    }
+    EXPECT_TRUE(evaluated.stale());
+    evaluated.evaluate(0, evaluated.particles().size());
+    EXPECT_FALSE(evaluated.stale());
+
+    ParticleStore const & expected = simulated.particles();
+    ParticleStore const & actual   = evaluated.particles();
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_NEAR(expected.ages()[i], actual.ages()[i], 1.0e-4f);
+        if (expected.ages()[i] < 0.0f)
+            continue;
+        for (int c = 0; c < 3; ++c)
+        {
+            EXPECT_NEAR(expected.positions()[i][c], actual.positions()[i][c], 1.0e-3f) << "particle " << i;
+            EXPECT_NEAR(expected.velocities()[i][c], actual.velocities()[i][c], 1.0e-3f) << "particle " << i;
+            EXPECT_NEAR(expected.tails()[i][c], actual.tails()[i][c], 1.0e-3f) << "particle " << i;
+        }
+        for (int c = 0; c < 4; ++c)
+        {
+            EXPECT_NEAR(expected.colors()[i][c], actual.colors()[i][c], 1.0e-4f) << "particle " << i;
+        }
+        EXPECT_NEAR(expected.radii()[i], actual.radii()[i], 1.0e-4f);
+        EXPECT_NEAR(expected.rotations()[i], actual.rotations()[i], 1.0e-4f);
+    }
+}
+
+TEST(ParticleKernelTest, evaluate_matches_update_moving)
+{
+    auto environment = std::make_shared<Environment>(glm::vec3(0.0f, -9.8f, 0.0f));
+    std::shared_ptr<Appearance> appearance = makeAppearance();
+    uint32_t const              streams    = ParticleStore::RADIUS;
+
+    TestEmitter simulated(environment, appearance, streams);
+    populate(simulated.particles(), 1000);
+
+    TestEmitter evaluated(environment, appearance, streams);
+    populate(evaluated.particles(), 1000);
+    evaluated.setAnalytic(true);
+
+    auto expectSame = [&simulated, &evaluated] () {
+                          evaluated.evaluate(0, evaluated.particles().size());
+                          ParticleStore const & expected = simulated.particles();
+                          ParticleStore const & actual   = evaluated.particles();
+                          for (size_t i = 0; i < expected.size(); ++i)
+                          {
+                              EXPECT_NEAR(expected.ages()[i], actual.ages()[i], 1.0e-4f);
+                              if (expected.ages()[i] < 0.0f)
+                                  continue;
+                              for (int c = 0; c < 3; ++c)
+                              {
+                                  EXPECT_NEAR(expected.positions()[i][c], actual.positions()[i][c], 1.0e-3f)
+                                      << "particle " << i;
+                                  EXPECT_NEAR(expected.velocities()[i][c], actual.velocities()[i][c], 1.0e-3f)
+                                      << "particle " << i;
+                              }
+                          }
+                      };
+
+    // The particles in flight when the emitter moves stay where they were emitted, so they must be simulated
+
+    for (int frame = 0; frame < 30; ++frame)
+    {
+        simulated.update(1.0f / 30.0f);
+        evaluated.update(1.0f / 30.0f);
+    }
+    EXPECT_TRUE(evaluated.stale());
+
+    for (int frame = 0; frame < 60; ++frame)
+    {
+        glm::vec3 const position(0.1f * float(frame), 0.0f, -0.05f * float(frame));
+        glm::vec3 const velocity(3.0f, 0.0f, -1.5f);
+        simulated.update(position, velocity);
+        evaluated.update(position, velocity);
+        simulated.update(1.0f / 30.0f);
+        evaluated.update(1.0f / 30.0f);
+    }
+    EXPECT_FALSE(evaluated.stale());
+    expectSame();
+
+    // Once every live particle was emitted after the emitter stopped, they are evaluated again
+
+    for (int frame = 0; frame < 240; ++frame)
+    {
+        simulated.update(1.0f / 30.0f);
+        evaluated.update(1.0f / 30.0f);
+    }
+    EXPECT_TRUE(evaluated.stale());
+    expectSame();
+}
@@ -0,0 +1,132 @@
+#include "Confetti/ParticleStore.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace Confetti;
+
+TEST(ParticleStoreTest, Constructor_default)
+{
+    ParticleStore s;
+    EXPECT_EQ(s.size(), 0);
+    EXPECT_TRUE(s.empty());
+    EXPECT_EQ(s.streams(), ParticleStore::NONE);
+    EXPECT_FALSE(s.has(ParticleStore::RADIUS));
+}
+
+TEST(ParticleStoreTest, add)
+{
+    ParticleStore s(ParticleStore::RADIUS | ParticleStore::ROTATION);
+    size_t i = s.add(2.0f, 0.5f, { 1.0f, 2.0f, 3.0f }, { 4.0f, 5.0f, 6.0f }, { 0.1f, 0.2f, 0.3f, 0.4f }, 7.0f, 8.0f);
+    EXPECT_EQ(i, 0);
+    ASSERT_EQ(s.size(), 1);
+    EXPECT_TRUE(s.has(ParticleStore::RADIUS | ParticleStore::ROTATION));
+    EXPECT_FALSE(s.has(ParticleStore::TAIL));
+
+    EXPECT_EQ(s.lifetimes()[0], 2.0f);
+    EXPECT_EQ(s.ages()[0], 0.5f);
+    EXPECT_EQ(s.positions()[0], glm::vec3(1.0f, 2.0f, 3.0f));
+    EXPECT_EQ(s.initialPositions()[0], glm::vec3(1.0f, 2.0f, 3.0f));
+    EXPECT_EQ(s.velocities()[0], glm::vec3(4.0f, 5.0f, 6.0f));
+    EXPECT_EQ(s.initialVelocities()[0], glm::vec3(4.0f, 5.0f, 6.0f));
+    EXPECT_EQ(s.colors()[0], glm::vec4(0.1f, 0.2f, 0.3f, 0.4f));
+    EXPECT_EQ(s.radii()[0], 7.0f);
+    EXPECT_EQ(s.rotations()[0], 8.0f);
+    EXPECT_EQ(s.tails().size(), 0);
+}
+
+TEST(ParticleStoreTest, resize)
+{
+    ParticleStore s(ParticleStore::TAIL);
+    s.resize(10);
+    EXPECT_EQ(s.size(), 10);
+    EXPECT_EQ(s.positions().size(), 10);
+    EXPECT_EQ(s.tails().size(), 10);
+    EXPECT_EQ(s.radii().size(), 0);
+    EXPECT_EQ(s.ages()[9], 0.0f);
+
+    s.clear();
+    EXPECT_TRUE(s.empty());
+    EXPECT_EQ(s.tails().size(), 0);
+}
+
+TEST(ParticleStoreTest, reorder)
+{
+    ParticleStore s(ParticleStore::RADIUS);
+    for (int i = 0; i < 4; ++i)
+    {
+        float f = float(i);
+        s.add(1.0f, f, { f, f, f }, { -f, -f, -f }, { f, f, f, f }, f);
+    }
+
+    s.reorder({ 3, 1, 0, 2 });
+
+    std::vector<float> expected = { 3.0f, 1.0f, 0.0f, 2.0f };
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        float f = expected[i];
+        EXPECT_EQ(s.ages()[i], f);
+        EXPECT_EQ(s.positions()[i], glm::vec3(f, f, f));
+        EXPECT_EQ(s.initialVelocities()[i], glm::vec3(-f, -f, -f));
+        EXPECT_EQ(s.radii()[i], f);
+    }
+}
+
+TEST(ParticleStoreTest, attach)
+{
+    ParticleStore a(ParticleStore::RADIUS);
+    ParticleStore b(ParticleStore::RADIUS);
+    for (int i = 0; i < 3; ++i)
+    {
+        float f = float(i);
+        a.add(1.0f, f, { f, f, f }, { -f, -f, -f }, { f, f, f, f }, f);
+    }
+    for (int i = 0; i < 2; ++i)
+    {
+        float f = float(10 + i);
+        b.add(1.0f, f, { f, f, f }, { -f, -f, -f }, { f, f, f, f }, f);
+    }
+
+    ParticleStore group;
+    group.resize(16);
+    a.attach(group, 0, 8);
+    b.attach(group, 8, 8);
+    EXPECT_EQ(a.group(), &group);
+    EXPECT_EQ(b.offset(), 8);
+    EXPECT_EQ(b.capacity(), 8);
+    ASSERT_EQ(a.size(), 3);
+    ASSERT_EQ(b.size(), 2);
+    EXPECT_TRUE(group.has(ParticleStore::RADIUS));
+
+    // The particles are in the group's streams
+
+    EXPECT_EQ(a.ages()[2], 2.0f);
+    EXPECT_EQ(b.radii()[1], 11.0f);
+    EXPECT_EQ(group.ages()[9], 11.0f);
+    EXPECT_EQ(group.positions()[1], glm::vec3(1.0f));
+
+    b.swap(0, 1);
+    EXPECT_EQ(group.ages()[8], 11.0f);
+    EXPECT_EQ(group.initialVelocities()[9], glm::vec3(-10.0f));
+
+    // New particles are added in the range, and a store that outgrows its range is detached
+
+    for (int i = 3; i < 9; ++i)
+    {
+        float f = float(i);
+        a.add(1.0f, f, { f, f, f }, { -f, -f, -f }, { f, f, f, f }, f);
+        EXPECT_EQ(a.group(), i < 8 ? &group : nullptr);
+    }
+    ASSERT_EQ(a.size(), 9);
+    for (int i = 0; i < 9; ++i)
+    {
+        EXPECT_EQ(a.ages()[i], float(i));
+        EXPECT_EQ(a.radii()[i], float(i));
+    }
+
+    b.detach();
+    EXPECT_EQ(b.group(), nullptr);
+    ASSERT_EQ(b.size(), 2);
+    EXPECT_EQ(b.ages()[0], 11.0f);
+    EXPECT_EQ(b.colors()[1], glm::vec4(10.0f));
+}
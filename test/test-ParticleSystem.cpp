@@ -0,0 +1,145 @@
+#include "Confetti/Appearance.h"
+#include "Confetti/Emitter.h"
+#include "Confetti/Environment.h"
+#include "Confetti/ParticleStore.h"
+#include "Confetti/ParticleSystem.h"
+#include "TestEmitter.h"
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <vector>
+
+using namespace Confetti;
+
+TEST(ParticleSystemTest, groups)
+{
+    std::shared_ptr<Environment> environment = makeEnvironment();
+    std::shared_ptr<Appearance>  appearances[] = { makeAppearance(), makeAppearance() };
+    float const                  dt = 1.0f / 30.0f;
+
+    // Small emitters in different places, using two appearances so that they are put in two groups
+
+    ParticleSystem                            system(nullptr, vk::CommandPool(), vk::Queue(), 2);
+    std::vector<std::shared_ptr<TestEmitter>> emitters;
+    std::vector<std::shared_ptr<TestEmitter>> references;
+    for (int i = 0; i < 8; ++i)
+    {
+        glm::vec3 position(float(i) - 4.0f, float(i % 3), 0.0f);
+        for (auto * list : { &emitters, &references })
+        {
+            auto emitter = std::make_shared<TestEmitter>(environment, appearances[i % 2], ParticleStore::RADIUS);
+            populate(emitter->particles(), 5 + 7 * i, i + 1);
+            emitter->update(position, glm::vec3(0.0f));
+            list->push_back(emitter);
+        }
+        system.add(emitters.back());
+    }
+
+    for (int frame = 0; frame < 30; ++frame)
+    {
+        system.update(dt);
+        for (auto const & reference : references)
+        {
+            reference->update(dt);
+        }
+    }
+
+    // The emitters are updated in shared storage, with the same results as updating them separately
+
+    for (size_t i = 0; i < emitters.size(); ++i)
+    {
+        ParticleStore const & actual   = emitters[i]->particles();
+        ParticleStore const & expected = references[i]->particles();
+        EXPECT_NE(actual.group(), nullptr);
+        EXPECT_EQ(actual.group(), emitters[i % 2]->particles().group());
+        ASSERT_EQ(emitters[i]->aliveCount(), references[i]->aliveCount());
+        for (size_t j = 0; j < emitters[i]->aliveCount(); ++j)
+        {
+            EXPECT_EQ(actual.ages()[j], expected.ages()[j]) << "emitter " << i << ", particle " << j;
+            EXPECT_EQ(actual.positions()[j], expected.positions()[j]) << "emitter " << i << ", particle " << j;
+            EXPECT_EQ(actual.radii()[j], expected.radii()[j]) << "emitter " << i << ", particle " << j;
+        }
+    }
+    EXPECT_NE(emitters[0]->particles().group(), emitters[1]->particles().group());
+
+    // A removed emitter takes its particles with it
+
+    size_t const n = emitters[3]->particles().size();
+    system.remove(emitters[3].get());
+    EXPECT_EQ(emitters[3]->particles().group(), nullptr);
+    ASSERT_EQ(emitters[3]->particles().size(), n);
+    for (size_t j = 0; j < emitters[3]->aliveCount(); ++j)
+    {
+        EXPECT_EQ(emitters[3]->particles().positions()[j], references[3]->particles().positions()[j]);
+    }
+}
+
+TEST(ParticleSystemTest, membership)
+{
+    std::shared_ptr<Environment> environment = makeEnvironment();
+    std::shared_ptr<Appearance>  appearance  = makeAppearance();
+    float const                  dt          = 1.0f / 30.0f;
+
+    ParticleSystem                            system(nullptr, vk::CommandPool(), vk::Queue(), 2);
+    std::vector<std::shared_ptr<TestEmitter>> emitters;
+    for (int i = 0; i < 6; ++i)
+    {
+        auto emitter = std::make_shared<TestEmitter>(environment, appearance, ParticleStore::RADIUS);
+        populate(emitter->particles(), 20, i + 1);
+        emitters.push_back(emitter);
+        system.add(emitter);
+    }
+    system.update(dt);
+
+    ParticleStore const * group = emitters[0]->particles().group();
+    ASSERT_NE(group, nullptr);
+    std::vector<size_t> offsets;
+    for (auto const & emitter : emitters)
+    {
+        EXPECT_EQ(emitter->particles().group(), group);
+        offsets.push_back(emitter->particles().offset());
+    }
+
+    // A disabled emitter keeps its range, but it is not updated
+
+    emitters[2]->enable(false);
+    std::vector<float> ages(emitters[2]->particles().ages().begin(), emitters[2]->particles().ages().end());
+    system.update(dt);
+    for (size_t i = 0; i < emitters.size(); ++i)
+    {
+        EXPECT_EQ(emitters[i]->particles().group(), group);
+        EXPECT_EQ(emitters[i]->particles().offset(), offsets[i]);
+    }
+    for (size_t j = 0; j < ages.size(); ++j)
+    {
+        EXPECT_EQ(emitters[2]->particles().ages()[j], ages[j]);
+    }
+
+    emitters[2]->enable(true);
+    system.update(dt);
+    EXPECT_EQ(emitters[2]->particles().offset(), offsets[2]);
+    EXPECT_NE(emitters[2]->particles().ages()[0], ages[0]);
+
+    // Removing an emitter leaves the others where they are
+
+    system.remove(emitters[4].get());
+    system.update(dt);
+    EXPECT_EQ(emitters[4]->particles().group(), nullptr);
+    for (size_t i = 0; i < emitters.size(); ++i)
+    {
+        if (i == 4)
+            continue;
+        EXPECT_EQ(emitters[i]->particles().group(), group);
+        EXPECT_EQ(emitters[i]->particles().offset(), offsets[i]);
+    }
+
+    // An emitter that outgrows its range leaves the group, and it joins the end of the group again
+
+    populate(emitters[1]->particles(), 40, 7);
+    EXPECT_EQ(emitters[1]->particles().group(), nullptr);
+    system.update(dt);
+    EXPECT_EQ(emitters[1]->particles().group(), group);
+    EXPECT_GT(emitters[1]->particles().offset(), offsets[5]);
+    EXPECT_EQ(emitters[0]->particles().offset(), offsets[0]);
+    EXPECT_EQ(emitters[5]->particles().offset(), offsets[5]);
+}
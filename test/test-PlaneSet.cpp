@@ -0,0 +1,38 @@
+#include "Confetti/PlaneSet.h"
+#include "gtest/gtest.h"
+
+using namespace Confetti;
+
+TEST(PlaneSetTest, Constructor_default)
+{
+    PlaneSet planes;
+    EXPECT_TRUE(planes.empty());
+    EXPECT_EQ(planes.size(), 0u);
+    EXPECT_EQ(planes.paddedSize(), 0u);
+}
+
+TEST(PlaneSetTest, add)
+{
+    PlaneSet planes;
+    for (int i = 0; i < 5; ++i)
+    {
+        planes.add(glm::vec4(1.0f, 2.0f, 3.0f, float(i)), 0.5f * i);
+    }
+
+    EXPECT_EQ(planes.size(), 5u);
+    EXPECT_EQ(planes.paddedSize(), 2 * PlaneSet::PACKET_SIZE);
+    EXPECT_EQ(planes.plane(3), glm::vec4(1.0f, 2.0f, 3.0f, 3.0f));
+    EXPECT_EQ(planes.dampening(4), 2.0f);
+
+    // The padding consists of null planes
+    for (size_t i = planes.size(); i < planes.paddedSize(); ++i)
+    {
+        EXPECT_EQ(planes.a()[i], 0.0f);
+        EXPECT_EQ(planes.b()[i], 0.0f);
+        EXPECT_EQ(planes.c()[i], 0.0f);
+        EXPECT_EQ(planes.d()[i], 0.0f);
+    }
+
+    planes.clear();
+    EXPECT_TRUE(planes.empty());
+}
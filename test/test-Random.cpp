@@ -0,0 +1,174 @@
+#include "Confetti/Random.h"
+#include "Confetti/RngStream.h"
+#include "Confetti/Xoshiro128.h"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Confetti;
+
+namespace
+{
+size_t constexpr COUNT = 1 << 18;
+
+// Statistical sanity checks of a list of floats that should be uniform in [0, 1). These are not a substitute for a
+// real test suite (TestU01, PractRand), but they catch broken generators, bad seeding, and bad conversions.
+void checkUniform(std::vector<float> const & values)
+{
+    // Range, mean, and variance
+    double sum   = 0.0;
+    double sum2  = 0.0;
+    double lag1  = 0.0;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        float u = values[i];
+        ASSERT_GE(u, 0.0f);
+        ASSERT_LT(u, 1.0f);
+        sum  += u;
+        sum2 += u * u;
+        if (i > 0)
+            lag1 += (u - 0.5) * (values[i - 1] - 0.5);
+    }
+    double const n        = (double)values.size();
+    double const mean     = sum / n;
+    double const variance = sum2 / n - mean * mean;
+    EXPECT_NEAR(mean, 0.5, 0.005);
+    EXPECT_NEAR(variance, 1.0 / 12.0, 0.002);
+
+    // Successive values are uncorrelated
+    EXPECT_NEAR(lag1 / (n - 1) * 12.0, 0.0, 0.02);
+
+    // Chi-square test of 256 equal bins. With 255 degrees of freedom, the statistic is above 330 with a probability of
+    // less than 0.1%.
+    int constexpr    BINS = 256;
+    std::vector<int> bins(BINS, 0);
+    for (float u : values)
+    {
+        ++bins[(int)(u * BINS)];
+    }
+    double const expected = n / BINS;
+    double       chi2     = 0.0;
+    for (int count : bins)
+    {
+        chi2 += (count - expected) * (count - expected) / expected;
+    }
+    EXPECT_LT(chi2, 330.0);
+}
+
+template <typename Generator>
+std::vector<float> generate(Generator generator)
+{
+    std::vector<float> values(COUNT);
+    for (float & u : values)
+    {
+        u = generator.uniform();
+    }
+    return values;
+}
+
+template <typename Generator>
+std::vector<float> generateBatch(Generator generator)
+{
+    std::vector<float> values(COUNT);
+    generator.uniform(values);
+    return values;
+}
+} // anonymous namespace
+
+TEST(RandomTest, toUniform)
+{
+    EXPECT_EQ(toUniform(0), 0.0f);
+    EXPECT_LT(toUniform(UINT32_MAX), 1.0f);
+    EXPECT_EQ(toUniform(0x80000000u), 0.5f);
+}
+
+TEST(RandomTest, uniform)
+{
+    // Works with any 32-bit generator
+    std::mt19937 mt(1);
+    for (int i = 0; i < 1000; ++i)
+    {
+        float u = uniform(mt, -2.0f, 3.0f);
+        ASSERT_GE(u, -2.0f);
+        ASSERT_LT(u, 3.0f);
+    }
+}
+
+TEST(RandomTest, Xoshiro128)
+{
+    // The first numbers for the state { 1, 2, 3, 4 }
+    Xoshiro128 rng(Xoshiro128::State{ { 1, 2, 3, 4 } });
+    uint32_t const expected[] = { 0x5, 0x3007, 0x1803007, 0x1a05c0e, 0x260840a, 0x43f87e19 };
+    for (uint32_t x : expected)
+    {
+        EXPECT_EQ(rng(), x);
+    }
+
+    // Substreams are different
+    EXPECT_NE(Xoshiro128(1, 2, 3)(), Xoshiro128(1, 2, 4)());
+    EXPECT_EQ(Xoshiro128(1, 2, 3)(), Xoshiro128(1, 2, 3)());
+
+    // Jumping gives a different sequence
+    Xoshiro128 a(5);
+    Xoshiro128 b(5);
+    b.jump();
+    EXPECT_NE(a.state(), b.state());
+}
+
+TEST(RandomTest, Xoshiro128x8)
+{
+    // A batch split at any point gives the same numbers as a single batch
+    Xoshiro128x8       a(3, 4, 5);
+    Xoshiro128x8       b(3, 4, 5);
+    std::vector<float> whole(100);
+    a.uniform(whole);
+    std::vector<float> parts(100);
+    b.uniform(Span<float>(parts.data(), 3));
+    b.uniform(Span<float>(parts.data() + 3, 50));
+    b.uniform(Span<float>(parts.data() + 53, 47));
+    EXPECT_EQ(whole, parts);
+}
+
+TEST(RandomTest, statistics)
+{
+    {
+        SCOPED_TRACE("RngStream");
+        checkUniform(generate(RngStream(1, 2, 3)));
+    }
+    {
+        SCOPED_TRACE("RngStream batch");
+        checkUniform(generateBatch(RngStream(1, 2, 3)));
+    }
+    {
+        SCOPED_TRACE("Xoshiro128");
+        checkUniform(generate(Xoshiro128(1, 2, 3)));
+    }
+    {
+        SCOPED_TRACE("Xoshiro128x8");
+        checkUniform(generateBatch(Xoshiro128x8(1, 2, 3)));
+    }
+}
+
+TEST(RandomTest, seeds)
+{
+    // The first numbers of neighboring substreams are as uniform as the numbers of a single stream
+    std::vector<float> philox(COUNT);
+    std::vector<float> xoshiro(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        RngStream  a(7, 11, (uint32_t)i);
+        Xoshiro128 b(7, 11, (uint32_t)i);
+        philox[i]  = a.uniform();
+        xoshiro[i] = b.uniform();
+    }
+    {
+        SCOPED_TRACE("RngStream");
+        checkUniform(philox);
+    }
+    {
+        SCOPED_TRACE("Xoshiro128");
+        checkUniform(xoshiro);
+    }
+}
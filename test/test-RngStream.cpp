@@ -0,0 +1,90 @@
+#include "Confetti/RngStream.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace Confetti;
+
+TEST(RngStreamTest, philox)
+{
+    // Known answers from the Random123 distribution
+    EXPECT_EQ(RngStream::philox({ { 0, 0, 0, 0 } }, { { 0, 0 } }),
+              (RngStream::Block{ { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } }));
+    EXPECT_EQ(RngStream::philox({ { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff } }, { { 0xffffffff, 0xffffffff } }),
+              (RngStream::Block{ { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd } }));
+    EXPECT_EQ(RngStream::philox({ { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 } }, { { 0xa4093822, 0x299f31d0 } }),
+              (RngStream::Block{ { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } }));
+}
+
+TEST(RngStreamTest, reproducible)
+{
+    RngStream a(42, 7, 3);
+    RngStream b(42, 7, 3);
+    RngStream otherSeed(43, 7, 3);
+    RngStream otherStream(42, 8, 3);
+    RngStream otherSubstream(42, 7, 4);
+
+    int same = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        uint32_t x = a();
+        EXPECT_EQ(x, b());
+        same += (x == otherSeed()) + (x == otherStream()) + (x == otherSubstream());
+    }
+    EXPECT_EQ(same, 0);
+}
+
+TEST(RngStreamTest, discard)
+{
+    for (uint64_t n : { 0, 1, 3, 4, 5, 17 })
+    {
+        RngStream a(1, 2, 3);
+        RngStream b(1, 2, 3);
+        a();
+        b();
+        for (uint64_t i = 0; i < n; ++i)
+        {
+            a();
+        }
+        b.discard(n);
+        EXPECT_EQ(a(), b()) << "n = " << n;
+    }
+}
+
+TEST(RngStreamTest, uniform)
+{
+    RngStream rng(5);
+    double sum = 0.0;
+    for (int i = 0; i < 10000; ++i)
+    {
+        float u = rng.uniform();
+        ASSERT_GE(u, 0.0f);
+        ASSERT_LT(u, 1.0f);
+        sum += u;
+    }
+    EXPECT_NEAR(sum / 10000.0, 0.5, 0.01);
+}
+
+TEST(RngStreamTest, uniform_batch)
+{
+    // Batches that start and end in the middle of blocks give the same numbers as single calls
+    RngStream a(9, 2, 3);
+    RngStream b(9, 2, 3);
+    for (size_t n : { 3, 1, 17, 0, 64, 6 })
+    {
+        std::vector<float> values(n);
+        a.uniform(values);
+        for (size_t i = 0; i < n; ++i)
+        {
+            EXPECT_EQ(values[i], b.uniform()) << "n = " << n << ", i = " << i;
+        }
+    }
+    EXPECT_EQ(a(), b());
+}
+
+TEST(RngStreamTest, id)
+{
+    EXPECT_EQ(RngStream::id(""), 2166136261u);
+    EXPECT_EQ(RngStream::id("a"), 0xe40c292cu);
+    EXPECT_NE(RngStream::id("sparks"), RngStream::id("smoke"));
+}
@@ -0,0 +1,151 @@
+#include "Confetti/SamplePool.h"
+#include "gtest/gtest.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace Confetti;
+
+namespace
+{
+// Returns the number of points in each cell of a grid of n x n cells over a slice of a unit cube centered on the origin
+std::vector<int> histogram(std::vector<glm::vec3> const & points, int n, int a, int b)
+{
+    std::vector<int> counts(n * n, 0);
+    for (auto const & p : points)
+    {
+        int i = (int)std::floor((p[a] + 0.5f) * n);
+        int j = (int)std::floor((p[b] + 0.5f) * n);
+        ++counts[i * n + j];
+    }
+    return counts;
+}
+
+// Samples n points from a pool
+std::vector<glm::vec3> sample(SamplePool const & pool, size_t n, RngStream rng)
+{
+    std::vector<float> x(n), y(n), z(n);
+    pool.sample(Vec3Span<float>{ x, y, z }, rng);
+    std::vector<glm::vec3> points(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        points[i] = glm::vec3(x[i], y[i], z[i]);
+    }
+    return points;
+}
+} // anonymous namespace
+
+TEST(SamplePoolTest, Constructor)
+{
+    auto       box = std::make_shared<EmitterBox>(glm::vec3(1.0f));
+    SamplePool pool(box, 1000);
+    EXPECT_EQ(pool.size(), 1024);
+    EXPECT_EQ(pool.volume(), box);
+    EXPECT_EQ(pool[0], glm::vec3(-0.5f));
+
+    auto sphere = std::make_shared<EmitterSphere>(2.0f);
+    SamplePool spheres(sphere, 4096);
+    for (size_t i = 0; i < spheres.size(); ++i)
+    {
+        glm::vec3 p = spheres[i];
+        EXPECT_LE(std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z), 2.0f * 1.0001f);
+    }
+}
+
+TEST(SamplePoolTest, sobol)
+{
+    // Every pair of dimensions of the first 4^m points has exactly one point in each cell of a 2^m x 2^m grid
+
+    auto       box = std::make_shared<EmitterBox>(glm::vec3(1.0f));
+    SamplePool pool(box, 256);
+    std::vector<glm::vec3> points;
+    for (size_t i = 0; i < pool.size(); ++i)
+    {
+        points.push_back(pool[i]);
+    }
+    for (int a = 0; a < 3; ++a)
+    {
+        for (int b = a + 1; b < 3; ++b)
+        {
+            for (int count : histogram(points, 16, a, b))
+            {
+                EXPECT_EQ(count, 1);
+            }
+        }
+    }
+}
+
+TEST(SamplePoolTest, sample)
+{
+    auto       box = std::make_shared<EmitterBox>(glm::vec3(1.0f));
+    SamplePool pool(box, 4096);
+
+    // A sample of 4^m points is stratified no matter where it is taken from
+
+    for (uint32_t stream = 0; stream < 8; ++stream)
+    {
+        std::vector<glm::vec3> points = sample(pool, 64, RngStream(1, stream));
+        for (int count : histogram(points, 8, 0, 1))
+        {
+            EXPECT_EQ(count, 1);
+        }
+    }
+
+    // Different streams take different blocks, and the same stream takes the same block
+
+    std::vector<glm::vec3> a = sample(pool, 64, RngStream(2, 0));
+    std::vector<glm::vec3> b = sample(pool, 64, RngStream(2, 1));
+    std::vector<glm::vec3> c = sample(pool, 64, RngStream(2, 0));
+    EXPECT_NE(a, b);
+    EXPECT_EQ(a, c);
+
+    // Emitters that take the whole pool get it with different scrambles
+
+    std::vector<glm::vec3> e = sample(pool, pool.size(), RngStream(3, 0));
+    std::vector<glm::vec3> f = sample(pool, pool.size(), RngStream(3, 1));
+    size_t                 same = 0;
+    for (size_t i = 0; i < pool.size(); ++i)
+    {
+        same += e[i] == f[i];
+    }
+    EXPECT_LT(same, pool.size() / 100);
+
+    // Samples larger than the pool repeat it
+
+    std::vector<glm::vec3> d = sample(pool, 3 * pool.size(), RngStream(3));
+    for (size_t i = 0; i < pool.size(); ++i)
+    {
+        EXPECT_EQ(d[i], d[i + pool.size()]);
+        EXPECT_EQ(d[i], d[i + 2 * pool.size()]);
+    }
+}
+
+TEST(SamplePoolTest, sample_parts)
+{
+    auto       box = std::make_shared<EmitterBox>(glm::vec3(1.0f));
+    SamplePool pool(box, 4096);
+
+    // A list sampled in parts is the same as the list sampled all at once
+
+    for (uint32_t stream = 0; stream < 8; ++stream)
+    {
+        std::vector<glm::vec3> whole = sample(pool, 1000, RngStream(4, stream));
+
+        RngStream const rng(4, stream);
+        for (size_t offset = 0; offset < 1000; offset += 300)
+        {
+            size_t const       n = std::min<size_t>(300, 1000 - offset);
+            std::vector<float> x(n), y(n), z(n);
+            pool.sample(Vec3Span<float>{ x, y, z }, rng, offset, 1000);
+            for (size_t i = 0; i < n; ++i)
+            {
+                EXPECT_EQ(glm::vec3(x[i], y[i], z[i]), whole[offset + i]) << "stream " << stream << ", point "
+                                                                          << offset + i;
+            }
+        }
+    }
+}
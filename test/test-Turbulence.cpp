@@ -0,0 +1,81 @@
+#include "Confetti/Turbulence.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace Confetti;
+
+TEST(TurbulenceTest, Disabled)
+{
+    Turbulence turbulence;
+    EXPECT_FALSE(turbulence.enabled());
+    EXPECT_EQ(turbulence.velocity(glm::vec3(0.3f, 1.7f, -2.1f), 1.0f), glm::vec3(0.0f));
+    EXPECT_EQ(turbulence.maxSpeed(), glm::vec3(0.0f));
+}
+
+TEST(TurbulenceTest, DivergenceFree)
+{
+    Turbulence turbulence(0.7f, 2.0f);
+    float const h = 1.0e-3f;
+    for (int i = 0; i < 16; ++i)
+    {
+        glm::vec3 p(0.37f * i, 1.3f - 0.21f * i, 0.11f * i * i);
+        float     divergence = 0.0f;
+        for (int c = 0; c < 3; ++c)
+        {
+            glm::vec3 d(0.0f);
+            d[c] = h;
+            divergence += (turbulence.velocity(p + d, 0.0f)[c] - turbulence.velocity(p - d, 0.0f)[c]) / (2.0f * h);
+        }
+        EXPECT_NEAR(divergence, 0.0f, 0.05f);
+    }
+}
+
+TEST(TurbulenceTest, Bounded)
+{
+    Turbulence turbulence(1.3f, 1.0f);
+    glm::vec3  maxSpeed = turbulence.maxSpeed();
+    for (int i = 0; i < 1000; ++i)
+    {
+        glm::vec3 v = turbulence.velocity(glm::vec3(0.173f * i, -0.071f * i, 0.0313f * i), 0.0f);
+        for (int c = 0; c < 3; ++c)
+        {
+            EXPECT_LE(std::abs(v[c]), maxSpeed[c]);
+        }
+    }
+}
+
+TEST(TurbulenceTest, Scroll)
+{
+    glm::vec3  scroll(1.0f, -2.0f, 0.5f);
+    Turbulence turbulence(1.0f, 1.0f, scroll);
+    glm::vec3  p(0.4f, 0.9f, -1.3f);
+    glm::vec3  expected = turbulence.velocity(p, 0.0f);
+    glm::vec3  actual   = turbulence.velocity(p + scroll * 2.0f, 2.0f);
+    for (int c = 0; c < 3; ++c)
+    {
+        EXPECT_NEAR(actual[c], expected[c], 1.0e-4f);
+    }
+}
+
+TEST(TurbulenceTest, AddVelocities)
+{
+    Turbulence turbulence(0.5f, 3.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+    size_t const n = 37;
+    std::vector<float> px(n), py(n), pz(n);
+    std::vector<float> vx(n, 1.0f), vy(n, 2.0f), vz(n, 3.0f);
+    for (size_t i = 0; i < n; ++i)
+    {
+        px[i] = 0.31f * i;
+        py[i] = -0.17f * i;
+        pz[i] = 0.05f * i;
+    }
+    turbulence.addVelocities(Vec3Span<float const>{ px, py, pz }, 1.5f, Vec3Span<float>{ vx, vy, vz });
+    for (size_t i = 0; i < n; ++i)
+    {
+        glm::vec3 v = turbulence.velocity(glm::vec3(px[i], py[i], pz[i]), 1.5f);
+        EXPECT_NEAR(vx[i], 1.0f + v.x, 1.0e-4f);
+        EXPECT_NEAR(vy[i], 2.0f + v.y, 1.0e-4f);
+        EXPECT_NEAR(vz[i], 3.0f + v.z, 1.0e-4f);
+    }
+}
@@ -0,0 +1,72 @@
+#include "Confetti/WindField.h"
+#include "gtest/gtest.h"
+
+using namespace Confetti;
+
+namespace
+{
+// A 3 x 3 x 3 field over [0, 2] whose velocity is (x, 2 * y, -z)
+WindField linearField()
+{
+    std::vector<glm::vec3> velocities;
+    for (int z = 0; z < 3; ++z)
+    {
+        for (int y = 0; y < 3; ++y)
+        {
+            for (int x = 0; x < 3; ++x)
+            {
+                velocities.push_back(glm::vec3((float)x, 2.0f * y, -(float)z));
+            }
+        }
+    }
+    return WindField(glm::ivec3(3, 3, 3), glm::vec3(0.0f), 1.0f, velocities);
+}
+} // anonymous namespace
+
+TEST(WindFieldTest, Constructor)
+{
+    WindField field(glm::ivec3(4, 3, 2), glm::vec3(1.0f, 2.0f, 3.0f), 0.5f);
+    EXPECT_EQ(field.bounds().min, glm::vec3(1.0f, 2.0f, 3.0f));
+    EXPECT_EQ(field.bounds().max, glm::vec3(2.5f, 3.0f, 3.5f));
+    EXPECT_EQ(field.sample(glm::vec3(2.0f, 2.5f, 3.25f)), glm::vec3(0.0f));
+    EXPECT_EQ(field.maxSpeed(), glm::vec3(0.0f));
+
+    field.setVelocity(1, 2, 1, glm::vec3(-3.0f, 1.0f, 0.0f));
+    EXPECT_EQ(field.velocity(1, 2, 1), glm::vec3(-3.0f, 1.0f, 0.0f));
+    EXPECT_EQ(field.maxSpeed(), glm::vec3(3.0f, 1.0f, 0.0f));
+}
+
+TEST(WindFieldTest, sample)
+{
+    WindField field = linearField();
+    EXPECT_EQ(field.maxSpeed(), glm::vec3(2.0f, 4.0f, 2.0f));
+
+    // A linear field is reproduced exactly by trilinear interpolation
+    glm::vec3 v = field.sample(glm::vec3(0.25f, 1.5f, 1.75f));
+    EXPECT_FLOAT_EQ(v.x, 0.25f);
+    EXPECT_FLOAT_EQ(v.y, 3.0f);
+    EXPECT_FLOAT_EQ(v.z, -1.75f);
+
+    // Outside the grid, the velocity is the velocity at the nearest edge
+    v = field.sample(glm::vec3(5.0f, -1.0f, 1.0f));
+    EXPECT_FLOAT_EQ(v.x, 2.0f);
+    EXPECT_FLOAT_EQ(v.y, 0.0f);
+    EXPECT_FLOAT_EQ(v.z, -1.0f);
+}
+
+TEST(WindFieldTest, sample_batch)
+{
+    WindField field = linearField();
+
+    std::vector<float> px{ 0.1f, 0.2f, 1.9f, 3.0f }, py{ 0.1f, 0.3f, 1.2f, 0.5f }, pz{ 0.5f, 0.5f, 0.1f, 2.0f };
+    std::vector<float> vx(4), vy(4), vz(4);
+    field.sample(Vec3Span<float const>{ px, py, pz }, Vec3Span<float>{ vx, vy, vz });
+
+    for (size_t i = 0; i < px.size(); ++i)
+    {
+        glm::vec3 expected = field.sample(glm::vec3(px[i], py[i], pz[i]));
+        EXPECT_EQ(vx[i], expected.x);
+        EXPECT_EQ(vy[i], expected.y);
+        EXPECT_EQ(vz[i], expected.z);
+    }
+}